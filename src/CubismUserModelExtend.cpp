@@ -5,6 +5,8 @@
  * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
  */
 
+#include <string>
+#include <vector>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
@@ -19,6 +21,7 @@
 #include "LAppPal.hpp"
 #include "LAppDefine.hpp"
 #include "MouseActionManager.hpp"
+#include "LAppWindowState.hpp"
 
 #include "CubismUserModelExtend.hpp"
 
@@ -418,6 +421,8 @@ void CubismUserModelExtend::Draw(Csm::CubismMatrix44& matrix)
 
 void CubismUserModelExtend::SetupTextures()
 {
+    std::vector<csmInt32> textureNumbers;
+    std::vector<std::string> texturePaths;
     for (csmInt32 modelTextureNumber = 0; modelTextureNumber < _modelJson->GetTextureCount(); modelTextureNumber++)
     {
         // テクスチャ名が空文字だった場合はロード・バインド処理をスキップ
@@ -426,15 +431,26 @@ void CubismUserModelExtend::SetupTextures()
             continue;
         }
 
-        // OpenGLのテクスチャユニットにテクスチャをロードする
         csmString texturePath = _modelJson->GetTextureFileName(modelTextureNumber);
         texturePath = csmString(_currentModelDirectory.c_str()) + texturePath;
 
-        LAppTextureManager::TextureInfo* texture = _textureManager->CreateTextureFromPngFile(texturePath.GetRawString());
-        const csmInt32 glTextueNumber = texture->id;
+        textureNumbers.push_back(modelTextureNumber);
+        texturePaths.push_back(texturePath.GetRawString());
+    }
+
+    // OpenGLのテクスチャユニットにテクスチャをロードする（デコードは並列に行う）
+    std::vector<LAppTextureManager::TextureInfo*> textures;
+    _textureManager->CreateTexturesFromPngFiles(texturePaths, textures);
+
+    for (csmUint32 i = 0; i < textures.size(); i++)
+    {
+        if (textures[i] == NULL)
+        {
+            continue;
+        }
 
         // OpenGL
-        GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->BindTexture(modelTextureNumber, glTextueNumber);
+        GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->BindTexture(textureNumbers[i], textures[i]->id);
     }
 
     // 乗算済みアルファ値の有効化・無効化を設定
@@ -443,23 +459,19 @@ void CubismUserModelExtend::SetupTextures()
 
 void CubismUserModelExtend::ModelOnUpdate(GLFWwindow* window)
 {
-    int width, height;
-    // ウィンドウサイズを取得
-    glfwGetWindowSize(window, &width, &height);
+    // ウィンドウサイズに応じた投影行列はLAppWindowStateがサイズ変更時に計算する
+    const LAppWindowState* windowState = LAppWindowState::GetInstance();
 
     Csm::CubismMatrix44 projection;
-    // 念のため単位行列に初期化
-    projection.LoadIdentity();
-
-    if (_model->GetCanvasWidth() > 1.0f && width < height)
+    if (_model->GetCanvasWidth() > 1.0f && windowState->IsPortrait())
     {
         // 横に長いモデルを縦長ウィンドウに表示する際モデルの横サイズでscaleを算出する
         GetModelMatrix()->SetWidth(2.0f);
-        projection.Scale(1.0f, static_cast<float>(width) / static_cast<float>(height));
+        projection = windowState->GetFitWidthProjection();
     }
     else
     {
-        projection.Scale(static_cast<float>(height) / static_cast<float>(width), 1.0f);
+        projection = windowState->GetFitHeightProjection();
     }
 
     // 必要があればここで乗算
@@ -0,0 +1,279 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppAudioKernel.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "LAppPal.hpp"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define LAPP_AUDIO_KERNEL_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#define LAPP_AUDIO_KERNEL_TARGET(isa)
+#else
+#define LAPP_AUDIO_KERNEL_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+using namespace Csm;
+
+namespace
+{
+    // float通道内累加的样本数。超过后汇总到double，长区间的误差不随样本数增大
+    const csmSizeInt FloatBlockSize = 4096;
+
+    double SumSquaresFloatScalar(const csmFloat32* samples, csmSizeInt sampleCount)
+    {
+        double sum = 0.0;
+        for (csmSizeInt i = 0; i < sampleCount; i++)
+        {
+            sum += static_cast<double>(samples[i]) * samples[i];
+        }
+        return sum;
+    }
+
+    csmUint64 SumSquaresPcm16Scalar(const csmByte* data, csmSizeInt sampleCount)
+    {
+        csmUint64 sum = 0;
+        for (csmSizeInt i = 0; i < sampleCount; i++)
+        {
+            const csmInt32 pcm = static_cast<csmInt16>((data[i * 2 + 1] << 8) | data[i * 2]);
+            sum += static_cast<csmUint32>(pcm * pcm);
+        }
+        return sum;
+    }
+
+#ifdef LAPP_AUDIO_KERNEL_X86
+    LAPP_AUDIO_KERNEL_TARGET("sse2")
+    double SumSquaresFloatSse2(const csmFloat32* samples, csmSizeInt sampleCount)
+    {
+        double sum = 0.0;
+        csmSizeInt i = 0;
+        while (i + 4 <= sampleCount)
+        {
+            const csmSizeInt blockEnd = i + FloatBlockSize < sampleCount ? i + FloatBlockSize : sampleCount;
+            __m128 acc = _mm_setzero_ps();
+            for (; i + 4 <= blockEnd; i += 4)
+            {
+                const __m128 x = _mm_loadu_ps(samples + i);
+                acc = _mm_add_ps(acc, _mm_mul_ps(x, x));
+            }
+
+            float lanes[4];
+            _mm_storeu_ps(lanes, acc);
+            sum += static_cast<double>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+        }
+
+        return sum + SumSquaresFloatScalar(samples + i, sampleCount - i);
+    }
+
+    // pmaddwd得到相邻两个样本的平方和。(-32768)^2 * 2 = 2^31超出int32，按无符号解释后零扩展到64位累加
+    LAPP_AUDIO_KERNEL_TARGET("sse2")
+    csmUint64 SumSquaresPcm16Sse2(const csmByte* data, csmSizeInt sampleCount)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i acc = _mm_setzero_si128();
+
+        csmSizeInt i = 0;
+        for (; i + 8 <= sampleCount; i += 8)
+        {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 2));
+            const __m128i pairs = _mm_madd_epi16(x, x);
+            acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(pairs, zero));
+            acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(pairs, zero));
+        }
+
+        csmUint64 lanes[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+        return lanes[0] + lanes[1] + SumSquaresPcm16Scalar(data + i * 2, sampleCount - i);
+    }
+
+    LAPP_AUDIO_KERNEL_TARGET("avx2")
+    double SumSquaresFloatAvx2(const csmFloat32* samples, csmSizeInt sampleCount)
+    {
+        double sum = 0.0;
+        csmSizeInt i = 0;
+        while (i + 8 <= sampleCount)
+        {
+            const csmSizeInt blockEnd = i + FloatBlockSize < sampleCount ? i + FloatBlockSize : sampleCount;
+            __m256 acc = _mm256_setzero_ps();
+            for (; i + 8 <= blockEnd; i += 8)
+            {
+                const __m256 x = _mm256_loadu_ps(samples + i);
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(x, x));
+            }
+
+            float lanes[8];
+            _mm256_storeu_ps(lanes, acc);
+            sum += static_cast<double>(lanes[0]) + lanes[1] + lanes[2] + lanes[3]
+                + lanes[4] + lanes[5] + lanes[6] + lanes[7];
+        }
+
+        return sum + SumSquaresFloatScalar(samples + i, sampleCount - i);
+    }
+
+    // 与SSE2版相同的处理，一次16个样本（unpack在128位通道内进行，只影响累加的通道，不影响合计）
+    LAPP_AUDIO_KERNEL_TARGET("avx2")
+    csmUint64 SumSquaresPcm16Avx2(const csmByte* data, csmSizeInt sampleCount)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i acc = _mm256_setzero_si256();
+
+        csmSizeInt i = 0;
+        for (; i + 16 <= sampleCount; i += 16)
+        {
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i * 2));
+            const __m256i pairs = _mm256_madd_epi16(x, x);
+            acc = _mm256_add_epi64(acc, _mm256_unpacklo_epi32(pairs, zero));
+            acc = _mm256_add_epi64(acc, _mm256_unpackhi_epi32(pairs, zero));
+        }
+
+        csmUint64 lanes[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+        return lanes[0] + lanes[1] + lanes[2] + lanes[3] + SumSquaresPcm16Scalar(data + i * 2, sampleCount - i);
+    }
+#endif
+
+    csmUint32 s_randomState = 0x9E3779B9;
+
+    csmUint32 NextRandom()
+    {
+        s_randomState ^= s_randomState << 13;
+        s_randomState ^= s_randomState >> 17;
+        s_randomState ^= s_randomState << 5;
+        return s_randomState;
+    }
+}
+
+double LAppAudioKernel::SumSquaresFloat(const csmFloat32* samples, csmSizeInt sampleCount)
+{
+    return SumSquaresFloat(LAppImageKernel::GetBestKernel(), samples, sampleCount);
+}
+
+double LAppAudioKernel::SumSquaresFloat(Kernel kernel, const csmFloat32* samples, csmSizeInt sampleCount)
+{
+    if (!LAppImageKernel::IsKernelSupported(kernel))
+    {
+        kernel = LAppImageKernel::Kernel_Scalar;
+    }
+
+    switch (kernel)
+    {
+#ifdef LAPP_AUDIO_KERNEL_X86
+    case LAppImageKernel::Kernel_Sse2:
+        return SumSquaresFloatSse2(samples, sampleCount);
+    case LAppImageKernel::Kernel_Avx2:
+        return SumSquaresFloatAvx2(samples, sampleCount);
+#endif
+    default:
+        return SumSquaresFloatScalar(samples, sampleCount);
+    }
+}
+
+csmUint64 LAppAudioKernel::SumSquaresPcm16(const csmByte* data, csmSizeInt sampleCount)
+{
+    return SumSquaresPcm16(LAppImageKernel::GetBestKernel(), data, sampleCount);
+}
+
+csmUint64 LAppAudioKernel::SumSquaresPcm16(Kernel kernel, const csmByte* data, csmSizeInt sampleCount)
+{
+    if (!LAppImageKernel::IsKernelSupported(kernel))
+    {
+        kernel = LAppImageKernel::Kernel_Scalar;
+    }
+
+    switch (kernel)
+    {
+#ifdef LAPP_AUDIO_KERNEL_X86
+    case LAppImageKernel::Kernel_Sse2:
+        return SumSquaresPcm16Sse2(data, sampleCount);
+    case LAppImageKernel::Kernel_Avx2:
+        return SumSquaresPcm16Avx2(data, sampleCount);
+#endif
+    default:
+        return SumSquaresPcm16Scalar(data, sampleCount);
+    }
+}
+
+double LAppAudioKernel::Pcm16SquareScale()
+{
+    // 16位样本左移16位后除以INT32_MAX
+    const double scale = 65536.0 / INT32_MAX;
+    return scale * scale;
+}
+
+void LAppAudioKernel::RunBenchmark(csmSizeInt sampleCount, csmUint32 iterations)
+{
+    // 加上奇数个样本，同时覆盖尾部的标量处理
+    const csmSizeInt testSampleCount = sampleCount + 7;
+
+    std::vector<csmByte> pcm16(testSampleCount * 2);
+    std::vector<csmFloat32> samples(testSampleCount);
+    for (csmSizeInt i = 0; i < testSampleCount; i++)
+    {
+        const csmUint32 random = NextRandom();
+        pcm16[i * 2] = static_cast<csmByte>(random);
+        pcm16[i * 2 + 1] = static_cast<csmByte>(random >> 8);
+        samples[i] = static_cast<csmFloat32>(static_cast<csmInt16>(random >> 16)) / 32768.0f;
+    }
+    // 最小值的平方和也要覆盖
+    pcm16[0] = 0x00;
+    pcm16[1] = 0x80;
+    pcm16[2] = 0x00;
+    pcm16[3] = 0x80;
+
+    const csmUint64 expectedPcm16 = SumSquaresPcm16Scalar(&pcm16[0], testSampleCount);
+    const double expectedFloat = SumSquaresFloatScalar(&samples[0], testSampleCount);
+
+    for (csmInt32 kernel = 0; kernel < LAppImageKernel::Kernel_Count; kernel++)
+    {
+        const Kernel current = static_cast<Kernel>(kernel);
+        if (!LAppImageKernel::IsKernelSupported(current))
+        {
+            LAppPal::PrintLog("[APP]sum of squares %-6s : not supported", LAppImageKernel::GetKernelName(current));
+            continue;
+        }
+
+        double bestPcm16 = 0.0;
+        double bestFloat = 0.0;
+        csmBool exact = true;
+        double maxRelativeError = 0.0;
+        for (csmUint32 i = 0; i < iterations; i++)
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            const csmUint64 resultPcm16 = SumSquaresPcm16(current, &pcm16[0], testSampleCount);
+            const double pcm16Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            start = std::chrono::steady_clock::now();
+            const double resultFloat = SumSquaresFloat(current, &samples[0], testSampleCount);
+            const double floatMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            if (i == 0 || pcm16Milliseconds < bestPcm16)
+            {
+                bestPcm16 = pcm16Milliseconds;
+            }
+            if (i == 0 || floatMilliseconds < bestFloat)
+            {
+                bestFloat = floatMilliseconds;
+            }
+            exact = exact && resultPcm16 == expectedPcm16;
+            const double relativeError = fabs(resultFloat - expectedFloat) / expectedFloat;
+            if (relativeError > maxRelativeError)
+            {
+                maxRelativeError = relativeError;
+            }
+        }
+
+        LAppPal::PrintLog("[APP]sum of squares %-6s : %u samples pcm16 %.3f ms%s, float %.3f ms (error %.1e) (best of %u)",
+            LAppImageKernel::GetKernelName(current), testSampleCount, bestPcm16, exact ? "" : " MISMATCH",
+            bestFloat, maxRelativeError, iterations);
+    }
+}
@@ -0,0 +1,88 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+#include "LAppImageKernel.hpp"
+
+ /**
+ * @brief 音频处理内核
+ *
+ * 口型同步的RMS计算所用的平方和。
+ *
+ 这段代码定义了一个名为LAppAudioKernel的类（静态类），集中了对PCM样本的批量处理。
+
+平方和有标量、SSE2和AVX2三种实现，内核的种类和CPU检测沿用LAppImageKernel。
+帧卡顿后deltaTimeSeconds变大时，一次Update要处理数十万个样本，此时SIMD实现的差距最明显。
+16位PCM的平方和用整数累加，所有实现的结果逐位一致；float样本的平方和按块在float通道内累加后再汇总到double，
+各实现之间只有舍入误差。
+
+SumSquaresFloat：计算float样本的平方和。
+SumSquaresPcm16：计算16位小端PCM的平方和（整数，样本值的平方）。
+Pcm16SquareScale：将SumSquaresPcm16的结果换算为-1～1范围样本的平方和的系数。
+RunBenchmark：对各内核的平方和计时并校验结果，输出到日志（AudioKernelBenchmarkEnable为true时启动时执行）。
+ */
+class LAppAudioKernel
+{
+public:
+    typedef LAppImageKernel::Kernel Kernel;
+
+    /**
+    * @brief 用最快的内核计算float样本的平方和
+    *
+    * @param[in]   samples     样本
+    * @param[in]   sampleCount 样本数
+    * @return                  平方和
+    */
+    static double SumSquaresFloat(const Csm::csmFloat32* samples, Csm::csmSizeInt sampleCount);
+
+    /**
+    * @brief 用指定的内核计算float样本的平方和
+    *
+    * @param[in]   kernel      内核的种类。当前CPU不支持时使用标量实现
+    * @param[in]   samples     样本
+    * @param[in]   sampleCount 样本数
+    * @return                  平方和
+    */
+    static double SumSquaresFloat(Kernel kernel, const Csm::csmFloat32* samples, Csm::csmSizeInt sampleCount);
+
+    /**
+    * @brief 用最快的内核计算16位小端PCM的平方和
+    *
+    * @param[in]   data        PCM数据（不需要对齐）
+    * @param[in]   sampleCount 样本数（所有通道合计）
+    * @return                  样本值的平方和
+    */
+    static Csm::csmUint64 SumSquaresPcm16(const Csm::csmByte* data, Csm::csmSizeInt sampleCount);
+
+    /**
+    * @brief 用指定的内核计算16位小端PCM的平方和
+    *
+    * @param[in]   kernel      内核的种类。当前CPU不支持时使用标量实现
+    * @param[in]   data        PCM数据（不需要对齐）
+    * @param[in]   sampleCount 样本数（所有通道合计）
+    * @return                  样本值的平方和
+    */
+    static Csm::csmUint64 SumSquaresPcm16(Kernel kernel, const Csm::csmByte* data, Csm::csmSizeInt sampleCount);
+
+    /**
+    * @brief 将SumSquaresPcm16的结果换算为-1～1范围样本的平方和的系数
+    *         与LAppWavFileHandler::GetPcmSample的标准化（扩展为32位后除以INT32_MAX）一致。
+    */
+    static double Pcm16SquareScale();
+
+    /**
+    * @brief 对各内核的平方和计时并校验结果
+    *
+    * 对随机生成的样本分别执行各内核，输出最短耗时和与标量实现的结果是否一致。
+    *
+    * @param[in]   sampleCount 样本数
+    * @param[in]   iterations  每个内核的执行次数
+    */
+    static void RunBenchmark(Csm::csmSizeInt sampleCount, Csm::csmUint32 iterations);
+};
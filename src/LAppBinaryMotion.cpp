@@ -0,0 +1,703 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppBinaryMotion.hpp"
+#include <cfloat>
+#include <cstring>
+#include <Id/CubismIdManager.hpp>
+#include <Math/CubismMath.hpp>
+#include <Model/CubismModel.hpp>
+#include <Motion/CubismMotionQueueEntry.hpp>
+#include <Utils/CubismJson.hpp>
+#include "LAppPal.hpp"
+
+using namespace Csm;
+
+namespace
+{
+    const csmChar Magic[4] = { 'L', '2', 'D', 'M' };
+    const csmUint32 HeaderSize = 64;       ///< 魔数、版本、标志、时长、FPS、淡入时间、淡出时间、各数量、字符串表大小、源文件的大小和内容哈希
+    const csmUint32 CurveSize = 28;        ///< 目标类型、ID偏移、ID长度、淡入时间、淡出时间、起始片段、片段数
+    const csmUint32 SegmentSize = 8;       ///< 起始控制点、片段类型
+    const csmUint32 PointSize = 8;         ///< 时间、值
+    const csmUint32 EventSize = 12;        ///< 触发时间、值偏移、值长度
+
+    const csmUint32 Flag_Loop = 1 << 0;
+    const csmUint32 Flag_AreBeziersRestricted = 1 << 1;
+
+    // 与CubismMotion相同的效果ID
+    const csmChar* EffectNameEyeBlink = "EyeBlink";
+    const csmChar* EffectNameLipSync = "LipSync";
+    const csmChar* IdNameOpacity = "Opacity";
+
+    // 片段中眨眼、唇形同步参数的最大数（与CubismMotion相同）
+    const csmInt32 MaxTargetSize = 64;
+
+    struct MotionPoint
+    {
+        csmFloat32 time;
+        csmFloat32 value;
+    };
+
+    csmUint32 Read32(const csmByte* p)
+    {
+        csmUint32 value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    csmUint64 Read64(const csmByte* p)
+    {
+        csmUint64 value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    csmFloat32 ReadFloat(const csmByte* p)
+    {
+        csmFloat32 value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    void Write32(std::vector<csmByte>& out, csmUint32 value)
+    {
+        const csmByte* p = reinterpret_cast<const csmByte*>(&value);
+        out.insert(out.end(), p, p + sizeof(value));
+    }
+
+    void Write64(std::vector<csmByte>& out, csmUint64 value)
+    {
+        const csmByte* p = reinterpret_cast<const csmByte*>(&value);
+        out.insert(out.end(), p, p + sizeof(value));
+    }
+
+    void WriteFloat(std::vector<csmByte>& out, csmFloat32 value)
+    {
+        const csmByte* p = reinterpret_cast<const csmByte*>(&value);
+        out.insert(out.end(), p, p + sizeof(value));
+    }
+
+    MotionPoint LerpPoints(const MotionPoint& a, const MotionPoint& b, csmFloat32 t)
+    {
+        MotionPoint result;
+        result.time = a.time + ((b.time - a.time) * t);
+        result.value = a.value + ((b.value - a.value) * t);
+        return result;
+    }
+
+    csmFloat32 BezierValue(const MotionPoint* points, csmFloat32 t)
+    {
+        const MotionPoint p01 = LerpPoints(points[0], points[1], t);
+        const MotionPoint p12 = LerpPoints(points[1], points[2], t);
+        const MotionPoint p23 = LerpPoints(points[2], points[3], t);
+
+        const MotionPoint p012 = LerpPoints(p01, p12, t);
+        const MotionPoint p123 = LerpPoints(p12, p23, t);
+
+        return LerpPoints(p012, p123, t).value;
+    }
+
+    csmFloat32 LinearEvaluate(const MotionPoint* points, csmFloat32 time)
+    {
+        csmFloat32 t = (time - points[0].time) / (points[1].time - points[0].time);
+        if (t < 0.0f)
+        {
+            t = 0.0f;
+        }
+        return points[0].value + ((points[1].value - points[0].value) * t);
+    }
+
+    csmFloat32 BezierEvaluate(const MotionPoint* points, csmFloat32 time)
+    {
+        csmFloat32 t = (time - points[0].time) / (points[3].time - points[0].time);
+        if (t < 0.0f)
+        {
+            t = 0.0f;
+        }
+        return BezierValue(points, t);
+    }
+
+    csmFloat32 BezierEvaluateCardanoInterpretation(const MotionPoint* points, csmFloat32 time)
+    {
+        // 求解时间轴上的三次方程，得到贝塞尔曲线的参数t
+        const csmFloat32 x1 = points[0].time;
+        const csmFloat32 x2 = points[3].time;
+        const csmFloat32 cx1 = points[1].time;
+        const csmFloat32 cx2 = points[2].time;
+
+        const csmFloat32 a = x2 - 3.0f * cx2 + 3.0f * cx1 - x1;
+        const csmFloat32 b = 3.0f * cx2 - 6.0f * cx1 + 3.0f * x1;
+        const csmFloat32 c = 3.0f * cx1 - 3.0f * x1;
+        const csmFloat32 d = x1 - time;
+
+        return BezierValue(points, CubismMath::CardanoAlgorithmForBezier(a, b, c, d));
+    }
+
+    csmFloat32 GetFadeValue(csmFloat32 seconds, csmFloat32 elapsed)
+    {
+        return (seconds <= 0.0f) ? 1.0f : CubismMath::GetEasingSine(elapsed / seconds);
+    }
+}
+
+LAppBinaryMotion* LAppBinaryMotion::Create(const csmByte* buffer, csmSizeInt size, FinishedMotionCallback onFinishedMotionHandler)
+{
+    if (buffer == NULL || size < HeaderSize || memcmp(buffer, Magic, sizeof(Magic)) != 0 || Read32(buffer + 4) != Version)
+    {
+        return NULL;
+    }
+
+    const csmUint32 flags = Read32(buffer + 8);
+    const csmUint32 curveCount = Read32(buffer + 28);
+    const csmUint32 segmentCount = Read32(buffer + 32);
+    const csmUint32 pointCount = Read32(buffer + 36);
+    const csmUint32 eventCount = Read32(buffer + 40);
+    const csmUint32 stringsSize = Read32(buffer + 44);
+
+    const csmUint64 curvesOffset = HeaderSize;
+    const csmUint64 segmentsOffset = curvesOffset + static_cast<csmUint64>(curveCount) * CurveSize;
+    const csmUint64 pointsOffset = segmentsOffset + static_cast<csmUint64>(segmentCount) * SegmentSize;
+    const csmUint64 eventsOffset = pointsOffset + static_cast<csmUint64>(pointCount) * PointSize;
+    const csmUint64 stringsOffset = eventsOffset + static_cast<csmUint64>(eventCount) * EventSize;
+    if (stringsOffset + stringsSize != size)
+    {
+        CubismLogError("Invalid binary motion size.");
+        return NULL;
+    }
+    const csmChar* strings = reinterpret_cast<const csmChar*>(buffer + stringsOffset);
+
+    LAppBinaryMotion* motion = CSM_NEW LAppBinaryMotion();
+    motion->_duration = ReadFloat(buffer + 12);
+    motion->_isLoop = (flags & Flag_Loop) != 0;
+    motion->_areBeziersRestricted = (flags & Flag_AreBeziersRestricted) != 0;
+    motion->_fadeInSeconds = ReadFloat(buffer + 20);
+    motion->_fadeOutSeconds = ReadFloat(buffer + 24);
+    motion->SetFinishedMotionHandler(onFinishedMotionHandler);
+
+    // 控制点和片段与内存中的布局相同，整块复制
+    motion->_segments.resize(segmentCount);
+    motion->_points.resize(pointCount);
+    if (segmentCount > 0)
+    {
+        memcpy(&motion->_segments[0], buffer + segmentsOffset, static_cast<size_t>(segmentCount) * SegmentSize);
+    }
+    if (pointCount > 0)
+    {
+        memcpy(&motion->_points[0], buffer + pointsOffset, static_cast<size_t>(pointCount) * PointSize);
+    }
+
+    csmBool valid = true;
+    for (csmUint32 i = 0; i < segmentCount && valid; i++)
+    {
+        const Segment& segment = motion->_segments[i];
+        // 与曲线和事件相同，以64位计算，防止basePointIndex接近上限时回绕
+        const csmUint64 lastPoint = static_cast<csmUint64>(segment.basePointIndex) + (segment.type == SegmentType_Bezier ? 3 : 1);
+        valid = segment.type <= SegmentType_InverseStepped && lastPoint < pointCount;
+    }
+
+    CubismIdManager* idManager = CubismFramework::GetIdManager();
+    motion->_curves.resize(curveCount);
+    for (csmUint32 i = 0; i < curveCount && valid; i++)
+    {
+        const csmByte* p = buffer + curvesOffset + static_cast<size_t>(i) * CurveSize;
+        Curve& curve = motion->_curves[i];
+        const csmUint32 idOffset = Read32(p + 4);
+        const csmUint32 idLength = Read32(p + 8);
+        curve.target = Read32(p);
+        curve.fadeInTime = ReadFloat(p + 12);
+        curve.fadeOutTime = ReadFloat(p + 16);
+        curve.baseSegmentIndex = Read32(p + 20);
+        curve.segmentCount = Read32(p + 24);
+
+        valid = curve.target <= CurveTarget_PartOpacity
+            && static_cast<csmUint64>(idOffset) + idLength <= stringsSize
+            && static_cast<csmUint64>(curve.baseSegmentIndex) + curve.segmentCount <= segmentCount
+            && curve.segmentCount > 0;
+        if (valid)
+        {
+            curve.id = idManager->GetId(csmString(strings + idOffset, idLength));
+        }
+    }
+
+    motion->_eventTimes.resize(eventCount);
+    motion->_eventValues.resize(eventCount);
+    for (csmUint32 i = 0; i < eventCount && valid; i++)
+    {
+        const csmByte* p = buffer + eventsOffset + static_cast<size_t>(i) * EventSize;
+        const csmUint32 valueOffset = Read32(p + 4);
+        const csmUint32 valueLength = Read32(p + 8);
+        valid = static_cast<csmUint64>(valueOffset) + valueLength <= stringsSize;
+        if (valid)
+        {
+            motion->_eventTimes[i] = ReadFloat(p);
+            motion->_eventValues[i] = csmString(strings + valueOffset, valueLength);
+        }
+    }
+
+    if (!valid)
+    {
+        CubismLogError("Invalid binary motion data.");
+        ACubismMotion::Delete(motion);
+        return NULL;
+    }
+
+    motion->_modelCurveIdEyeBlink = idManager->GetId(EffectNameEyeBlink);
+    motion->_modelCurveIdLipSync = idManager->GetId(EffectNameLipSync);
+    motion->_modelCurveIdOpacity = idManager->GetId(IdNameOpacity);
+
+    return motion;
+}
+
+csmBool LAppBinaryMotion::Compile(const csmByte* json, csmSizeInt size, std::vector<csmByte>& outBinary)
+{
+    Utils::CubismJson* document = Utils::CubismJson::Create(json, size);
+    if (document == NULL)
+    {
+        return false;
+    }
+
+    Utils::Value& root = document->GetRoot();
+    Utils::Value& meta = root["Meta"];
+    Utils::Value& curves = root["Curves"];
+    Utils::Value& userData = root["UserData"];
+
+    std::vector<csmByte> curveBlock;
+    std::vector<csmByte> segmentBlock;
+    std::vector<csmByte> pointBlock;
+    std::vector<csmByte> eventBlock;
+    std::vector<csmByte> strings;
+    csmUint32 segmentCount = 0;
+    csmUint32 pointCount = 0;
+    csmBool valid = true;
+
+    // 与CubismMotion::Parse相同的规则展开片段
+    const csmInt32 curveCount = curves.IsArray() ? curves.GetSize() : 0;
+    for (csmInt32 i = 0; i < curveCount && valid; i++)
+    {
+        Utils::Value& curve = curves[i];
+        const csmString target = curve["Target"].GetRawString();
+
+        csmUint32 targetType;
+        if (target == "Model")
+        {
+            targetType = CurveTarget_Model;
+        }
+        else if (target == "Parameter")
+        {
+            targetType = CurveTarget_Parameter;
+        }
+        else if (target == "PartOpacity")
+        {
+            targetType = CurveTarget_PartOpacity;
+        }
+        else
+        {
+            CubismLogWarning("Warning : Unable to get segment type from Curve! The number of \"CurveCount\" may be incorrect!");
+            continue;
+        }
+
+        const csmString id = curve["Id"].GetRawString();
+        Write32(curveBlock, targetType);
+        Write32(curveBlock, static_cast<csmUint32>(strings.size()));
+        Write32(curveBlock, static_cast<csmUint32>(id.GetLength()));
+        WriteFloat(curveBlock, curve["FadeInTime"].IsNull() ? -1.0f : curve["FadeInTime"].ToFloat());
+        WriteFloat(curveBlock, curve["FadeOutTime"].IsNull() ? -1.0f : curve["FadeOutTime"].ToFloat());
+        Write32(curveBlock, segmentCount);
+        strings.insert(strings.end(), id.GetRawString(), id.GetRawString() + id.GetLength());
+
+        Utils::Value& segments = curve["Segments"];
+        const csmInt32 valueCount = segments.GetSize();
+        csmUint32 curveSegmentCount = 0;
+        for (csmInt32 position = 0; position < valueCount && valid;)
+        {
+            // 第一个片段带有起始控制点，之后的片段以前一个片段的终点为起点
+            if (position == 0)
+            {
+                Write32(segmentBlock, pointCount);
+                WriteFloat(pointBlock, segments[0].ToFloat());
+                WriteFloat(pointBlock, segments[1].ToFloat());
+                pointCount += 1;
+                position += 2;
+            }
+            else
+            {
+                Write32(segmentBlock, pointCount - 1);
+            }
+
+            const csmInt32 type = segments[position].ToInt();
+            csmInt32 newPoints;
+            switch (type)
+            {
+            case SegmentType_Linear:
+            case SegmentType_Stepped:
+            case SegmentType_InverseStepped:
+                newPoints = 1;
+                break;
+            case SegmentType_Bezier:
+                newPoints = 3;
+                break;
+            default:
+                newPoints = 0;
+                valid = false;
+                break;
+            }
+            if (position + newPoints * 2 >= valueCount)
+            {
+                valid = false;
+            }
+            if (!valid)
+            {
+                break;
+            }
+
+            Write32(segmentBlock, static_cast<csmUint32>(type));
+            for (csmInt32 k = 0; k < newPoints * 2; k++)
+            {
+                WriteFloat(pointBlock, segments[position + 1 + k].ToFloat());
+            }
+            pointCount += newPoints;
+            position += 1 + newPoints * 2;
+
+            curveSegmentCount++;
+            segmentCount++;
+        }
+        Write32(curveBlock, curveSegmentCount);
+        valid = valid && curveSegmentCount > 0;
+    }
+
+    const csmInt32 eventCount = userData.IsArray() ? userData.GetSize() : 0;
+    for (csmInt32 i = 0; i < eventCount; i++)
+    {
+        const csmString value = userData[i]["Value"].GetRawString();
+        WriteFloat(eventBlock, userData[i]["Time"].ToFloat());
+        Write32(eventBlock, static_cast<csmUint32>(strings.size()));
+        Write32(eventBlock, static_cast<csmUint32>(value.GetLength()));
+        strings.insert(strings.end(), value.GetRawString(), value.GetRawString() + value.GetLength());
+    }
+
+    csmUint32 flags = 0;
+    if (meta["Loop"].ToBoolean())
+    {
+        flags |= Flag_Loop;
+    }
+    if (meta["AreBeziersRestricted"].ToBoolean())
+    {
+        flags |= Flag_AreBeziersRestricted;
+    }
+
+    // 未指定或为负值时为1秒（与CubismMotion相同）
+    const csmFloat32 fadeInTime = meta["FadeInTime"].IsNull() ? 1.0f : meta["FadeInTime"].ToFloat();
+    const csmFloat32 fadeOutTime = meta["FadeOutTime"].IsNull() ? 1.0f : meta["FadeOutTime"].ToFloat();
+
+    outBinary.clear();
+    outBinary.insert(outBinary.end(), Magic, Magic + sizeof(Magic));
+    Write32(outBinary, Version);
+    Write32(outBinary, flags);
+    WriteFloat(outBinary, meta["Duration"].ToFloat());
+    WriteFloat(outBinary, meta["Fps"].ToFloat());
+    WriteFloat(outBinary, fadeInTime < 0.0f ? 1.0f : fadeInTime);
+    WriteFloat(outBinary, fadeOutTime < 0.0f ? 1.0f : fadeOutTime);
+    Write32(outBinary, static_cast<csmUint32>(curveBlock.size() / CurveSize));
+    Write32(outBinary, segmentCount);
+    Write32(outBinary, pointCount);
+    Write32(outBinary, static_cast<csmUint32>(eventCount));
+    Write32(outBinary, static_cast<csmUint32>(strings.size()));
+    Write64(outBinary, size);
+    Write64(outBinary, LAppPal::HashBytes(json, size));
+    outBinary.insert(outBinary.end(), curveBlock.begin(), curveBlock.end());
+    outBinary.insert(outBinary.end(), segmentBlock.begin(), segmentBlock.end());
+    outBinary.insert(outBinary.end(), pointBlock.begin(), pointBlock.end());
+    outBinary.insert(outBinary.end(), eventBlock.begin(), eventBlock.end());
+    outBinary.insert(outBinary.end(), strings.begin(), strings.end());
+
+    Utils::CubismJson::Delete(document);
+
+    return valid;
+}
+
+csmBool LAppBinaryMotion::IsUpToDate(const csmByte* buffer, csmSizeInt size, const csmByte* json, csmSizeInt jsonSize)
+{
+    if (buffer == NULL || size < HeaderSize || memcmp(buffer, Magic, sizeof(Magic)) != 0 || Read32(buffer + 4) != Version)
+    {
+        return false;
+    }
+
+    // 复制和检出会改变修改时间，因此比较内容。大小不同时不计算哈希
+    return Read64(buffer + 48) == jsonSize && Read64(buffer + 56) == LAppPal::HashBytes(json, jsonSize);
+}
+
+std::string LAppBinaryMotion::GetBinaryPath(const std::string& jsonPath)
+{
+    const std::string jsonExtension = ".json";
+    if (jsonPath.size() >= jsonExtension.size()
+        && jsonPath.compare(jsonPath.size() - jsonExtension.size(), jsonExtension.size(), jsonExtension) == 0)
+    {
+        return jsonPath.substr(0, jsonPath.size() - jsonExtension.size()) + ".bin";
+    }
+
+    return jsonPath + ".bin";
+}
+
+LAppBinaryMotion::LAppBinaryMotion()
+    : _duration(0.0f)
+    , _isLoop(false)
+    , _isLoopFadeIn(true)
+    , _areBeziersRestricted(false)
+    , _modelOpacity(1.0f)
+    , _modelCurveIdEyeBlink(NULL)
+    , _modelCurveIdLipSync(NULL)
+    , _modelCurveIdOpacity(NULL)
+{
+}
+
+LAppBinaryMotion::~LAppBinaryMotion()
+{
+}
+
+void LAppBinaryMotion::SetEffectIds(const csmVector<CubismIdHandle>& eyeBlinkParameterIds, const csmVector<CubismIdHandle>& lipSyncParameterIds)
+{
+    _eyeBlinkParameterIds = eyeBlinkParameterIds;
+    _lipSyncParameterIds = lipSyncParameterIds;
+}
+
+void LAppBinaryMotion::IsLoop(csmBool loop)
+{
+    _isLoop = loop;
+}
+
+void LAppBinaryMotion::IsLoopFadeIn(csmBool loopFadeIn)
+{
+    _isLoopFadeIn = loopFadeIn;
+}
+
+csmFloat32 LAppBinaryMotion::GetDuration()
+{
+    return _isLoop ? -1.0f : _duration;
+}
+
+csmFloat32 LAppBinaryMotion::GetLoopDuration()
+{
+    return _duration;
+}
+
+const csmVector<const csmString*>& LAppBinaryMotion::GetFiredEvent(csmFloat32 beforeCheckTimeSeconds, csmFloat32 motionTimeSeconds)
+{
+    _firedEventValues.UpdateSize(0);
+
+    for (csmUint32 i = 0; i < _eventTimes.size(); i++)
+    {
+        if (_eventTimes[i] > beforeCheckTimeSeconds && _eventTimes[i] <= motionTimeSeconds)
+        {
+            _firedEventValues.PushBack(&_eventValues[i]);
+        }
+    }
+
+    return _firedEventValues;
+}
+
+csmFloat32 LAppBinaryMotion::EvaluateCurve(csmUint32 index, csmFloat32 time) const
+{
+    const Curve& curve = _curves[index];
+
+    // 找到包含time的片段。超出最后一个片段时返回终点的值
+    const csmUint32 totalSegmentCount = curve.baseSegmentIndex + curve.segmentCount;
+    csmUint32 pointPosition = 0;
+    for (csmUint32 i = curve.baseSegmentIndex; i < totalSegmentCount; i++)
+    {
+        const Segment& segment = _segments[i];
+        pointPosition = segment.basePointIndex + (segment.type == SegmentType_Bezier ? 3 : 1);
+
+        if (_points[pointPosition].time > time)
+        {
+            MotionPoint points[4];
+            for (csmUint32 j = segment.basePointIndex; j <= pointPosition; j++)
+            {
+                points[j - segment.basePointIndex].time = _points[j].time;
+                points[j - segment.basePointIndex].value = _points[j].value;
+            }
+
+            switch (segment.type)
+            {
+            case SegmentType_Linear:
+                return LinearEvaluate(points, time);
+            case SegmentType_Bezier:
+                return _areBeziersRestricted ? BezierEvaluate(points, time) : BezierEvaluateCardanoInterpretation(points, time);
+            case SegmentType_Stepped:
+                return points[0].value;
+            default:
+                return points[1].value;
+            }
+        }
+    }
+
+    return _points[pointPosition].value;
+}
+
+void LAppBinaryMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSeconds, csmFloat32 fadeWeight, CubismMotionQueueEntry* motionQueueEntry)
+{
+    csmFloat32 timeOffsetSeconds = userTimeSeconds - motionQueueEntry->GetStartTime();
+    if (timeOffsetSeconds < 0.0f)
+    {
+        timeOffsetSeconds = 0.0f;
+    }
+
+    csmFloat32 lipSyncValue = FLT_MAX;
+    csmFloat32 eyeBlinkValue = FLT_MAX;
+    csmUint64 lipSyncFlags = 0ULL;
+    csmUint64 eyeBlinkFlags = 0ULL;
+
+    const csmFloat32 tmpFadeIn = GetFadeValue(_fadeInSeconds, userTimeSeconds - motionQueueEntry->GetFadeInStartTime());
+    const csmFloat32 tmpFadeOut = (motionQueueEntry->GetEndTime() < 0.0f) ? 1.0f : GetFadeValue(_fadeOutSeconds, motionQueueEntry->GetEndTime() - userTimeSeconds);
+
+    csmFloat32 time = timeOffsetSeconds;
+    if (_isLoop)
+    {
+        while (time > _duration)
+        {
+            time -= _duration;
+        }
+    }
+
+    // 曲线按Model、Parameter、PartOpacity的顺序排列（与CubismMotion相同）
+    csmUint32 c = 0;
+    for (; c < _curves.size() && _curves[c].target == CurveTarget_Model; c++)
+    {
+        const csmFloat32 value = EvaluateCurve(c, time);
+
+        if (_curves[c].id == _modelCurveIdEyeBlink)
+        {
+            eyeBlinkValue = value;
+        }
+        else if (_curves[c].id == _modelCurveIdLipSync)
+        {
+            lipSyncValue = value;
+        }
+        else if (_curves[c].id == _modelCurveIdOpacity)
+        {
+            _modelOpacity = value;
+            model->SetModelOapcity(_modelOpacity);
+        }
+    }
+
+    for (; c < _curves.size() && _curves[c].target == CurveTarget_Parameter; c++)
+    {
+        const csmInt32 parameterIndex = model->GetParameterIndex(_curves[c].id);
+        if (parameterIndex == -1)
+        {
+            continue;
+        }
+
+        const csmFloat32 sourceValue = model->GetParameterValue(parameterIndex);
+        csmFloat32 value = EvaluateCurve(c, time);
+
+        if (eyeBlinkValue != FLT_MAX)
+        {
+            for (csmInt32 i = 0; i < _eyeBlinkParameterIds.GetSize() && i < MaxTargetSize; i++)
+            {
+                if (_eyeBlinkParameterIds[i] == _curves[c].id)
+                {
+                    value *= eyeBlinkValue;
+                    eyeBlinkFlags |= 1ULL << i;
+                    break;
+                }
+            }
+        }
+
+        if (lipSyncValue != FLT_MAX)
+        {
+            for (csmInt32 i = 0; i < _lipSyncParameterIds.GetSize() && i < MaxTargetSize; i++)
+            {
+                if (_lipSyncParameterIds[i] == _curves[c].id)
+                {
+                    value += lipSyncValue;
+                    lipSyncFlags |= 1ULL << i;
+                    break;
+                }
+            }
+        }
+
+        csmFloat32 v;
+        if (_curves[c].fadeInTime < 0.0f && _curves[c].fadeOutTime < 0.0f)
+        {
+            // 曲线没有单独的淡入淡出时间时使用动作整体的权重
+            v = sourceValue + (value - sourceValue) * fadeWeight;
+        }
+        else
+        {
+            const csmFloat32 fin = (_curves[c].fadeInTime < 0.0f)
+                ? tmpFadeIn
+                : GetFadeValue(_curves[c].fadeInTime, userTimeSeconds - motionQueueEntry->GetFadeInStartTime());
+            const csmFloat32 fout = (_curves[c].fadeOutTime < 0.0f)
+                ? tmpFadeOut
+                : ((motionQueueEntry->GetEndTime() < 0.0f) ? 1.0f : GetFadeValue(_curves[c].fadeOutTime, motionQueueEntry->GetEndTime() - userTimeSeconds));
+
+            const csmFloat32 paramWeight = _weight * fin * fout;
+            v = sourceValue + (value - sourceValue) * paramWeight;
+        }
+
+        model->SetParameterValue(parameterIndex, v);
+    }
+
+    // 动作中没有曲线的眨眼、唇形同步参数直接使用效果值
+    if (eyeBlinkValue != FLT_MAX)
+    {
+        for (csmInt32 i = 0; i < _eyeBlinkParameterIds.GetSize() && i < MaxTargetSize; i++)
+        {
+            if ((eyeBlinkFlags >> i) & 0x01)
+            {
+                continue;
+            }
+            const csmFloat32 sourceValue = model->GetParameterValue(_eyeBlinkParameterIds[i]);
+            model->SetParameterValue(_eyeBlinkParameterIds[i], sourceValue + (eyeBlinkValue - sourceValue) * fadeWeight);
+        }
+    }
+
+    if (lipSyncValue != FLT_MAX)
+    {
+        for (csmInt32 i = 0; i < _lipSyncParameterIds.GetSize() && i < MaxTargetSize; i++)
+        {
+            if ((lipSyncFlags >> i) & 0x01)
+            {
+                continue;
+            }
+            const csmFloat32 sourceValue = model->GetParameterValue(_lipSyncParameterIds[i]);
+            model->SetParameterValue(_lipSyncParameterIds[i], sourceValue + (lipSyncValue - sourceValue) * fadeWeight);
+        }
+    }
+
+    for (; c < _curves.size() && _curves[c].target == CurveTarget_PartOpacity; c++)
+    {
+        const csmInt32 parameterIndex = model->GetParameterIndex(_curves[c].id);
+        if (parameterIndex == -1)
+        {
+            continue;
+        }
+
+        model->SetParameterValue(parameterIndex, EvaluateCurve(c, time));
+    }
+
+    if (timeOffsetSeconds >= _duration)
+    {
+        if (_isLoop)
+        {
+            // 回到开头继续播放
+            motionQueueEntry->SetStartTime(userTimeSeconds);
+            if (_isLoopFadeIn)
+            {
+                motionQueueEntry->SetFadeInStartTime(userTimeSeconds);
+            }
+        }
+        else
+        {
+            if (_onFinishedMotion != NULL)
+            {
+                _onFinishedMotion(this);
+            }
+            motionQueueEntry->IsFinished(true);
+        }
+    }
+}
@@ -0,0 +1,195 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <CubismFramework.hpp>
+#include <Motion/ACubismMotion.hpp>
+
+ /**
+ * @brief 预编译的二进制动作（.motion3.bin）
+ *
+ * 将motion3.json的曲线、片段、控制点、淡入淡出时间和事件预先转换为紧凑的二进制数据，
+ * 加载时不进行JSON解析，控制点和片段直接整块复制。
+ *
+ 这段代码定义了一个名为LAppBinaryMotion的类，该类继承自Csm::ACubismMotion，播放结果与CubismMotion相同。
+
+二进制数据的布局（小端序）：
+Header：魔数"L2DM"、版本、标志（循环、贝塞尔曲线受限）、时长、FPS、淡入时间、淡出时间、曲线数、片段数、控制点数、事件数、字符串表大小、转换时motion3.json的大小和内容哈希。
+Curves：目标类型、ID（字符串表中的偏移和长度）、曲线的淡入淡出时间、起始片段、片段数。
+Segments：起始控制点、片段类型。
+Points：时间、值。
+Events：触发时间、值（字符串表中的偏移和长度）。
+Strings：曲线ID和事件值。
+
+Create：从二进制数据生成动作。
+Compile：将motion3.json转换为二进制数据（供转换工具使用）。
+IsUpToDate：判断二进制数据是否由当前的motion3.json转换而来（比较内容，motion3.json修改后二进制数据失效，复制和检出不影响）。
+GetBinaryPath：获取motion3.json旁边的二进制文件路径。
+SetEffectIds：设置眨眼和唇形同步的参数ID（与CubismMotion相同）。
+ */
+class LAppBinaryMotion : public Csm::ACubismMotion
+{
+public:
+    static const Csm::csmUint32 Version = 3;  ///< 二进制格式的版本
+
+    /**
+    * @brief 从二进制数据生成动作
+    *
+    * 曲线ID在此时注册到CubismIdManager，在工作线程上调用时需持有LAppPal::GetIdManagerMutex的独占锁。
+    *
+    * @param[in]   buffer                      Compile生成的二进制数据
+    * @param[in]   size                        数据大小
+    * @param[in]   onFinishedMotionHandler     动作播放结束时调用的回调函数
+    * @return                                  动作。格式不正确时返回NULL
+    */
+    static LAppBinaryMotion* Create(const Csm::csmByte* buffer, Csm::csmSizeInt size, FinishedMotionCallback onFinishedMotionHandler = NULL);
+
+    /**
+    * @brief 将motion3.json转换为二进制数据
+    *
+    * motion3.json的大小和内容哈希写入Header，供IsUpToDate判断。
+    *
+    * @param[in]   json        motion3.json的数据
+    * @param[in]   size        数据大小
+    * @param[out]  outBinary   二进制数据
+    * @return                  成功时返回true
+    */
+    static Csm::csmBool Compile(const Csm::csmByte* json, Csm::csmSizeInt size, std::vector<Csm::csmByte>& outBinary);
+
+    /**
+    * @brief 判断二进制数据是否由当前的motion3.json转换而来
+    *
+    * @param[in]   buffer      Compile生成的二进制数据
+    * @param[in]   size        数据大小
+    * @param[in]   json        当前motion3.json的数据
+    * @param[in]   jsonSize    motion3.json的数据大小
+    * @return                  Header中记录的大小和哈希与json一致时返回true
+    */
+    static Csm::csmBool IsUpToDate(const Csm::csmByte* buffer, Csm::csmSizeInt size, const Csm::csmByte* json, Csm::csmSizeInt jsonSize);
+
+    /**
+    * @brief 获取motion3.json对应的二进制文件路径（"xxx.motion3.json"→"xxx.motion3.bin"）
+    */
+    static std::string GetBinaryPath(const std::string& jsonPath);
+
+    /**
+    * @brief 设置眨眼和唇形同步的参数ID
+    *
+    * @param[in]   eyeBlinkParameterIds    眨眼的参数ID
+    * @param[in]   lipSyncParameterIds     唇形同步的参数ID
+    */
+    void SetEffectIds(const Csm::csmVector<Csm::CubismIdHandle>& eyeBlinkParameterIds, const Csm::csmVector<Csm::CubismIdHandle>& lipSyncParameterIds);
+
+    /**
+    * @brief 设置是否循环
+    */
+    void IsLoop(Csm::csmBool loop);
+
+    /**
+    * @brief 设置循环时是否淡入
+    */
+    void IsLoopFadeIn(Csm::csmBool loopFadeIn);
+
+    virtual Csm::csmFloat32 GetDuration();
+
+    virtual Csm::csmFloat32 GetLoopDuration();
+
+    virtual const Csm::csmVector<const Csm::csmString*>& GetFiredEvent(Csm::csmFloat32 beforeCheckTimeSeconds, Csm::csmFloat32 motionTimeSeconds);
+
+protected:
+    /**
+    * @brief 构造函数
+    */
+    LAppBinaryMotion();
+
+    /**
+    * @brief 析构函数
+    */
+    virtual ~LAppBinaryMotion();
+
+    /**
+    * @brief 更新模型参数（与CubismMotion::DoUpdateParameters相同）
+    */
+    virtual void DoUpdateParameters(Csm::CubismModel* model, Csm::csmFloat32 userTimeSeconds, Csm::csmFloat32 fadeWeight, Csm::CubismMotionQueueEntry* motionQueueEntry);
+
+private:
+    /**
+    * @brief 曲线的目标类型
+    */
+    enum CurveTarget
+    {
+        CurveTarget_Model,
+        CurveTarget_Parameter,
+        CurveTarget_PartOpacity,
+    };
+
+    /**
+    * @brief 片段类型（与motion3.json的Segments中的值相同）
+    */
+    enum SegmentType
+    {
+        SegmentType_Linear = 0,
+        SegmentType_Bezier = 1,
+        SegmentType_Stepped = 2,
+        SegmentType_InverseStepped = 3,
+    };
+
+    /**
+    * @brief 控制点（与二进制数据中的布局相同）
+    */
+    struct Point
+    {
+        Csm::csmFloat32 time;
+        Csm::csmFloat32 value;
+    };
+
+    /**
+    * @brief 片段（与二进制数据中的布局相同）
+    */
+    struct Segment
+    {
+        Csm::csmUint32 basePointIndex;
+        Csm::csmUint32 type;
+    };
+
+    /**
+    * @brief 曲线
+    */
+    struct Curve
+    {
+        Csm::csmUint32 target;
+        Csm::CubismIdHandle id;
+        Csm::csmFloat32 fadeInTime;
+        Csm::csmFloat32 fadeOutTime;
+        Csm::csmUint32 baseSegmentIndex;
+        Csm::csmUint32 segmentCount;
+    };
+
+    /**
+    * @brief 计算曲线在指定时间的值
+    */
+    Csm::csmFloat32 EvaluateCurve(Csm::csmUint32 index, Csm::csmFloat32 time) const;
+
+    Csm::csmFloat32 _duration;                          ///< 时长[秒]
+    Csm::csmBool _isLoop;                               ///< 是否循环
+    Csm::csmBool _isLoopFadeIn;                         ///< 循环时是否淡入
+    Csm::csmBool _areBeziersRestricted;                 ///< 贝塞尔曲线的控制点是否限制在片段内（是时按线性时间计算）
+    Csm::csmFloat32 _modelOpacity;                      ///< 动作设置的模型不透明度
+    std::vector<Curve> _curves;                         ///< 曲线
+    std::vector<Segment> _segments;                     ///< 片段
+    std::vector<Point> _points;                         ///< 控制点
+    std::vector<Csm::csmFloat32> _eventTimes;           ///< 事件的触发时间
+    std::vector<Csm::csmString> _eventValues;           ///< 事件的值
+    Csm::csmVector<Csm::CubismIdHandle> _eyeBlinkParameterIds;   ///< 眨眼的参数ID
+    Csm::csmVector<Csm::CubismIdHandle> _lipSyncParameterIds;    ///< 唇形同步的参数ID
+    Csm::CubismIdHandle _modelCurveIdEyeBlink;          ///< 模型曲线的ID：EyeBlink
+    Csm::CubismIdHandle _modelCurveIdLipSync;           ///< 模型曲线的ID：LipSync
+    Csm::CubismIdHandle _modelCurveIdOpacity;           ///< 模型曲线的ID：Opacity
+};
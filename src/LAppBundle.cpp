@@ -0,0 +1,362 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppBundle.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+using namespace Csm;
+
+namespace
+{
+    const csmChar Magic[4] = { 'L', '2', 'D', 'B' };
+    const csmUint32 HeaderSize = 24; ///< 魔数、版本、条目数、名称表偏移、名称表大小、保留
+    const csmUint32 EntrySize = 24;  ///< 哈希、名称偏移、名称长度、数据偏移、数据大小
+
+    csmUint32 Read32(const csmByte* p)
+    {
+        csmUint32 value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    csmUint64 Read64(const csmByte* p)
+    {
+        csmUint64 value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    void Write32(std::vector<csmByte>& out, csmUint32 value)
+    {
+        const csmByte* p = reinterpret_cast<const csmByte*>(&value);
+        out.insert(out.end(), p, p + sizeof(value));
+    }
+
+    void Write64(std::vector<csmByte>& out, csmUint64 value)
+    {
+        const csmByte* p = reinterpret_cast<const csmByte*>(&value);
+        out.insert(out.end(), p, p + sizeof(value));
+    }
+
+    /**
+    * @brief 递归收集目录下的所有文件（相对路径）
+    */
+    void CollectFiles(const std::string& root, const std::string& relative, std::vector<std::string>& outFiles)
+    {
+#ifdef _WIN32
+        WIN32_FIND_DATAA findData;
+        HANDLE find = FindFirstFileA((root + relative + "*").c_str(), &findData);
+        if (find == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+        do
+        {
+            const std::string name = findData.cFileName;
+            if (name == "." || name == "..")
+            {
+                continue;
+            }
+            if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            {
+                CollectFiles(root, relative + name + "/", outFiles);
+            }
+            else
+            {
+                outFiles.push_back(relative + name);
+            }
+        } while (FindNextFileA(find, &findData));
+        FindClose(find);
+#else
+        DIR* dir = opendir((root + relative).c_str());
+        if (dir == NULL)
+        {
+            return;
+        }
+        for (struct dirent* entry = readdir(dir); entry != NULL; entry = readdir(dir))
+        {
+            const std::string name = entry->d_name;
+            if (name == "." || name == "..")
+            {
+                continue;
+            }
+            struct stat statBuf;
+            if (stat((root + relative + name).c_str(), &statBuf) != 0)
+            {
+                continue;
+            }
+            if (S_ISDIR(statBuf.st_mode))
+            {
+                CollectFiles(root, relative + name + "/", outFiles);
+            }
+            else
+            {
+                outFiles.push_back(relative + name);
+            }
+        }
+        closedir(dir);
+#endif
+    }
+
+    struct PackEntry
+    {
+        csmUint64 hash;
+        std::string name;
+        std::vector<csmByte> data;
+
+        bool operator<(const PackEntry& rhs) const
+        {
+            return hash < rhs.hash;
+        }
+    };
+}
+
+LAppBundle::LAppBundle()
+    : _data(NULL)
+    , _size(0)
+    , _entryCount(0)
+    , _index(NULL)
+    , _names(NULL)
+    , _namesSize(0)
+{
+}
+
+csmBool LAppBundle::Open(const csmByte* data, csmSizeInt size)
+{
+    if (data == NULL || size < HeaderSize || memcmp(data, Magic, sizeof(Magic)) != 0)
+    {
+        return false;
+    }
+    if (Read32(data + 4) != Version)
+    {
+        return false;
+    }
+
+    const csmUint32 entryCount = Read32(data + 8);
+    const csmUint32 namesOffset = Read32(data + 12);
+    const csmUint32 namesSize = Read32(data + 16);
+
+    // 索引和名称表必须在文件范围内
+    const csmUint64 indexEnd = static_cast<csmUint64>(HeaderSize) + static_cast<csmUint64>(entryCount) * EntrySize;
+    if (indexEnd > size || namesOffset < indexEnd || static_cast<csmUint64>(namesOffset) + namesSize > size)
+    {
+        return false;
+    }
+
+    _data = data;
+    _size = size;
+    _entryCount = entryCount;
+    _index = data + HeaderSize;
+    _names = reinterpret_cast<const csmChar*>(data + namesOffset);
+    _namesSize = namesSize;
+
+    return true;
+}
+
+LAppBundle::Entry LAppBundle::GetEntry(csmUint32 index) const
+{
+    const csmByte* p = _index + static_cast<csmSizeType>(index) * EntrySize;
+    Entry entry;
+    entry.hash = Read64(p);
+    entry.nameOffset = Read32(p + 8);
+    entry.nameLength = Read32(p + 12);
+    entry.dataOffset = Read32(p + 16);
+    entry.dataSize = Read32(p + 20);
+    return entry;
+}
+
+const csmByte* LAppBundle::Find(const std::string& relativePath, csmSizeInt* outSize) const
+{
+    if (_data == NULL)
+    {
+        return NULL;
+    }
+
+    const std::string name = NormalizePath(relativePath);
+    const csmUint64 hash = HashPath(name);
+
+    // 索引按哈希升序排列，二分查找第一个哈希相同的条目
+    csmUint32 low = 0;
+    csmUint32 high = _entryCount;
+    while (low < high)
+    {
+        const csmUint32 mid = low + (high - low) / 2;
+        if (GetEntry(mid).hash < hash)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    // 哈希冲突时比较名称
+    for (csmUint32 i = low; i < _entryCount; i++)
+    {
+        const Entry entry = GetEntry(i);
+        if (entry.hash != hash)
+        {
+            break;
+        }
+        if (static_cast<csmUint64>(entry.nameOffset) + entry.nameLength > _namesSize
+            || static_cast<csmUint64>(entry.dataOffset) + entry.dataSize > _size)
+        {
+            continue;
+        }
+        if (entry.nameLength == name.size() && memcmp(_names + entry.nameOffset, name.c_str(), name.size()) == 0)
+        {
+            *outSize = entry.dataSize;
+            return _data + entry.dataOffset;
+        }
+    }
+
+    return NULL;
+}
+
+csmBool LAppBundle::Contains(const csmByte* address) const
+{
+    return _data != NULL && address >= _data && address < _data + _size;
+}
+
+csmUint32 LAppBundle::GetEntryCount() const
+{
+    return _entryCount;
+}
+
+csmBool LAppBundle::Pack(const std::string& directory, const std::string& bundlePath, csmUint32* outEntryCount)
+{
+    std::string root = NormalizePath(directory);
+    if (!root.empty() && root[root.size() - 1] != '/')
+    {
+        root += "/";
+    }
+
+    std::vector<std::string> files;
+    CollectFiles(root, "", files);
+
+    std::vector<PackEntry> entries(files.size());
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        std::ifstream file((root + files[i]).c_str(), std::ios::in | std::ios::binary);
+        if (!file.is_open())
+        {
+            return false;
+        }
+        entries[i].name = NormalizePath(files[i]);
+        entries[i].hash = HashPath(entries[i].name);
+        entries[i].data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    std::stable_sort(entries.begin(), entries.end());
+
+    // 名称表
+    std::vector<csmByte> names;
+    std::vector<csmUint32> nameOffsets(entries.size());
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        nameOffsets[i] = static_cast<csmUint32>(names.size());
+        names.insert(names.end(), entries[i].name.begin(), entries[i].name.end());
+    }
+
+    const csmUint32 entryCount = static_cast<csmUint32>(entries.size());
+    const csmUint32 namesOffset = HeaderSize + entryCount * EntrySize;
+
+    // 数据偏移
+    std::vector<csmUint32> dataOffsets(entries.size());
+    csmUint64 offset = namesOffset + names.size();
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        offset = (offset + DataAlignment - 1) / DataAlignment * DataAlignment;
+        dataOffsets[i] = static_cast<csmUint32>(offset);
+        offset += entries[i].data.size();
+    }
+    if (offset > 0xFFFFFFFFULL)
+    {
+        return false;
+    }
+
+    std::vector<csmByte> out;
+    out.reserve(static_cast<size_t>(offset));
+    out.insert(out.end(), Magic, Magic + sizeof(Magic));
+    Write32(out, Version);
+    Write32(out, entryCount);
+    Write32(out, namesOffset);
+    Write32(out, static_cast<csmUint32>(names.size()));
+    Write32(out, 0);
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        Write64(out, entries[i].hash);
+        Write32(out, nameOffsets[i]);
+        Write32(out, static_cast<csmUint32>(entries[i].name.size()));
+        Write32(out, dataOffsets[i]);
+        Write32(out, static_cast<csmUint32>(entries[i].data.size()));
+    }
+    out.insert(out.end(), names.begin(), names.end());
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        out.resize(dataOffsets[i], 0);
+        out.insert(out.end(), entries[i].data.begin(), entries[i].data.end());
+    }
+
+    std::ofstream bundle(bundlePath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!bundle.is_open())
+    {
+        return false;
+    }
+    bundle.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+    if (!bundle.good())
+    {
+        return false;
+    }
+
+    if (outEntryCount != NULL)
+    {
+        *outEntryCount = entryCount;
+    }
+    return true;
+}
+
+std::string LAppBundle::NormalizePath(const std::string& path)
+{
+    std::string result;
+    result.reserve(path.size());
+
+    size_t i = 0;
+    while (i < path.size())
+    {
+        // 跳过"./"片段
+        if (path[i] == '.' && (i + 1 < path.size()) && (path[i + 1] == '/' || path[i + 1] == '\\')
+            && (i == 0 || path[i - 1] == '/' || path[i - 1] == '\\'))
+        {
+            i += 2;
+            continue;
+        }
+        result += (path[i] == '\\') ? '/' : path[i];
+        i++;
+    }
+
+    return result;
+}
+
+csmUint64 LAppBundle::HashPath(const std::string& normalizedPath)
+{
+    csmUint64 hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < normalizedPath.size(); i++)
+    {
+        hash ^= static_cast<csmUint8>(normalizedPath[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
@@ -0,0 +1,114 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+#include <string>
+#include <vector>
+
+ /**
+ * @brief 模型素材包（.l2db）
+ *
+ * 将一个模型目录下的所有文件打包为单个文件，并附带按路径哈希排序的索引。
+ *
+ 这段代码定义了一个名为LAppBundle的类，用于读取和生成模型素材包。
+
+素材包的布局（小端序）：
+Header：魔数"L2DB"、版本、条目数、名称表偏移、名称表大小。
+Index：按路径哈希升序排列的条目（哈希、名称偏移、名称长度、数据偏移、数据大小），通过二分查找定位。
+Names：相对于模型目录的路径（以'/'分隔）。
+Data：各文件的内容，按DataAlignment字节对齐。
+
+Open：在内存中的素材包数据（通常是LAppPal映射的视图）上打开索引，不复制数据。
+Find：按相对路径查找文件，返回指向素材包内部的指针。
+Pack：将目录下的所有文件写入素材包文件（供打包工具使用）。
+ */
+class LAppBundle
+{
+public:
+    static const Csm::csmUint32 Version = 1;          ///< 素材包格式版本
+    static const Csm::csmUint32 DataAlignment = 64;   ///< 数据区的对齐（满足moc3的对齐要求）
+
+    /**
+    * @brief 构造函数
+    */
+    LAppBundle();
+
+    /**
+    * @brief 在内存中的素材包数据上打开索引
+    *
+    * @param[in]   data    素材包的字节数据。在LAppBundle使用期间必须保持有效
+    * @param[in]   size    素材包的大小
+    * @return              格式正确时返回true
+    */
+    Csm::csmBool Open(const Csm::csmByte* data, Csm::csmSizeInt size);
+
+    /**
+    * @brief 按相对路径查找文件
+    *
+    * @param[in]   relativePath    相对于模型目录的路径
+    * @param[out]  outSize         文件大小
+    * @return                      指向素材包内部数据的指针。不存在时返回NULL
+    */
+    const Csm::csmByte* Find(const std::string& relativePath, Csm::csmSizeInt* outSize) const;
+
+    /**
+    * @brief 判断指针是否指向此素材包的数据
+    */
+    Csm::csmBool Contains(const Csm::csmByte* address) const;
+
+    /**
+    * @brief 获取条目数
+    */
+    Csm::csmUint32 GetEntryCount() const;
+
+    /**
+    * @brief 将目录下的所有文件打包为素材包文件
+    *
+    * @param[in]   directory       模型目录
+    * @param[in]   bundlePath      输出的素材包文件路径
+    * @param[out]  outEntryCount   写入的文件数
+    * @return                      成功时返回true
+    */
+    static Csm::csmBool Pack(const std::string& directory, const std::string& bundlePath, Csm::csmUint32* outEntryCount);
+
+    /**
+    * @brief 规范化相对路径（'\\'替换为'/'，去除"./"）
+    */
+    static std::string NormalizePath(const std::string& path);
+
+    /**
+    * @brief 计算路径的哈希值（FNV-1a 64bit）
+    */
+    static Csm::csmUint64 HashPath(const std::string& normalizedPath);
+
+private:
+    /**
+    * @brief 索引条目
+    */
+    struct Entry
+    {
+        Csm::csmUint64 hash;        ///< 路径的哈希值
+        Csm::csmUint32 nameOffset;  ///< 名称在名称表中的偏移
+        Csm::csmUint32 nameLength;  ///< 名称的长度
+        Csm::csmUint32 dataOffset;  ///< 数据相对于文件开头的偏移
+        Csm::csmUint32 dataSize;    ///< 数据大小
+    };
+
+    /**
+    * @brief 读取第index个索引条目
+    */
+    Entry GetEntry(Csm::csmUint32 index) const;
+
+    const Csm::csmByte* _data;       ///< 素材包的字节数据
+    Csm::csmSizeInt _size;           ///< 素材包的大小
+    Csm::csmUint32 _entryCount;      ///< 条目数
+    const Csm::csmByte* _index;      ///< 索引的起始地址
+    const Csm::csmChar* _names;      ///< 名称表的起始地址
+    Csm::csmUint32 _namesSize;       ///< 名称表的大小
+};
@@ -36,6 +36,8 @@ namespace LAppDefine
     const csmChar* GearImageName = "icon_gear.png";
     // 关闭按钮
     const csmChar* PowerImageName = "close.png";
+    // 模型素材包（例如 resources/Mao.l2db），存在时代替模型目录
+    const csmChar* BundleExtension = ".l2db";
 
     // 模型定义------------------------------------------
     // 模型所在目录名的数组
@@ -49,6 +51,11 @@ namespace LAppDefine
         {-0.65f, 2.2f, 2.2f},
     };
 
+    // 每个模型的纹理质量（-1: 使用TextureQuality 0: 原始分辨率 1: 1/2 2: 1/4）
+    const csmInt32 ModelTextureQuality[] = {
+        -1,
+    };
+
     // 与外部定义文件(json)保持一致
     const csmChar* MotionGroupIdle = "Idle"; // 空闲
     const csmChar* MotionGroupTapBody = "TapBody"; // 点击身体时
@@ -66,6 +73,80 @@ namespace LAppDefine
     // MOC3文件的一致性验证选项
     const csmBool MocConsistencyValidationEnable = true;
 
+    // 以只读内存映射读取素材文件（省去一次复制和堆分配）
+    const csmBool MappedFileReadEnable = true;
+
+    // 在工作线程上并行读取、解析模型素材（动作较多的模型加载时间随核心数缩短）
+    const csmBool ParallelSetupEnable = true;
+    const csmUint32 WorkerThreadCount = 0;
+
+    // 动作在首次播放时解析，超出预算后淘汰最久未使用的动作（按motion3.json的大小估算）
+    const csmSizeInt MotionCacheBudgetBytes = 8 * 1024 * 1024;
+
+    // 存在由MotionConverter生成的.motion3.bin时跳过JSON解析
+    const csmBool BinaryMotionEnable = true;
+
+    // 显示场景期间在后台读取、解码下一个场景，NextScene时只需上传纹理（解码前按moc等文件大小和PNG尺寸估算，超出预算时不读取）
+    const csmBool ScenePrefetchEnable = true;
+    const csmSizeInt ScenePrefetchBudgetBytes = 128 * 1024 * 1024;
+
+    // 编辑素材时只重新读取变更的表情、动作、物理运算、姿势和纹理（从素材包读取时不监视）
+    const csmBool HotReloadEnable = true;
+    const csmFloat32 HotReloadSettleSeconds = 0.2f;
+
+    // 记录文件读取、解析、moc复原、PNG解码、GL上传等的耗时，结束时输出汇总并写出Chrome trace JSON
+    const csmBool LoadTraceEnable = false;
+    const csmChar* LoadTraceFilePath = "load_trace.json";
+    // 每条记录约100字节，场景切换和热重载不断添加记录，超过上限后丢弃
+    const csmUint32 LoadTraceMaxRecords = 100000;
+
+    // 将解码（和预乘）后的RGBA像素按源文件的路径、大小和修改时间保存，下次启动时映射读取，跳过PNG解码
+    const csmBool TextureCacheEnable = true;
+    const csmChar* TextureCacheDirectory = "texture_cache/";
+    const csmBool TextureCacheMipmapEnable = false;
+
+    // 启动时用4096x4096的随机图像比较标量、SSE2、AVX2预乘处理的耗时，并校验结果一致
+    const csmBool ImageKernelBenchmarkEnable = false;
+
+    // 启动时用约100万个随机样本比较标量、SSE2、AVX2平方和（口型同步的RMS）的耗时，并校验结果
+    const csmBool AudioKernelBenchmarkEnable = false;
+
+    // 常驻显存的纹理超出预算时，帧结束时淘汰最久未绘制的纹理，再次绘制时从纹理缓存重新上传
+    const csmSizeInt TextureBudgetBytes = 256 * 1024 * 1024;
+
+    // 读取模型纹理时按盒式滤波缩小（UV为归一化坐标，不需要修改模型）。显存和上传时间为1/4、1/16
+    const csmInt32 TextureQuality = 0;
+
+    // 异步加载场景时，像素在工作线程上复制到映射的PBO，之后每帧按TextureStreamBytesPerFrame分批执行glTexSubImage2D。
+    // 大纹理的上传不再阻塞一帧，上传完成（围栏通过）之前模型绑定占位纹理
+    const csmBool TextureStreamingEnable = true;
+    const csmSizeInt TextureStreamBytesPerFrame = 8 * 1024 * 1024;
+
+    // UI图集中每张图像周围用边缘像素填充的宽度，防止线性过滤混入相邻图像
+    const csmInt32 SpriteAtlasPadding = 2;
+
+    // 口型同步的wav只复制data块的原始样本，Update时只解码经过的样本，不再把整个文件展开为float数组（16位时内存减半）。
+    // 读取后立即释放LoadFileAsBytes返回的视图，Windows上映射中的文件无法替换，保持视图会妨碍重新导出语音和热重载
+    const csmBool WavStreamingEnable = true;
+
+    // 加载模型时将各动作的语音烘焙为8位RMS包络，并保存到LipSyncEnvelopeDirectory中的.l2de文件（wav未变更时直接读取）。
+    // 播放时口型同步只查表插值，不再读取和扫描PCM
+    const csmBool LipSyncEnvelopeEnable = true;
+    const csmUint32 LipSyncEnvelopeFrameRate = 100;
+    const csmChar* LipSyncEnvelopeDirectory = "lipsync_cache/";
+
+    // 读取过的wav按路径保留，再次播放时不读取文件也不转换PCM。超出预算时淘汰最久未播放的语音
+    const csmSizeInt VoiceCacheBudgetBytes = 32 * 1024 * 1024;
+
+    // 从文件或命名管道（例如"\\\\.\\pipe\\live2d_lipsync"）读取16位小端的原始PCM，经无锁环形缓冲区交给主线程，
+    // 每帧用经过时间的样本计算RMS驱动场景中模型的口型。缓冲超过最大延迟时丢弃最旧的样本
+    const csmChar* LipSyncStreamPath = "";
+    const csmUint32 LipSyncStreamSamplingRate = 16000;
+    const csmUint32 LipSyncStreamChannels = 1;
+    const csmBool LipSyncStreamRealTime = true;
+    const csmFloat32 LipSyncStreamMaxLatencySeconds = 0.1f;
+    const csmFloat32 LipSyncStreamBufferSeconds = 1.0f;
+
     // 调试日志显示选项
     const csmBool DebugLogEnable = true;
     const csmBool DebugTouchLogEnable = false;
@@ -39,11 +39,13 @@ namespace LAppDefine
     extern const csmChar* BackImageName;         ///< 背景图片文件
     extern const csmChar* GearImageName;         ///< 齿轮图片文件
     extern const csmChar* PowerImageName;        ///< 关闭按钮图片文件
+    extern const csmChar* BundleExtension;       ///< 模型素材包的扩展名（放在模型目录旁：素材路径 + 目录名 + 扩展名）
 
     // 模型定义--------------------------------------------
     extern const csmChar* ModelDir[];               ///< 模型所在目录名的数组。请确保目录名与model3.json的名称相匹配。
     extern const csmInt32 ModelDirSize;             ///< 模型目录数组的大小
     extern const float ModelFix[][3];                  //模型渲染时的偏移修正
+    extern const csmInt32 ModelTextureQuality[];    ///< 每个模型的纹理质量（-1时使用TextureQuality）
 
     // 与外部定义文件(json)保持一致
     extern const csmChar* MotionGroupIdle;          ///< 空闲时播放的动作列表
@@ -61,6 +63,51 @@ namespace LAppDefine
 
     extern const csmBool MocConsistencyValidationEnable; ///< MOC3一致性验证功能的启用/禁用
 
+    extern const csmBool MappedFileReadEnable;      ///< 以内存映射方式读取素材文件的启用/禁用
+
+    extern const csmBool ParallelSetupEnable;       ///< 在工作线程上并行读取模型素材的启用/禁用
+    extern const csmUint32 WorkerThreadCount;       ///< 工作线程数（0时为逻辑核心数-1）
+
+    extern const csmSizeInt MotionCacheBudgetBytes; ///< 每个模型常驻动作的字节预算
+    extern const csmBool BinaryMotionEnable;        ///< 优先读取motion3.json旁边的预编译二进制动作（.motion3.bin）的启用/禁用
+
+    extern const csmBool ScenePrefetchEnable;       ///< 在后台预读下一个场景的启用/禁用
+    extern const csmSizeInt ScenePrefetchBudgetBytes; ///< 预读场景读取的素材和解码的纹理的字节预算
+
+    extern const csmBool HotReloadEnable;           ///< 监视模型目录并重新读取变更的素材的启用/禁用
+    extern const csmFloat32 HotReloadSettleSeconds; ///< 文件变更后到重新读取的等待时间[秒]
+
+    extern const csmBool LoadTraceEnable;           ///< 记录模型加载各阶段耗时的启用/禁用
+    extern const csmChar* LoadTraceFilePath;        ///< 结束时写出的Chrome trace JSON的路径
+    extern const csmUint32 LoadTraceMaxRecords;     ///< 保留的最大记录数（超出后丢弃新的记录）
+
+    extern const csmBool TextureCacheEnable;        ///< 将解码后的纹理保存到磁盘缓存的启用/禁用
+    extern const csmChar* TextureCacheDirectory;    ///< 纹理缓存的保存目录
+    extern const csmBool TextureCacheMipmapEnable;  ///< 纹理缓存中同时保存mip链的启用/禁用
+
+    extern const csmBool ImageKernelBenchmarkEnable; ///< 启动时对预乘处理的各SIMD内核计时的启用/禁用
+    extern const csmBool AudioKernelBenchmarkEnable; ///< 启动时对口型同步平方和的各SIMD内核计时的启用/禁用
+
+    extern const csmSizeInt TextureBudgetBytes;     ///< 纹理的显存预算（字节）。为0时不淘汰
+    extern const csmInt32 TextureQuality;           ///< 模型纹理的读取质量（0: 原始分辨率 1: 1/2 2: 1/4）
+
+    extern const csmBool TextureStreamingEnable;    ///< 异步加载场景时通过像素缓冲区对象分帧上传纹理的启用/禁用
+    extern const csmSizeInt TextureStreamBytesPerFrame; ///< 每帧从像素缓冲区对象上传的纹理字节数
+
+    extern const csmInt32 SpriteAtlasPadding;       ///< UI图集中图像周围的边距（像素）
+
+    extern const csmBool WavStreamingEnable;        ///< 口型同步的wav按需解码（不展开整个文件）的启用/禁用
+    extern const csmBool LipSyncEnvelopeEnable;     ///< 将语音预先烘焙为口型同步包络的启用/禁用
+    extern const csmUint32 LipSyncEnvelopeFrameRate; ///< 口型同步包络的帧率[Hz]
+    extern const csmChar* LipSyncEnvelopeDirectory; ///< 口型同步包络的保存目录
+    extern const csmSizeInt VoiceCacheBudgetBytes;  ///< 语音缓存的字节预算。为0时只保留正在播放的语音
+    extern const csmChar* LipSyncStreamPath;        ///< 实时口型同步读取原始PCM的文件或命名管道。为空字符串时不使用
+    extern const csmUint32 LipSyncStreamSamplingRate; ///< 实时口型同步PCM的采样率[Hz]
+    extern const csmUint32 LipSyncStreamChannels;   ///< 实时口型同步PCM的声道数
+    extern const csmBool LipSyncStreamRealTime;     ///< 按采样率的速度读取（普通文件时为true，命名管道时为false）
+    extern const csmFloat32 LipSyncStreamMaxLatencySeconds; ///< 实时口型同步的最大缓冲延迟[秒]
+    extern const csmFloat32 LipSyncStreamBufferSeconds; ///< 实时口型同步环形缓冲区的长度[秒]
+
     // 显示调试用日志
     extern const csmBool DebugLogEnable;            ///< 调试用日志显示的启用/禁用
     extern const csmBool DebugTouchLogEnable;       ///< 触摸处理的调试用日志显示的启用/禁用
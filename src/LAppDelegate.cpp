@@ -14,6 +14,13 @@
 #include "LAppDefine.hpp"
 #include "LAppLive2DManager.hpp"
 #include "LAppTextureManager.hpp"
+#include "LAppModelRegistry.hpp"
+#include "LAppTaskPool.hpp"
+#include "LAppAudioKernel.hpp"
+#include "LAppImageKernel.hpp"
+#include "LAppLoadTracer.hpp"
+#include "LAppVoiceCache.hpp"
+#include "LAppWindowState.hpp"
 
 /*
 这段代码的含义如下：
@@ -117,33 +124,60 @@ bool LAppDelegate::Initialize()
     glfwSetMouseButtonCallback(_window, EventHandler::OnMouseCallBack);
     glfwSetCursorPosCallback(_window, EventHandler::OnMouseCallBack);
 
-    // 记录窗口大小
-    int width, height;
-    glfwGetWindowSize(LAppDelegate::GetInstance()->GetWindow(), &width, &height);
-    _windowWidth = width;
-    _windowHeight = height;
+    // 记录窗口大小。之后只在尺寸变化的回调中更新
+    LAppWindowState* windowState = LAppWindowState::GetInstance();
+    windowState->Attach(_window);
+    _windowRevision = windowState->GetRevision();
 
     // 初始化 AppView
     _view->Initialize();
 
+    // 启动工作线程。之后在任何线程上调用GetInstance都只返回已创建的实例
+    LAppTaskPool::GetInstance();
+
     // 初始化 Cubism SDK
     InitializeCubism();
 
+    // 预乘处理的基准测试
+    if (ImageKernelBenchmarkEnable)
+    {
+        LAppImageKernel::RunBenchmark(4096, 4096, 5);
+    }
+
+    // 口型同步平方和的基准测试
+    if (AudioKernelBenchmarkEnable)
+    {
+        LAppAudioKernel::RunBenchmark(1024 * 1024, 20);
+    }
+
     return GL_TRUE;
 }
 
 void LAppDelegate::Release()
 {
+    // 模型和视图向纹理管理器归还纹理，需在OpenGL上下文销毁之前释放
+    LAppLive2DManager::ReleaseInstance();
+    LAppModelRegistry::ReleaseInstance();
+    LAppVoiceCache::ReleaseInstance();
+
+    delete _view;
+    delete _textureManager;
+
     // 删除窗口
     glfwDestroyWindow(_window);
+    LAppWindowState::ReleaseInstance();
 
     glfwTerminate();
 
-    delete _textureManager;
-    delete _view;
+    // 结束工作线程
+    LAppTaskPool::ReleaseInstance();
 
-    // 释放资源
-    LAppLive2DManager::ReleaseInstance();
+    // 输出加载时间的汇总和Chrome trace
+    if (LoadTraceEnable)
+    {
+        LAppLoadTracer::PrintSummary();
+        LAppLoadTracer::WriteChromeTrace(LoadTraceFilePath);
+    }
 
     // 释放 Cubism SDK
     CubismFramework::Dispose();
@@ -154,20 +188,19 @@ void LAppDelegate::Run()
     // 主循环
     while (glfwWindowShouldClose(_window) == GL_FALSE && !_isEnd)
     {
-        int width, height;
-        glfwGetWindowSize(LAppDelegate::GetInstance()->GetWindow(), &width, &height);
-        if ((_windowWidth != width || _windowHeight != height) && width > 0 && height > 0)
+        // 窗口尺寸在glfwPollEvents的回调中更新，这里只比较修订号
+        LAppWindowState* windowState = LAppWindowState::GetInstance();
+        if (windowState->GetRevision() != _windowRevision && !windowState->IsEmpty())
         {
             // 初始化 AppView
             _view->Initialize();
             // 重新设置精灵大小
             _view->ResizeSprite();
-            // 保存大小
-            _windowWidth = width;
-            _windowHeight = height;
+            // 保存修订号
+            _windowRevision = windowState->GetRevision();
 
             // 修改视口
-            glViewport(0, 0, width, height);
+            glViewport(0, 0, windowState->GetWidth(), windowState->GetHeight());
         }
 
         // 更新时间
@@ -181,6 +214,9 @@ void LAppDelegate::Run()
         // 更新绘制
         _view->Render();
 
+        // 超出显存预算时淘汰本帧未绘制的纹理
+        _textureManager->EndFrame();
+
         // 交换缓冲
         glfwSwapBuffers(_window);
 
@@ -200,8 +236,7 @@ LAppDelegate::LAppDelegate() :
     _mouseX(0.0f),
     _mouseY(0.0f),
     _isEnd(false),
-    _windowWidth(0),
-    _windowHeight(0)
+    _windowRevision(0)
 {
     _view = new LAppView();
     _textureManager = new LAppTextureManager();
@@ -158,8 +158,7 @@ private:
     bool _isEnd;                                 ///< APP是否结束
     LAppTextureManager* _textureManager;         ///< 纹理管理器
 
-    int _windowWidth;                            ///< Initialize函数设置的窗口宽度
-    int _windowHeight;                           ///< Initialize函数设置的窗口高度
+    Csm::csmUint32 _windowRevision;              ///< 最后一次布局时的窗口尺寸修订号
 };
 
 class EventHandler
@@ -0,0 +1,295 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppFileWatcher.hpp"
+#include "LAppBundle.hpp"
+#include "LAppDefine.hpp"
+#include "LAppPal.hpp"
+#ifdef _WIN32
+#include <Windows.h>
+#elif defined(__linux__)
+#include <dirent.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace Csm;
+using namespace LAppDefine;
+
+namespace
+{
+    // 停止请求的检查间隔[毫秒]（inotify）
+    const int PollIntervalMilliseconds = 100;
+}
+
+LAppFileWatcher::LAppFileWatcher()
+    : _stopping(false)
+#ifdef _WIN32
+    , _directoryHandle(INVALID_HANDLE_VALUE)
+    , _stopEvent(NULL)
+#else
+    , _inotifyFd(-1)
+#endif
+{
+}
+
+LAppFileWatcher::~LAppFileWatcher()
+{
+    Stop();
+}
+
+csmBool LAppFileWatcher::Start(const std::string& directory)
+{
+    Stop();
+
+    _directory = LAppBundle::NormalizePath(directory);
+    if (!_directory.empty() && _directory[_directory.size() - 1] != '/')
+    {
+        _directory += "/";
+    }
+
+#ifdef _WIN32
+    _directoryHandle = CreateFileA(_directory.c_str(), FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+    if (_directoryHandle == INVALID_HANDLE_VALUE)
+    {
+        LAppPal::PrintLog("[APP]failed to watch directory: %s", _directory.c_str());
+        return false;
+    }
+    _stopEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+#elif defined(__linux__)
+    _inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_inotifyFd < 0)
+    {
+        LAppPal::PrintLog("[APP]failed to watch directory: %s", _directory.c_str());
+        return false;
+    }
+    AddWatchRecursive("");
+#else
+    return false;
+#endif
+
+    if (DebugLogEnable)
+    {
+        LAppPal::PrintLog("[APP]watch directory: %s", _directory.c_str());
+    }
+
+    _stopping = false;
+    _thread = std::thread(&LAppFileWatcher::WatchMain, this);
+
+    return true;
+}
+
+void LAppFileWatcher::Stop()
+{
+    if (!_thread.joinable())
+    {
+        return;
+    }
+
+    _stopping = true;
+#ifdef _WIN32
+    SetEvent(_stopEvent);
+#endif
+    _thread.join();
+
+#ifdef _WIN32
+    CloseHandle(_stopEvent);
+    CloseHandle(_directoryHandle);
+    _stopEvent = NULL;
+    _directoryHandle = INVALID_HANDLE_VALUE;
+#elif defined(__linux__)
+    close(_inotifyFd);
+    _inotifyFd = -1;
+    _watchDirectories.clear();
+#endif
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _changes.clear();
+}
+
+csmBool LAppFileWatcher::IsWatching() const
+{
+    return _thread.joinable();
+}
+
+void LAppFileWatcher::TakeChangedFiles(std::vector<std::string>& outFiles)
+{
+    const Clock::time_point settled = Clock::now() - std::chrono::milliseconds(static_cast<long long>(HotReloadSettleSeconds * 1000.0f));
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (std::map<std::string, Clock::time_point>::iterator it = _changes.begin(); it != _changes.end();)
+    {
+        if (it->second <= settled)
+        {
+            outFiles.push_back(it->first);
+            _changes.erase(it++);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void LAppFileWatcher::RecordChange(const std::string& relativePath)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _changes[LAppBundle::NormalizePath(relativePath)] = Clock::now();
+}
+
+#ifdef _WIN32
+
+void LAppFileWatcher::WatchMain()
+{
+    OVERLAPPED overlapped = {};
+    overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+
+    // FILE_NOTIFY_INFORMATION需要DWORD对齐
+    std::vector<DWORD> buffer(16 * 1024);
+
+    while (!_stopping)
+    {
+        ResetEvent(overlapped.hEvent);
+        if (!ReadDirectoryChangesW(_directoryHandle, &buffer[0], static_cast<DWORD>(buffer.size() * sizeof(DWORD)), TRUE,
+            FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE, NULL, &overlapped, NULL))
+        {
+            break;
+        }
+
+        HANDLE events[2] = { overlapped.hEvent, _stopEvent };
+        if (WaitForMultipleObjects(2, events, FALSE, INFINITE) != WAIT_OBJECT_0)
+        {
+            DWORD ignored;
+            CancelIo(_directoryHandle);
+            GetOverlappedResult(_directoryHandle, &overlapped, &ignored, TRUE);
+            break;
+        }
+
+        DWORD bytes = 0;
+        if (!GetOverlappedResult(_directoryHandle, &overlapped, &bytes, FALSE) || bytes == 0)
+        {
+            // 缓冲区溢出时丢失本次的通知
+            continue;
+        }
+
+        const BYTE* cursor = reinterpret_cast<const BYTE*>(&buffer[0]);
+        for (;;)
+        {
+            const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(cursor);
+            if (info->Action != FILE_ACTION_REMOVED && info->Action != FILE_ACTION_RENAMED_OLD_NAME)
+            {
+                const int nameLength = static_cast<int>(info->FileNameLength / sizeof(WCHAR));
+                const int size = WideCharToMultiByte(CP_UTF8, 0, info->FileName, nameLength, NULL, 0, NULL, NULL);
+                std::string name(size, '\0');
+                WideCharToMultiByte(CP_UTF8, 0, info->FileName, nameLength, &name[0], size, NULL, NULL);
+                RecordChange(name);
+            }
+
+            if (info->NextEntryOffset == 0)
+            {
+                break;
+            }
+            cursor += info->NextEntryOffset;
+        }
+    }
+
+    CloseHandle(overlapped.hEvent);
+}
+
+#elif defined(__linux__)
+
+void LAppFileWatcher::AddWatchRecursive(const std::string& relativeDirectory)
+{
+    const std::string path = _directory + relativeDirectory;
+    const int wd = inotify_add_watch(_inotifyFd, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (wd < 0)
+    {
+        return;
+    }
+    _watchDirectories[wd] = relativeDirectory;
+
+    DIR* dir = opendir(path.c_str());
+    if (dir == NULL)
+    {
+        return;
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        const std::string name = entry->d_name;
+        if (entry->d_type == DT_DIR && name != "." && name != "..")
+        {
+            AddWatchRecursive(relativeDirectory + name + "/");
+        }
+    }
+    closedir(dir);
+}
+
+void LAppFileWatcher::WatchMain()
+{
+    // inotify_event需要对齐
+    std::vector<long> buffer(4096);
+
+    while (!_stopping)
+    {
+        struct pollfd pfd = { _inotifyFd, POLLIN, 0 };
+        if (poll(&pfd, 1, PollIntervalMilliseconds) <= 0)
+        {
+            continue;
+        }
+
+        const ssize_t length = read(_inotifyFd, &buffer[0], buffer.size() * sizeof(long));
+        if (length <= 0)
+        {
+            continue;
+        }
+
+        const char* cursor = reinterpret_cast<const char*>(&buffer[0]);
+        const char* end = cursor + length;
+        while (cursor < end)
+        {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(cursor);
+            cursor += sizeof(struct inotify_event) + event->len;
+
+            std::map<int, std::string>::const_iterator it = _watchDirectories.find(event->wd);
+            if (it == _watchDirectories.end() || event->len == 0)
+            {
+                continue;
+            }
+
+            const std::string relativePath = it->second + event->name;
+            if (event->mask & IN_ISDIR)
+            {
+                // 新建的子目录也加入监视
+                if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                {
+                    AddWatchRecursive(relativePath + "/");
+                }
+            }
+            else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+            {
+                RecordChange(relativePath);
+            }
+        }
+    }
+}
+
+#else
+
+void LAppFileWatcher::WatchMain()
+{
+}
+
+void LAppFileWatcher::AddWatchRecursive(const std::string&)
+{
+}
+
+#endif
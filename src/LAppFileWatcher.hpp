@@ -0,0 +1,104 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <CubismFramework.hpp>
+
+ /**
+ * @brief 文件变更监视器
+ *
+ * 在后台线程上监视目录（包括子目录）中的文件变更，供热重载使用。
+ *
+ 这段代码定义了一个名为LAppFileWatcher的类，用于在编辑素材时检测文件的变更。
+
+Windows上使用ReadDirectoryChangesW，Linux上使用inotify，其他平台上Start返回false。
+编辑器保存时常会连续写入多次，因此变更后经过一段稳定时间（HotReloadSettleSeconds）才报告。
+
+Start：开始监视指定目录。已在监视时先停止。
+Stop：停止监视。
+IsWatching：判断是否正在监视。
+TakeChangedFiles：取出已稳定的变更文件（相对于监视目录的路径，分隔符为'/'）。在主线程上每帧调用。
+ */
+class LAppFileWatcher
+{
+public:
+    /**
+    * @brief 构造函数
+    */
+    LAppFileWatcher();
+
+    /**
+    * @brief 析构函数。停止监视
+    */
+    ~LAppFileWatcher();
+
+    /**
+    * @brief 开始监视目录
+    *
+    * @param[in]   directory   监视的目录（包括子目录）
+    * @return                  开始成功时返回true
+    */
+    Csm::csmBool Start(const std::string& directory);
+
+    /**
+    * @brief 停止监视
+    */
+    void Stop();
+
+    /**
+    * @brief 判断是否正在监视
+    */
+    Csm::csmBool IsWatching() const;
+
+    /**
+    * @brief 取出已稳定的变更文件
+    *
+    * @param[out]  outFiles    变更的文件（相对于监视目录的路径）
+    */
+    void TakeChangedFiles(std::vector<std::string>& outFiles);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+    * @brief 监视线程的主循环
+    */
+    void WatchMain();
+
+    /**
+    * @brief 记录变更的文件（在监视线程上调用）
+    */
+    void RecordChange(const std::string& relativePath);
+
+#ifndef _WIN32
+    /**
+    * @brief 为目录及其子目录添加inotify监视
+    */
+    void AddWatchRecursive(const std::string& relativeDirectory);
+#endif
+
+    std::string _directory;                                 ///< 监视的目录（以'/'结尾）
+    std::thread _thread;                                    ///< 监视线程
+    std::atomic<bool> _stopping;                            ///< 是否请求停止
+    std::mutex _mutex;                                      ///< 保护_changes
+    std::map<std::string, Clock::time_point> _changes;      ///< 变更的文件和最后变更的时间
+#ifdef _WIN32
+    void* _directoryHandle;                                 ///< 监视目录的句柄
+    void* _stopEvent;                                       ///< 停止请求的事件
+#else
+    int _inotifyFd;                                         ///< inotify的文件描述符
+    std::map<int, std::string> _watchDirectories;           ///< 监视描述符到相对目录的映射
+#endif
+};
@@ -0,0 +1,290 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppImageKernel.hpp"
+#include <chrono>
+#include <cstring>
+#include <vector>
+#include "LAppPal.hpp"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define LAPP_IMAGE_KERNEL_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define LAPP_IMAGE_KERNEL_TARGET(isa)
+#else
+#define LAPP_IMAGE_KERNEL_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+using namespace Csm;
+
+namespace
+{
+    void PremultiplyScalar(csmUint8* rgba, csmSizeInt pixelCount)
+    {
+        for (csmSizeInt i = 0; i < pixelCount; i++)
+        {
+            csmUint8* p = rgba + i * 4;
+            const csmUint32 alpha = p[3] + 1;
+            p[0] = static_cast<csmUint8>(p[0] * alpha >> 8);
+            p[1] = static_cast<csmUint8>(p[1] * alpha >> 8);
+            p[2] = static_cast<csmUint8>(p[2] * alpha >> 8);
+        }
+    }
+
+#ifdef LAPP_IMAGE_KERNEL_X86
+    // 展开为16位后乘以(a + 1)再右移8位。最大值255 * 256在16位内，与标量实现逐位一致
+    LAPP_IMAGE_KERNEL_TARGET("sse2")
+    void PremultiplySse2(csmUint8* rgba, csmSizeInt pixelCount)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi16(1);
+        const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+        csmSizeInt i = 0;
+        for (; i + 4 <= pixelCount; i += 4)
+        {
+            __m128i* p = reinterpret_cast<__m128i*>(rgba + i * 4);
+            const __m128i pixels = _mm_loadu_si128(p);
+
+            __m128i lo = _mm_unpacklo_epi8(pixels, zero);
+            __m128i hi = _mm_unpackhi_epi8(pixels, zero);
+            const __m128i alphaLo = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0xFF), 0xFF), one);
+            const __m128i alphaHi = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0xFF), 0xFF), one);
+            lo = _mm_srli_epi16(_mm_mullo_epi16(lo, alphaLo), 8);
+            hi = _mm_srli_epi16(_mm_mullo_epi16(hi, alphaHi), 8);
+
+            const __m128i result = _mm_packus_epi16(lo, hi);
+            _mm_storeu_si128(p, _mm_or_si128(_mm_andnot_si128(alphaMask, result), _mm_and_si128(alphaMask, pixels)));
+        }
+
+        PremultiplyScalar(rgba + i * 4, pixelCount - i);
+    }
+
+    // 与SSE2版相同的处理，一次8个像素（unpack/shuffle/pack都在128位通道内进行，顺序保持不变）
+    LAPP_IMAGE_KERNEL_TARGET("avx2")
+    void PremultiplyAvx2(csmUint8* rgba, csmSizeInt pixelCount)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi16(1);
+        const __m256i alphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+
+        csmSizeInt i = 0;
+        for (; i + 8 <= pixelCount; i += 8)
+        {
+            __m256i* p = reinterpret_cast<__m256i*>(rgba + i * 4);
+            const __m256i pixels = _mm256_loadu_si256(p);
+
+            __m256i lo = _mm256_unpacklo_epi8(pixels, zero);
+            __m256i hi = _mm256_unpackhi_epi8(pixels, zero);
+            const __m256i alphaLo = _mm256_add_epi16(_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(lo, 0xFF), 0xFF), one);
+            const __m256i alphaHi = _mm256_add_epi16(_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(hi, 0xFF), 0xFF), one);
+            lo = _mm256_srli_epi16(_mm256_mullo_epi16(lo, alphaLo), 8);
+            hi = _mm256_srli_epi16(_mm256_mullo_epi16(hi, alphaHi), 8);
+
+            const __m256i result = _mm256_packus_epi16(lo, hi);
+            _mm256_storeu_si256(p, _mm256_or_si256(_mm256_andnot_si256(alphaMask, result), _mm256_and_si256(alphaMask, pixels)));
+        }
+
+        PremultiplyScalar(rgba + i * 4, pixelCount - i);
+    }
+
+    // 检查CPU和操作系统是否支持SSE2、AVX2
+    void DetectCpuFeatures(csmBool* outSse2, csmBool* outAvx2)
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+
+        __cpuid(info, 1);
+        *outSse2 = (info[3] & (1 << 26)) != 0;
+        const csmBool osxsave = (info[2] & (1 << 27)) != 0;
+        const csmBool avx = (info[2] & (1 << 28)) != 0;
+
+        // OS需保存YMM寄存器
+        csmBool ymmEnabled = false;
+        if (osxsave && avx)
+        {
+            ymmEnabled = (_xgetbv(0) & 6) == 6;
+        }
+
+        *outAvx2 = false;
+        if (ymmEnabled && maxLeaf >= 7)
+        {
+            __cpuidex(info, 7, 0);
+            *outAvx2 = (info[1] & (1 << 5)) != 0;
+        }
+#else
+        __builtin_cpu_init();
+        *outSse2 = __builtin_cpu_supports("sse2") != 0;
+        *outAvx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+    }
+#endif
+
+    struct CpuFeatures
+    {
+        csmBool supported[LAppImageKernel::Kernel_Count];
+
+        CpuFeatures()
+        {
+            supported[LAppImageKernel::Kernel_Scalar] = true;
+            supported[LAppImageKernel::Kernel_Sse2] = false;
+            supported[LAppImageKernel::Kernel_Avx2] = false;
+#ifdef LAPP_IMAGE_KERNEL_X86
+            DetectCpuFeatures(&supported[LAppImageKernel::Kernel_Sse2], &supported[LAppImageKernel::Kernel_Avx2]);
+#endif
+        }
+    };
+
+    // 在main之前检测一次，之后只读取
+    const CpuFeatures s_cpuFeatures;
+
+    csmUint32 s_randomState = 0x12345678;
+
+    csmUint32 NextRandom()
+    {
+        s_randomState ^= s_randomState << 13;
+        s_randomState ^= s_randomState >> 17;
+        s_randomState ^= s_randomState << 5;
+        return s_randomState;
+    }
+}
+
+LAppImageKernel::Kernel LAppImageKernel::GetBestKernel()
+{
+    if (s_cpuFeatures.supported[Kernel_Avx2])
+    {
+        return Kernel_Avx2;
+    }
+    if (s_cpuFeatures.supported[Kernel_Sse2])
+    {
+        return Kernel_Sse2;
+    }
+    return Kernel_Scalar;
+}
+
+csmBool LAppImageKernel::IsKernelSupported(Kernel kernel)
+{
+    return kernel >= 0 && kernel < Kernel_Count && s_cpuFeatures.supported[kernel];
+}
+
+const csmChar* LAppImageKernel::GetKernelName(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case Kernel_Sse2:
+        return "sse2";
+    case Kernel_Avx2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+void LAppImageKernel::PremultiplyAlpha(csmUint8* rgba, csmSizeInt pixelCount)
+{
+    PremultiplyAlpha(GetBestKernel(), rgba, pixelCount);
+}
+
+void LAppImageKernel::PremultiplyAlpha(Kernel kernel, csmUint8* rgba, csmSizeInt pixelCount)
+{
+    if (!IsKernelSupported(kernel))
+    {
+        kernel = Kernel_Scalar;
+    }
+
+    switch (kernel)
+    {
+#ifdef LAPP_IMAGE_KERNEL_X86
+    case Kernel_Sse2:
+        PremultiplySse2(rgba, pixelCount);
+        break;
+    case Kernel_Avx2:
+        PremultiplyAvx2(rgba, pixelCount);
+        break;
+#endif
+    default:
+        PremultiplyScalar(rgba, pixelCount);
+        break;
+    }
+}
+
+void LAppImageKernel::DownsampleBox(const csmUint8* src, csmUint32 srcWidth, csmUint32 srcHeight,
+    csmUint8* dst, csmUint32 dstWidth, csmUint32 dstHeight)
+{
+    for (csmUint32 y = 0; y < dstHeight; y++)
+    {
+        const csmUint32 y0 = y * 2 < srcHeight ? y * 2 : srcHeight - 1;
+        const csmUint32 y1 = y * 2 + 1 < srcHeight ? y * 2 + 1 : srcHeight - 1;
+        for (csmUint32 x = 0; x < dstWidth; x++)
+        {
+            const csmUint32 x0 = x * 2 < srcWidth ? x * 2 : srcWidth - 1;
+            const csmUint32 x1 = x * 2 + 1 < srcWidth ? x * 2 + 1 : srcWidth - 1;
+            const csmUint8* p00 = src + (y0 * srcWidth + x0) * 4;
+            const csmUint8* p01 = src + (y0 * srcWidth + x1) * 4;
+            const csmUint8* p10 = src + (y1 * srcWidth + x0) * 4;
+            const csmUint8* p11 = src + (y1 * srcWidth + x1) * 4;
+            csmUint8* out = dst + (y * dstWidth + x) * 4;
+            for (csmUint32 c = 0; c < 4; c++)
+            {
+                out[c] = static_cast<csmUint8>((p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4);
+            }
+        }
+    }
+}
+
+void LAppImageKernel::RunBenchmark(csmUint32 width, csmUint32 height, csmUint32 iterations)
+{
+    const csmSizeInt pixelCount = static_cast<csmSizeInt>(width) * height;
+    // 加上奇数个像素，同时覆盖尾部的标量处理
+    const csmSizeInt testPixelCount = pixelCount + 3;
+
+    std::vector<csmUint8> source(testPixelCount * 4);
+    for (csmSizeInt i = 0; i < source.size(); i++)
+    {
+        source[i] = static_cast<csmUint8>(NextRandom() >> 24);
+    }
+
+    std::vector<csmUint8> expected(source);
+    PremultiplyScalar(&expected[0], testPixelCount);
+
+    std::vector<csmUint8> work(source.size());
+    for (csmInt32 kernel = 0; kernel < Kernel_Count; kernel++)
+    {
+        const Kernel current = static_cast<Kernel>(kernel);
+        if (!IsKernelSupported(current))
+        {
+            LAppPal::PrintLog("[APP]premultiply %-6s : not supported", GetKernelName(current));
+            continue;
+        }
+
+        double bestMilliseconds = 0.0;
+        csmBool exact = true;
+        for (csmUint32 i = 0; i < iterations; i++)
+        {
+            memcpy(&work[0], &source[0], source.size());
+
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            PremultiplyAlpha(current, &work[0], testPixelCount);
+            const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            if (i == 0 || milliseconds < bestMilliseconds)
+            {
+                bestMilliseconds = milliseconds;
+            }
+            exact = exact && memcmp(&work[0], &expected[0], work.size()) == 0;
+        }
+
+        LAppPal::PrintLog("[APP]premultiply %-6s : %ux%u %.2f ms (best of %u)%s", GetKernelName(current), width, height,
+            bestMilliseconds, iterations, exact ? "" : " MISMATCH");
+    }
+}
@@ -0,0 +1,102 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+
+ /**
+ * @brief 图像处理内核
+ *
+ * 纹理读取时对RGBA8像素进行的逐像素处理。
+ *
+ 这段代码定义了一个名为LAppImageKernel的类（静态类），集中了纹理读取时的像素处理。
+
+预乘处理有标量、SSE2和AVX2三种实现，启动时根据CPU选择最快的一种。
+所有实现的结果与LAppTextureManager::Premultiply逐位一致（c * (a + 1) >> 8，Alpha保持不变）。
+
+Kernel：内核的种类。
+GetBestKernel：获取当前CPU可用的最快内核。
+IsKernelSupported：判断当前CPU能否执行指定的内核。
+GetKernelName：获取内核的名称（日志用）。
+PremultiplyAlpha：对RGBA8像素进行预乘处理。
+DownsampleBox：用2x2盒式滤波生成下一级mip。
+RunBenchmark：对各内核的预乘处理计时并校验结果，输出到日志（ImageKernelBenchmarkEnable为true时启动时执行）。
+ */
+class LAppImageKernel
+{
+public:
+    /**
+    * @brief 内核的种类
+    */
+    enum Kernel
+    {
+        Kernel_Scalar,  ///< 标量实现（所有平台）
+        Kernel_Sse2,    ///< SSE2（x86/x64）
+        Kernel_Avx2,    ///< AVX2（x86/x64）
+        Kernel_Count
+    };
+
+    /**
+    * @brief 获取当前CPU可用的最快内核
+    */
+    static Kernel GetBestKernel();
+
+    /**
+    * @brief 判断当前CPU能否执行指定的内核
+    */
+    static Csm::csmBool IsKernelSupported(Kernel kernel);
+
+    /**
+    * @brief 获取内核的名称
+    */
+    static const Csm::csmChar* GetKernelName(Kernel kernel);
+
+    /**
+    * @brief 用最快的内核对RGBA8像素进行预乘处理
+    *
+    * @param[in,out]   rgba        RGBA8像素
+    * @param[in]       pixelCount  像素数
+    */
+    static void PremultiplyAlpha(Csm::csmUint8* rgba, Csm::csmSizeInt pixelCount);
+
+    /**
+    * @brief 用指定的内核对RGBA8像素进行预乘处理
+    *
+    * @param[in]       kernel      内核的种类。当前CPU不支持时使用标量实现
+    * @param[in,out]   rgba        RGBA8像素
+    * @param[in]       pixelCount  像素数
+    */
+    static void PremultiplyAlpha(Kernel kernel, Csm::csmUint8* rgba, Csm::csmSizeInt pixelCount);
+
+    /**
+    * @brief 用2x2盒式滤波生成下一级mip
+    *
+    * 奇数尺寸时边缘像素重复使用。dst可以与src相同（原地缩小），
+    * 每个输出像素只读取不早于自身位置的源像素。
+    *
+    * @param[in]   src         源图像的RGBA8像素
+    * @param[in]   srcWidth    源图像的宽度
+    * @param[in]   srcHeight   源图像的高度
+    * @param[out]  dst         输出的RGBA8像素
+    * @param[in]   dstWidth    输出的宽度
+    * @param[in]   dstHeight   输出的高度
+    */
+    static void DownsampleBox(const Csm::csmUint8* src, Csm::csmUint32 srcWidth, Csm::csmUint32 srcHeight,
+        Csm::csmUint8* dst, Csm::csmUint32 dstWidth, Csm::csmUint32 dstHeight);
+
+    /**
+    * @brief 对各内核的预乘处理计时并校验结果
+    *
+    * 对随机生成的图像分别执行各内核，输出最短耗时和与标量实现的结果是否一致。
+    *
+    * @param[in]   width       图像宽度
+    * @param[in]   height      图像高度
+    * @param[in]   iterations  每个内核的执行次数
+    */
+    static void RunBenchmark(Csm::csmUint32 width, Csm::csmUint32 height, Csm::csmUint32 iterations);
+};
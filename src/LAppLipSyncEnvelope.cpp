@@ -0,0 +1,275 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppLipSyncEnvelope.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include "LAppDefine.hpp"
+#include "LAppLoadTracer.hpp"
+#include "LAppPal.hpp"
+#include "LAppWavFileHandler.hpp"
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+using namespace Csm;
+using namespace LAppDefine;
+
+namespace
+{
+    const csmUint32 EnvelopeMagic = 0x4544324C; // "L2DE"
+    const csmUint32 EnvelopeVersion = 2;
+
+    /**
+    * @brief 包络文件头（之后依次为wav的路径和frameCount字节的RMS）
+    */
+    struct EnvelopeHeader
+    {
+        csmUint32 magic;
+        csmUint32 version;
+        csmUint32 frameRate;
+        csmUint32 frameCount;
+        csmUint64 sourceSize;
+        csmUint64 sourceModifiedTime;
+        csmUint32 pathLength;
+        csmUint32 reserved;
+    };
+
+    std::once_flag s_directoryOnce;
+    std::atomic<csmUint32> s_tempCounter(0);
+
+    // 与纹理缓存相同，以wav路径的哈希命名并保存在缓存目录中（不写入热重载监视的素材目录）
+    std::string GetEnvelopePath(const std::string& wavPath)
+    {
+        return std::string(LipSyncEnvelopeDirectory) + LAppPal::MakeCacheFileName(wavPath) + ".l2de";
+    }
+
+    void CreateEnvelopeDirectory()
+    {
+        LAppPal::MakeDirectory(LipSyncEnvelopeDirectory);
+    }
+
+    csmBool ReadEnvelope(const std::string& path, const std::string& wavPath, const LAppPal::FileStamp& stamp,
+        csmUint32 frameRate, std::vector<csmUint8>* outFrames)
+    {
+        std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+        if (!file.is_open())
+        {
+            return false;
+        }
+
+        file.seekg(0, std::ios::end);
+        const csmUint64 fileSize = static_cast<csmUint64>(file.tellg());
+        file.seekg(0, std::ios::beg);
+
+        EnvelopeHeader header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(EnvelopeHeader));
+        if (!file
+            || header.magic != EnvelopeMagic
+            || header.version != EnvelopeVersion
+            || header.frameRate != frameRate
+            || header.sourceSize != stamp.size
+            || header.sourceModifiedTime != stamp.modifiedTime
+            || header.pathLength != wavPath.size())
+        {
+            return false;
+        }
+
+        // 帧数必须与文件的剩余长度一致（文件被截断或损坏时不按文件头的值分配内存）
+        if (sizeof(EnvelopeHeader) + static_cast<csmUint64>(header.pathLength) + header.frameCount != fileSize)
+        {
+            return false;
+        }
+
+        // 哈希冲突时路径不一致
+        std::string sourcePath(header.pathLength, '\0');
+        if (header.pathLength > 0)
+        {
+            file.read(&sourcePath[0], header.pathLength);
+        }
+        if (!file || sourcePath != wavPath)
+        {
+            return false;
+        }
+
+        outFrames->resize(header.frameCount);
+        if (header.frameCount > 0)
+        {
+            file.read(reinterpret_cast<char*>(&(*outFrames)[0]), header.frameCount);
+        }
+        return static_cast<csmUint32>(file.gcount()) == header.frameCount || header.frameCount == 0;
+    }
+
+    // 先写入临时文件再重命名，写入中途失败也不会留下不完整的包络
+    csmBool WriteEnvelope(const std::string& path, const std::string& wavPath, const LAppPal::FileStamp& stamp,
+        csmUint32 frameRate, const std::vector<csmUint8>& frames)
+    {
+        std::call_once(s_directoryOnce, CreateEnvelopeDirectory);
+
+        EnvelopeHeader header;
+        header.magic = EnvelopeMagic;
+        header.version = EnvelopeVersion;
+        header.frameRate = frameRate;
+        header.frameCount = static_cast<csmUint32>(frames.size());
+        header.sourceSize = stamp.size;
+        header.sourceModifiedTime = stamp.modifiedTime;
+        header.pathLength = static_cast<csmUint32>(wavPath.size());
+        header.reserved = 0;
+
+        std::ostringstream tempPath;
+        tempPath << path << ".tmp" << s_tempCounter++;
+
+        std::ofstream file(tempPath.str().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(EnvelopeHeader));
+        file.write(wavPath.c_str(), header.pathLength);
+        if (!frames.empty())
+        {
+            file.write(reinterpret_cast<const char*>(&frames[0]), frames.size());
+        }
+        file.close();
+
+        if (file.fail())
+        {
+            std::remove(tempPath.str().c_str());
+            return false;
+        }
+
+#ifdef _WIN32
+        const csmBool renamed = MoveFileExA(tempPath.str().c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        const csmBool renamed = std::rename(tempPath.str().c_str(), path.c_str()) == 0;
+#endif
+        if (!renamed)
+        {
+            std::remove(tempPath.str().c_str());
+            return false;
+        }
+
+        return true;
+    }
+}
+
+LAppLipSyncEnvelope::LAppLipSyncEnvelope()
+    : _frameRate(LipSyncEnvelopeFrameRate)
+{
+}
+
+csmBool LAppLipSyncEnvelope::Load(const std::string& wavPath)
+{
+    const csmUint32 frameRate = LipSyncEnvelopeFrameRate;
+
+    // 素材包内的wav没有磁盘上的标识，每次在内存中烘焙
+    LAppPal::FileStamp stamp;
+    const csmBool onDisk = LAppPal::GetFileStamp(wavPath, &stamp);
+    const std::string envelopePath = GetEnvelopePath(wavPath);
+
+    if (onDisk)
+    {
+        LAppLoadTracer::Scope trace("lipsync_envelope_read", wavPath.c_str());
+        std::vector<csmUint8> frames;
+        if (ReadEnvelope(envelopePath, wavPath, stamp, frameRate, &frames))
+        {
+            _frames.swap(frames);
+            _frameRate = frameRate;
+            trace.SetBytes(static_cast<csmSizeInt>(_frames.size()));
+            return true;
+        }
+    }
+
+    if (!Bake(wavPath, frameRate))
+    {
+        return false;
+    }
+
+    if (onDisk && !WriteEnvelope(envelopePath, wavPath, stamp, _frameRate, _frames))
+    {
+        if (DebugLogEnable)
+        {
+            LAppPal::PrintLog("[APP]lip-sync envelope write error: %s", envelopePath.c_str());
+        }
+    }
+
+    return true;
+}
+
+csmBool LAppLipSyncEnvelope::Bake(const std::string& wavPath, csmUint32 frameRate)
+{
+    LAppLoadTracer::Scope trace("lipsync_envelope_bake", wavPath.c_str());
+
+    LAppWavFileHandler wavFileHandler;
+    // 工作线程上调用，不经过语音缓存
+    if (frameRate == 0 || !wavFileHandler.Start(wavPath.c_str(), false))
+    {
+        return false;
+    }
+
+    // 各帧与LAppWavFileHandler::Update相同，计算该区间内所有通道的RMS
+    const csmUint32 samplingRate = wavFileHandler.GetSamplingRate();
+    const csmUint32 sampleCount = wavFileHandler.GetSamplesPerChannel();
+    const csmUint32 frameCount = static_cast<csmUint32>((static_cast<csmUint64>(sampleCount) * frameRate + samplingRate - 1) / samplingRate);
+
+    std::vector<csmUint8> frames(frameCount);
+    for (csmUint32 frame = 0; frame < frameCount; frame++)
+    {
+        const csmUint32 begin = static_cast<csmUint32>(static_cast<csmUint64>(frame) * samplingRate / frameRate);
+        csmUint32 end = static_cast<csmUint32>(static_cast<csmUint64>(frame + 1) * samplingRate / frameRate);
+        if (end > sampleCount)
+        {
+            end = sampleCount;
+        }
+
+        const csmFloat32 rms = wavFileHandler.GetRms(begin, end);
+        const csmInt32 quantized = static_cast<csmInt32>(rms * 255.0f + 0.5f);
+        frames[frame] = static_cast<csmUint8>(quantized > 255 ? 255 : quantized);
+    }
+
+    _frames.swap(frames);
+    _frameRate = frameRate;
+    trace.SetBytes(static_cast<csmSizeInt>(_frames.size()));
+
+    return true;
+}
+
+csmFloat32 LAppLipSyncEnvelope::GetValue(csmFloat32 timeSeconds) const
+{
+    if (_frames.empty() || timeSeconds < 0.0f || timeSeconds >= GetDuration())
+    {
+        return 0.0f;
+    }
+
+    // 每帧的值代表该帧区间的中心
+    const csmFloat32 position = timeSeconds * _frameRate - 0.5f;
+    const csmInt32 lastFrame = static_cast<csmInt32>(_frames.size()) - 1;
+    if (position <= 0.0f)
+    {
+        return _frames[0] / 255.0f;
+    }
+
+    const csmInt32 frame = static_cast<csmInt32>(position);
+    if (frame >= lastFrame)
+    {
+        return _frames[lastFrame] / 255.0f;
+    }
+
+    const csmFloat32 t = position - static_cast<csmFloat32>(frame);
+    return (_frames[frame] + (_frames[frame + 1] - _frames[frame]) * t) / 255.0f;
+}
+
+csmFloat32 LAppLipSyncEnvelope::GetDuration() const
+{
+    return _frameRate > 0 ? static_cast<csmFloat32>(_frames.size()) / _frameRate : 0.0f;
+}
@@ -0,0 +1,81 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <CubismFramework.hpp>
+
+ /**
+ * @brief 口型同步的包络
+ *
+ * 将语音wav预先烘焙为固定帧率的RMS表，播放时只查表。
+ *
+ 这段代码定义了一个名为LAppLipSyncEnvelope的类，代替播放时逐帧扫描PCM计算RMS。
+
+每帧（1 / LipSyncEnvelopeFrameRate秒）的RMS量化为8位保存，100Hz时每分钟语音约6KB。
+烘焙结果以wav路径的哈希命名，写入LipSyncEnvelopeDirectory中的".l2de"文件（不写入素材目录，不触发热重载的监视）。
+文件头记录wav的路径、大小和修改时间，不一致时重新烘焙（编辑wav后自动更新）。素材包内的wav只在内存中烘焙。
+GetValue在相邻两帧的中心之间线性插值，超出语音长度时返回0（与LAppWavFileHandler播放结束后相同）。
+
+Load：读取磁盘上的包络，没有或已过期时从wav烘焙并写入磁盘（可以在工作线程上调用）。
+Bake：从wav烘焙包络。
+GetValue：获取指定时刻的RMS值。
+GetDuration：获取语音的长度[秒]。
+IsEmpty：是否没有包络数据。
+ */
+class LAppLipSyncEnvelope
+{
+public:
+    /**
+    * @brief 构造函数
+    */
+    LAppLipSyncEnvelope();
+
+    /**
+    * @brief 读取或烘焙包络
+    *
+    * @param[in]   wavPath     wav文件的路径
+    * @return                  成功时返回true
+    */
+    Csm::csmBool Load(const std::string& wavPath);
+
+    /**
+    * @brief 从wav烘焙包络
+    *
+    * @param[in]   wavPath     wav文件的路径
+    * @param[in]   frameRate   包络的帧率[Hz]
+    * @return                  成功时返回true
+    */
+    Csm::csmBool Bake(const std::string& wavPath, Csm::csmUint32 frameRate);
+
+    /**
+    * @brief 获取指定时刻的RMS值
+    *
+    * @param[in]   timeSeconds 从语音开始经过的时间[秒]
+    * @return                  0～1的RMS值
+    */
+    Csm::csmFloat32 GetValue(Csm::csmFloat32 timeSeconds) const;
+
+    /**
+    * @brief 获取语音的长度[秒]
+    */
+    Csm::csmFloat32 GetDuration() const;
+
+    /**
+    * @brief 没有包络数据时返回true
+    */
+    Csm::csmBool IsEmpty() const
+    {
+        return _frames.empty();
+    }
+
+private:
+    std::vector<Csm::csmUint8> _frames;    ///< 每帧的RMS（0～255）
+    Csm::csmUint32 _frameRate;             ///< 帧率[Hz]
+};
@@ -0,0 +1,228 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppLipSyncStream.hpp"
+#include <chrono>
+#include <math.h>
+#include "LAppAudioKernel.hpp"
+#include "LAppDefine.hpp"
+#include "LAppPal.hpp"
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+using namespace Csm;
+using namespace LAppDefine;
+
+const csmFloat32 LAppLipSyncStream::HoldSeconds = 0.25f;
+const csmFloat32 LAppLipSyncStream::ProducerBlockSeconds = 0.01f;
+
+LAppLipSyncStream::LAppLipSyncStream(csmUint32 samplingRate, csmUint32 channels, csmFloat32 maxLatencySeconds, csmFloat32 bufferSeconds)
+    : _buffer(static_cast<csmUint32>(bufferSeconds * samplingRate) * channels)
+    , _samplingRate(samplingRate)
+    , _channels(channels)
+    , _maxLatencySamples(static_cast<csmUint32>(maxLatencySeconds * samplingRate) * channels)
+    , _pendingFrames(0.0f)
+    , _rms(0.0f)
+    , _lastRms(0.0f)
+    , _idleSeconds(HoldSeconds)
+    , _receivedSamples(0)
+    , _overflowSamples(0)
+    , _consumedSamples(0)
+    , _skippedSamples(0)
+    , _underrunCount(0)
+    , _latencySeconds(0.0f)
+    , _maxLatencySeconds(0.0f)
+    , _stopping(false)
+    , _producerRunning(false)
+    , _producerFile(NULL)
+    , _producerRealTime(false)
+{
+}
+
+LAppLipSyncStream::~LAppLipSyncStream()
+{
+    StopProducer();
+}
+
+csmUint32 LAppLipSyncStream::Push(const csmInt16* samples, csmUint32 count)
+{
+    // 缓冲区满时不等待消费者，丢弃放不下的样本（音频线程不能阻塞）
+    const csmUint32 written = _buffer.Write(samples, count);
+    _receivedSamples.fetch_add(written, std::memory_order_relaxed);
+    if (written < count)
+    {
+        _overflowSamples.fetch_add(count - written, std::memory_order_relaxed);
+    }
+    return written;
+}
+
+csmBool LAppLipSyncStream::StartFileProducer(const std::string& path, csmBool realTime)
+{
+    StopProducer();
+
+    _producerFile = fopen(path.c_str(), "rb");
+    if (_producerFile == NULL)
+    {
+        LAppPal::PrintLog("[APP]failed to open lip sync stream: %s", path.c_str());
+        return false;
+    }
+
+    if (DebugLogEnable)
+    {
+        LAppPal::PrintLog("[APP]lip sync stream: %s (%u Hz, %u ch)", path.c_str(), _samplingRate, _channels);
+    }
+
+    _producerRealTime = realTime;
+    _stopping = false;
+    _producerRunning = true;
+    _producer = std::thread(&LAppLipSyncStream::ProducerMain, this);
+
+    return true;
+}
+
+void LAppLipSyncStream::StopProducer()
+{
+    if (!_producer.joinable())
+    {
+        return;
+    }
+
+    _stopping = true;
+#ifdef _WIN32
+    // 命名管道的写入方没有数据时fread会一直阻塞，取消读取线程上的同步I/O。
+    // 读取线程尚未进入ReadFile时取消不起作用，因此重复取消直到主循环结束
+    while (_producerRunning)
+    {
+        CancelSynchronousIo(_producer.native_handle());
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+#endif
+    _producer.join();
+
+    fclose(_producerFile);
+    _producerFile = NULL;
+}
+
+void LAppLipSyncStream::ProducerMain()
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const csmUint32 blockFrames = static_cast<csmUint32>(_samplingRate * ProducerBlockSeconds) + 1;
+    std::vector<csmByte> bytes(blockFrames * _channels * sizeof(csmInt16));
+    std::vector<csmInt16> samples(blockFrames * _channels);
+    const Clock::time_point start = Clock::now();
+    csmUint64 pushedFrames = 0;
+
+    while (!_stopping)
+    {
+        const size_t count = fread(&bytes[0], sizeof(csmInt16), samples.size(), _producerFile);
+        if (count == 0)
+        {
+            break; // 文件结束、管道的写入方关闭或被取消
+        }
+
+        // 16位小端有符号整数
+        for (size_t i = 0; i < count; i++)
+        {
+            samples[i] = static_cast<csmInt16>(bytes[i * 2] | (bytes[i * 2 + 1] << 8));
+        }
+        Push(&samples[0], static_cast<csmUint32>(count));
+
+        // 普通文件一次就能读完，按采样率的速度等待到这一块播放结束的时刻
+        pushedFrames += count / _channels;
+        if (_producerRealTime)
+        {
+            std::this_thread::sleep_until(start + std::chrono::microseconds(static_cast<long long>(pushedFrames * 1000000 / _samplingRate)));
+        }
+    }
+
+    _producerRunning = false;
+
+    if (DebugLogEnable)
+    {
+        LAppPal::PrintLog("[APP]lip sync stream ended: %llu samples", static_cast<unsigned long long>(_receivedSamples.load()));
+    }
+}
+
+csmFloat32 LAppLipSyncStream::Update(csmFloat32 deltaTimeSeconds)
+{
+    _pendingFrames += deltaTimeSeconds * _samplingRate;
+    const csmUint32 frames = static_cast<csmUint32>(_pendingFrames);
+    _pendingFrames -= frames;
+    const csmUint32 wanted = frames * _channels;
+    if (wanted == 0)
+    {
+        return _rms;
+    }
+
+    // 超过最大延迟的部分是已经来不及的声音，丢弃最旧的样本，让口型追上当前的声音
+    const csmUint32 readable = _buffer.GetReadableCount();
+    if (readable > wanted + _maxLatencySamples)
+    {
+        _skippedSamples += _buffer.Skip(readable - wanted - _maxLatencySamples);
+    }
+
+    if (_frameSamples.size() < wanted)
+    {
+        _frameSamples.resize(wanted);
+    }
+    const csmUint32 read = _buffer.Read(&_frameSamples[0], wanted);
+
+    if (read > 0)
+    {
+        // 接收中断超过一块、在HoldSeconds内恢复时记为一次欠载（生产者按块写入造成的间隔不计，流结束后的静音也不计）
+        if (_idleSeconds > ProducerBlockSeconds && IsActive())
+        {
+            _underrunCount++;
+        }
+
+        const csmUint64 squares = LAppAudioKernel::SumSquaresPcm16(reinterpret_cast<const csmByte*>(&_frameSamples[0]), read);
+        _rms = static_cast<csmFloat32>(sqrt(squares * LAppAudioKernel::Pcm16SquareScale() / read));
+        _lastRms = _rms;
+        _consumedSamples += read;
+        _idleSeconds = 0.0f;
+    }
+    else
+    {
+        // 一块以内的间隔保持上次的RMS，之后在HoldSeconds内线性减小到0
+        _idleSeconds += deltaTimeSeconds;
+        if (_idleSeconds <= ProducerBlockSeconds)
+        {
+            _rms = _lastRms;
+        }
+        else if (IsActive())
+        {
+            _rms = _lastRms * (HoldSeconds - _idleSeconds) / (HoldSeconds - ProducerBlockSeconds);
+        }
+        else
+        {
+            _rms = 0.0f;
+        }
+    }
+
+    _latencySeconds = static_cast<csmFloat32>(_buffer.GetReadableCount()) / (_samplingRate * _channels);
+    if (_latencySeconds > _maxLatencySeconds)
+    {
+        _maxLatencySeconds = _latencySeconds;
+    }
+
+    return _rms;
+}
+
+LAppLipSyncStream::Statistics LAppLipSyncStream::GetStatistics() const
+{
+    Statistics statistics;
+    statistics.receivedSamples = _receivedSamples.load(std::memory_order_relaxed);
+    statistics.overflowSamples = _overflowSamples.load(std::memory_order_relaxed);
+    statistics.consumedSamples = _consumedSamples;
+    statistics.skippedSamples = _skippedSamples;
+    statistics.underrunCount = _underrunCount;
+    statistics.latencySeconds = _latencySeconds;
+    statistics.maxLatencySeconds = _maxLatencySeconds;
+    return statistics;
+}
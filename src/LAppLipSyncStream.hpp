@@ -0,0 +1,155 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <CubismFramework.hpp>
+#include "LAppPcmRingBuffer.hpp"
+
+ /**
+ * @brief 外部PCM流的实时口型同步
+ *
+ * 从其他线程接收16位PCM，在主线程上每帧计算RMS。
+ *
+ 这段代码定义了一个名为LAppLipSyncStream的类，用于语音合成或麦克风等不经过wav文件的实时口型同步。
+
+生产者（外部音频线程或StartFileProducer启动的读取线程）调用Push把样本写入LAppPcmRingBuffer，不加锁也不阻塞，
+缓冲区满时丢弃放不下的样本并计数。消费者（主线程）每帧调用Update，读取与经过时间相当的样本计算RMS。
+缓冲的样本超过最大延迟时先丢弃最旧的样本，口型与声音的延迟不超过maxLatencySeconds；
+没有样本的帧保持上次的RMS，超过一块（ProducerBlockSeconds）后在HoldSeconds内逐渐减小到0，口型不会因生产者按块写入而每帧开合；
+接收中断超过一块、之后又恢复时记为一次欠载。超过HoldSeconds没有收到样本时IsActive返回false，由动作语音的口型同步接管。
+
+LAppLipSyncStream()/~LAppLipSyncStream()：构造函数（采样率、声道数、最大延迟、缓冲区长度）/析构函数（停止读取线程）。
+Push()：写入交错的PCM样本（生产者线程）。
+StartFileProducer()/StopProducer()：启动/停止从文件或命名管道读取原始PCM（16位小端）的线程。
+Update()：消费经过时间的样本并返回RMS（主线程）。
+GetRms()/IsActive()：获取上次的RMS/是否正在接收样本。
+GetStatistics()：获取延迟、欠载、丢弃的统计信息。
+ */
+class LAppLipSyncStream
+{
+public:
+    /**
+    * @brief 统计信息
+    */
+    struct Statistics
+    {
+        Csm::csmUint64 receivedSamples;     ///< Push写入的样本数
+        Csm::csmUint64 overflowSamples;     ///< 缓冲区满而丢弃的样本数（生产者侧）
+        Csm::csmUint64 consumedSamples;     ///< 用于计算RMS的样本数
+        Csm::csmUint64 skippedSamples;      ///< 超过最大延迟而丢弃的样本数（消费者侧）
+        Csm::csmUint32 underrunCount;       ///< 接收中断后又恢复的次数
+        Csm::csmFloat32 latencySeconds;     ///< 上次Update后缓冲的样本相当的时间[秒]
+        Csm::csmFloat32 maxLatencySeconds;  ///< latencySeconds的最大值[秒]
+    };
+
+    /**
+    * @brief 构造函数
+    *
+    * @param[in]   samplingRate        采样率[Hz]
+    * @param[in]   channels            声道数（样本按声道交错）
+    * @param[in]   maxLatencySeconds   缓冲的最大延迟[秒]
+    * @param[in]   bufferSeconds       环形缓冲区的长度[秒]
+    */
+    LAppLipSyncStream(Csm::csmUint32 samplingRate, Csm::csmUint32 channels, Csm::csmFloat32 maxLatencySeconds, Csm::csmFloat32 bufferSeconds);
+
+    /**
+    * @brief 析构函数。停止读取线程
+    */
+    ~LAppLipSyncStream();
+
+    /**
+    * @brief 写入交错的PCM样本（只能从一个生产者线程调用）
+    *
+    * @param[in]   samples     样本
+    * @param[in]   count       样本数（帧数×声道数）
+    * @return                  实际写入的样本数
+    */
+    Csm::csmUint32 Push(const Csm::csmInt16* samples, Csm::csmUint32 count);
+
+    /**
+    * @brief 启动从文件或命名管道读取原始PCM（16位小端、交错）的线程
+    *         读取线程作为唯一的生产者，启动期间不能从其他线程调用Push。
+    *
+    * @param[in]   path        文件或命名管道的路径
+    * @param[in]   realTime    为true时按采样率的速度写入（读取普通文件时使用）
+    * @return                  打开成功时返回true
+    */
+    Csm::csmBool StartFileProducer(const std::string& path, Csm::csmBool realTime);
+
+    /**
+    * @brief 停止读取线程
+    */
+    void StopProducer();
+
+    /**
+    * @brief 消费经过时间的样本并计算RMS（只能从一个消费者线程调用）
+    *
+    * @param[in]   deltaTimeSeconds    经过时间[秒]
+    * @return                          RMS值（0～1）
+    */
+    Csm::csmFloat32 Update(Csm::csmFloat32 deltaTimeSeconds);
+
+    /**
+    * @brief 获取上次Update计算的RMS值
+    */
+    Csm::csmFloat32 GetRms() const
+    {
+        return _rms;
+    }
+
+    /**
+    * @brief 最近HoldSeconds内读取到样本时返回true
+    */
+    Csm::csmBool IsActive() const
+    {
+        return _idleSeconds < HoldSeconds;
+    }
+
+    /**
+    * @brief 获取统计信息
+    */
+    Statistics GetStatistics() const;
+
+    static const Csm::csmFloat32 HoldSeconds;   ///< 没有样本后仍视为接收中的时间[秒]
+    static const Csm::csmFloat32 ProducerBlockSeconds;  ///< 生产者一次写入的时间[秒]（不超过此时间的中断不视为欠载）
+
+private:
+    /**
+    * @brief 读取线程的主循环
+    */
+    void ProducerMain();
+
+    LAppPcmRingBuffer _buffer;                      ///< 生产者到消费者的样本
+    Csm::csmUint32 _samplingRate;                   ///< 采样率[Hz]
+    Csm::csmUint32 _channels;                       ///< 声道数
+    Csm::csmUint32 _maxLatencySamples;              ///< 最大延迟相当的样本数
+    std::vector<Csm::csmInt16> _frameSamples;       ///< Update读取样本用的缓冲区（复用）
+    Csm::csmFloat32 _pendingFrames;                 ///< 未消费的经过时间相当的帧数（小数部分）
+    Csm::csmFloat32 _rms;                           ///< 上次的RMS值
+    Csm::csmFloat32 _lastRms;                       ///< 最后一次读取到样本时的RMS值（没有样本时由此衰减）
+    Csm::csmFloat32 _idleSeconds;                   ///< 上次读取到样本后经过的时间[秒]
+
+    std::atomic<Csm::csmUint64> _receivedSamples;   ///< Push写入的样本数（生产者修改）
+    std::atomic<Csm::csmUint64> _overflowSamples;   ///< 缓冲区满而丢弃的样本数（生产者修改）
+    Csm::csmUint64 _consumedSamples;                ///< 用于计算RMS的样本数
+    Csm::csmUint64 _skippedSamples;                 ///< 超过最大延迟而丢弃的样本数
+    Csm::csmUint32 _underrunCount;                  ///< 接收中断后又恢复的次数
+    Csm::csmFloat32 _latencySeconds;                ///< 上次Update后的缓冲延迟[秒]
+    Csm::csmFloat32 _maxLatencySeconds;             ///< 缓冲延迟的最大值[秒]
+
+    std::thread _producer;                          ///< 读取线程
+    std::atomic<bool> _stopping;                    ///< 是否请求停止读取线程
+    std::atomic<bool> _producerRunning;             ///< 读取线程的主循环是否仍在执行
+    std::FILE* _producerFile;                       ///< 读取线程读取的文件
+    Csm::csmBool _producerRealTime;                 ///< 读取线程是否按采样率的速度写入
+};
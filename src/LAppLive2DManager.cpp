@@ -6,7 +6,10 @@
  */
 
 #include "LAppLive2DManager.hpp"
+#include <algorithm>
+#include <chrono>
 #include <string>
+#include <vector>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <Rendering/CubismRenderer.hpp>
@@ -15,6 +18,10 @@
 #include "LAppDelegate.hpp"
 #include "LAppModel.hpp"
 #include "LAppView.hpp"
+#include "LAppTaskPool.hpp"
+#include "LAppModelRegistry.hpp"
+#include "LAppTextureManager.hpp"
+#include "LAppWindowState.hpp"
 
 /*
 
@@ -32,6 +39,10 @@ OnTap 函数：处理点击事件，判断点击区域并执行相应操作（
 OnUpdate 函数：更新模型的状态并进行绘制。
 NextScene 函数：切换到下一个场景。
 ChangeScene 函数：根据给定的索引更改场景，加载对应的模型并设置渲染目标。
+ChangeSceneAsync 函数：在工作线程上加载场景，OnUpdate 中逐帧上传纹理，完成后替换模型。
+StartPrefetch 函数：在后台预读下一个场景，NextScene 命中时只需上传纹理。
+UpdateHotReload 函数：重新读取模型目录中变更的素材。
+OnUpdate 中每帧从实时口型同步的PCM流（LipSyncStreamPath）计算一次RMS并设置到各模型。
 GetModelNum 函数：获取当前模型的数量。
 SetViewMatrix 函数：设置视图矩阵。
 
@@ -50,6 +61,29 @@ namespace
     {
         LAppPal::PrintLog("Motion Finished: %x", self);
     }
+
+    // 异步切换完成时的回调函数
+    void SceneLoaded(csmInt32 index, csmBool succeeded)
+    {
+        if (DebugLogEnable)
+        {
+            LAppPal::PrintLog("[APP]scene %d loaded: %s", index, succeeded ? "succeeded" : "failed");
+        }
+    }
+
+    // 创建场景的模型并设置纹理质量（ModelTextureQuality为-1时使用TextureQuality）
+    LAppModel* CreateSceneModel(csmInt32 index)
+    {
+        csmInt32 quality = ModelTextureQuality[index] >= 0 ? ModelTextureQuality[index] : TextureQuality;
+        if (quality > LAppTextureManager::TextureQuality_Quarter)
+        {
+            quality = LAppTextureManager::TextureQuality_Quarter;
+        }
+
+        LAppModel* model = new LAppModel();
+        model->SetTextureQuality(static_cast<LAppTextureManager::TextureQuality>(quality));
+        return model;
+    }
 }
 
 // 获取 LAppLive2DManager 实例
@@ -78,22 +112,88 @@ void LAppLive2DManager::ReleaseInstance()
 LAppLive2DManager::LAppLive2DManager()
     : _viewMatrix(NULL)
     , _sceneIndex(0)
+    , _pending(NULL)
+    , _pendingCallback(NULL)
+    , _requestedSceneIndex(-1)
+    , _requestedCallback(NULL)
+    , _prefetch(NULL)
+    , _prefetchHitCount(0)
+    , _prefetchMissCount(0)
+    , _prefetchOverBudgetCount(0)
+    , _hotReloadScenePending(false)
+    , _lipSyncStream(NULL)
 {
     _viewMatrix = new CubismMatrix44();
 
+    if (LipSyncStreamPath[0] != '\0')
+    {
+        _lipSyncStream = new LAppLipSyncStream(LipSyncStreamSamplingRate, LipSyncStreamChannels, LipSyncStreamMaxLatencySeconds, LipSyncStreamBufferSeconds);
+        _lipSyncStream->StartFileProducer(LipSyncStreamPath, LipSyncStreamRealTime);
+    }
+
     ChangeScene(_sceneIndex);
 }
 
 // LAppLive2DManager 析构函数
 LAppLive2DManager::~LAppLive2DManager()
 {
+    if (_requestedSceneIndex >= 0)
+    {
+        _requestedPromise.set_value(false);
+        _requestedSceneIndex = -1;
+    }
+
+    // 等待工作线程上的加载结束后丢弃
+    if (_pending != NULL)
+    {
+        _pending->prepare.wait();
+        FinishPendingScene(false);
+    }
+    if (_prefetch != NULL)
+    {
+        _prefetch->prepare.wait();
+        DeleteSceneLoad(_prefetch);
+        _prefetch = NULL;
+    }
+    for (size_t i = 0; i < _discardedLoads.size(); i++)
+    {
+        _discardedLoads[i]->prepare.wait();
+        DeleteSceneLoad(_discardedLoads[i]);
+    }
+    _discardedLoads.clear();
+
+    if (DebugLogEnable && ScenePrefetchEnable)
+    {
+        LAppPal::PrintLog("[APP]scene prefetch: hit %d miss %d over budget %d", _prefetchHitCount, _prefetchMissCount, _prefetchOverBudgetCount);
+    }
+
+    if (_lipSyncStream != NULL)
+    {
+        _lipSyncStream->StopProducer();
+        if (DebugLogEnable)
+        {
+            const LAppLipSyncStream::Statistics statistics = _lipSyncStream->GetStatistics();
+            LAppPal::PrintLog("[APP]lip sync stream: received %llu consumed %llu overflow %llu skipped %llu underrun %d max latency %.1f ms",
+                static_cast<unsigned long long>(statistics.receivedSamples), static_cast<unsigned long long>(statistics.consumedSamples),
+                static_cast<unsigned long long>(statistics.overflowSamples), static_cast<unsigned long long>(statistics.skippedSamples),
+                statistics.underrunCount, statistics.maxLatencySeconds * 1000.0f);
+        }
+        delete _lipSyncStream;
+        _lipSyncStream = NULL;
+    }
+
     ReleaseAllModel();
+
+    if (!_mountedModelPath.empty())
+    {
+        LAppPal::UnmountBundle(_mountedModelPath);
+    }
 }
 
 // 释放所有模型
 void LAppLive2DManager::ReleaseAllModel()
 {
-    for (csmUint32 i = 0; i < _models.GetSize(); i++)
+    for (csmInt32 i = 0; i < _models.GetSize(); i++)
     {
         delete _models[i];
     }
@@ -104,7 +204,7 @@ void LAppLive2DManager::ReleaseAllModel()
 // 获取指定编号的模型
 LAppModel* LAppLive2DManager::GetModel(csmUint32 no) const
 {
-    if (no < _models.GetSize())
+    if (no < static_cast<csmUint32>(_models.GetSize()))
     {
         return _models[no];
     }
@@ -115,7 +215,7 @@ LAppModel* LAppLive2DManager::GetModel(csmUint32 no) const
 // 处理拖拽事件
 void LAppLive2DManager::OnDrag(csmFloat32 x, csmFloat32 y) const
 {
-    for (csmUint32 i = 0; i < _models.GetSize(); i++)
+    for (csmInt32 i = 0; i < _models.GetSize(); i++)
     {
         LAppModel* model = GetModel(i);
 
@@ -134,7 +234,7 @@ void LAppLive2DManager::OnTap(csmFloat32 x, csmFloat32 y)
     /*
     * 
     * 暂时忽略点击回调，不会因为点击而播动作
-    for (csmUint32 i = 0; i < _models.GetSize(); i++)
+    for (csmInt32 i = 0; i < _models.GetSize(); i++)
     {
         if (_models[i]->HitTest(HitAreaNameHead, x, y))
         {
@@ -155,14 +255,25 @@ void LAppLive2DManager::OnTap(csmFloat32 x, csmFloat32 y)
     }
     */
 }
-void LAppLive2DManager::OnUpdate() const
+void LAppLive2DManager::OnUpdate()
 {
-    // 缩放屏幕大小？
-    int width, height;
-    glfwGetWindowSize(LAppDelegate::GetInstance()->GetWindow(), &width, &height);
+    UpdatePendingScene();
+    UpdateHotReload();
+
+    // 投影矩阵由LAppWindowState在窗口尺寸变化时计算
+    const LAppWindowState* windowState = LAppWindowState::GetInstance();
+
+    // 实时口型同步的流每帧只消费一次，场景中的所有模型使用同一个值
+    csmBool streamActive = false;
+    csmFloat32 streamRms = 0.0f;
+    if (_lipSyncStream != NULL)
+    {
+        streamRms = _lipSyncStream->Update(LAppPal::GetDeltaTime());
+        streamActive = _lipSyncStream->IsActive();
+    }
 
-    csmUint32 modelCount = _models.GetSize();
-    for (csmUint32 i = 0; i < modelCount; ++i)
+    csmInt32 modelCount = _models.GetSize();
+    for (csmInt32 i = 0; i < modelCount; ++i)
     {
         CubismMatrix44 projection;
         LAppModel* model = GetModel(i);
@@ -173,15 +284,15 @@ void LAppLive2DManager::OnUpdate() const
             continue;
         }
 
-        if (model->GetModel()->GetCanvasWidth() > 1.0f && width < height)
+        if (model->GetModel()->GetCanvasWidth() > 1.0f && windowState->IsPortrait())
         {
             // 当模型宽度大于1且窗口高度大于宽度时，以模型宽度为基准进行缩放
             model->GetModelMatrix()->SetWidth(2.0f);
-            projection.Scale(1.0f, static_cast<float>(width) / static_cast<float>(height));
+            projection = windowState->GetFitWidthProjection();
         }
         else
         {
-            projection.Scale(static_cast<float>(height) / static_cast<float>(width), 1.0f);
+            projection = windowState->GetFitHeightProjection();
         }
 
         // 对模型大小的修改
@@ -200,6 +311,11 @@ void LAppLive2DManager::OnUpdate() const
         // 模型绘制前调用
         LAppDelegate::GetInstance()->GetView()->PreModelDraw(*model);
 
+        if (_lipSyncStream != NULL)
+        {
+            model->SetExternalLipSync(streamActive, streamRms);
+        }
+
         model->Update();
         model->Draw(projection); // 传递引用，projection会发生变化
 
@@ -210,8 +326,19 @@ void LAppLive2DManager::OnUpdate() const
 
 void LAppLive2DManager::NextScene()
 {
-    csmInt32 no = (_sceneIndex + 1) % ModelDirSize;
-    ChangeScene(no);
+    // 加载中时从加载中的场景开始数
+    csmInt32 current = _sceneIndex;
+    if (_requestedSceneIndex >= 0)
+    {
+        current = _requestedSceneIndex;
+    }
+    else if (_pending != NULL)
+    {
+        current = _pending->sceneIndex;
+    }
+
+    csmInt32 no = (current + 1) % ModelDirSize;
+    ChangeSceneAsync(no, SceneLoaded);
 }
 
 void LAppLive2DManager::ChangeScene(Csm::csmInt32 index)
@@ -230,10 +357,350 @@ void LAppLive2DManager::ChangeScene(Csm::csmInt32 index)
     std::string modelJsonName = ModelDir[index];
     modelJsonName += ".model3.json";
 
-    ReleaseAllModel();
-    _models.PushBack(new LAppModel());
+    // 旧场景的模型在新场景加载后才释放，两个场景共用的纹理不被删除
+    csmVector<LAppModel*> oldModels = _models;
+    _models.Clear();
+
+    // 同步切换时丢弃预读，切换后重新预读
+    if (_prefetch != NULL)
+    {
+        DiscardSceneLoad(_prefetch);
+        _prefetch = NULL;
+    }
+
+    // 模型目录旁存在素材包时挂载，模型的所有文件都从素材包中读取
+    if (_mountedModelPath != modelPath)
+    {
+        if (!_mountedModelPath.empty())
+        {
+            LAppPal::UnmountBundle(_mountedModelPath);
+            _mountedModelPath.clear();
+        }
+        if (LAppPal::MountBundle(modelPath, ResourcesPath + model + BundleExtension))
+        {
+            _mountedModelPath = modelPath;
+        }
+    }
+
+    _models.PushBack(CreateSceneModel(index));
     _models[0]->LoadAssets(modelPath.c_str(), modelJsonName.c_str());
 
+#if defined(USE_RENDER_TARGET) || defined(USE_MODEL_RENDER_TARGET)
+    // 作为一个示例，为每个模型分配α值，创建另一个模型
+    _models.PushBack(CreateSceneModel(index));
+    _models[1]->LoadAssets(modelPath.c_str(), modelJsonName.c_str());
+#endif
+
+    for (csmInt32 i = 0; i < oldModels.GetSize(); i++)
+    {
+        delete oldModels[i];
+    }
+
+    SetupScene();
+
+    StartPrefetch();
+}
+
+std::shared_future<csmBool> LAppLive2DManager::ChangeSceneAsync(csmInt32 index, SceneLoadedCallback callback)
+{
+    std::promise<csmBool> promise;
+    std::shared_future<csmBool> result = promise.get_future().share();
+
+    if (_pending == NULL)
+    {
+        StartPendingScene(index, promise, callback);
+        return result;
+    }
+
+    // 加载中时在完成后执行。只保留最新的请求
+    if (_requestedSceneIndex >= 0)
+    {
+        _requestedPromise.set_value(false);
+        if (_requestedCallback != NULL)
+        {
+            _requestedCallback(_requestedSceneIndex, false);
+        }
+    }
+
+    _requestedSceneIndex = index;
+    _requestedPromise = std::move(promise);
+    _requestedCallback = callback;
+
+    return result;
+}
+
+LAppLive2DManager::SceneLoad* LAppLive2DManager::StartSceneLoad(csmInt32 index, csmSizeInt budgetBytes)
+{
+    std::string model = ModelDir[index];
+    std::string modelPath = ResourcesPath + model + "/";
+    std::string modelJsonName = ModelDir[index];
+    modelJsonName += ".model3.json";
+
+    SceneLoad* load = new SceneLoad();
+    load->sceneIndex = index;
+    load->modelPath = modelPath;
+    load->prepareResult = false;
+    load->budgetBytes = budgetBytes;
+    load->overBudget = false;
+
+    // 当前场景的素材包在替换完成前保持挂载（当前模型可能还会读取动作）
+    load->bundleMounted = false;
+    if (_mountedModelPath != modelPath)
+    {
+        load->bundleMounted = LAppPal::MountBundle(modelPath, ResourcesPath + model + BundleExtension);
+    }
+
+    load->models.push_back(CreateSceneModel(index));
+#if defined(USE_RENDER_TARGET) || defined(USE_MODEL_RENDER_TARGET)
+    load->models.push_back(CreateSceneModel(index));
+#endif
+
+    load->prepare = LAppTaskPool::GetInstance()->Submit([load, modelPath, modelJsonName]()
+    {
+        // 预算由场景的所有模型共用，各模型在读取moc和解码纹理之前扣除
+        csmSizeInt remaining = load->budgetBytes;
+        csmSizeInt* budget = load->budgetBytes > 0 ? &remaining : NULL;
+        csmBool result = true;
+        for (size_t i = 0; i < load->models.size() && result; i++)
+        {
+            result = load->models[i]->PrepareAssets(modelPath.c_str(), modelJsonName.c_str(), budget);
+            load->overBudget = load->models[i]->IsOverBudget();
+        }
+        load->prepareResult = result;
+    });
+
+    return load;
+}
+
+csmBool LAppLive2DManager::IsSceneLoadPrepared(SceneLoad* load)
+{
+    return load->prepare.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void LAppLive2DManager::DiscardSceneLoad(SceneLoad* load)
+{
+    if (IsSceneLoadPrepared(load))
+    {
+        DeleteSceneLoad(load);
+    }
+    else
+    {
+        // 工作线程还在使用，OnUpdate中确认结束后释放
+        _discardedLoads.push_back(load);
+    }
+}
+
+void LAppLive2DManager::DeleteSceneLoad(SceneLoad* load)
+{
+    for (size_t i = 0; i < load->models.size(); i++)
+    {
+        delete load->models[i];
+    }
+
+    if (load->bundleMounted)
+    {
+        LAppPal::UnmountBundle(load->modelPath);
+    }
+
+    delete load;
+}
+
+void LAppLive2DManager::StartPendingScene(csmInt32 index, std::promise<csmBool>& promise, SceneLoadedCallback callback)
+{
+    if (DebugLogEnable)
+    {
+        LAppPal::PrintLog("[APP]model index: %d (async)", index);
+    }
+
+    _pendingPromise = std::move(promise);
+    _pendingCallback = callback;
+
+    if (_prefetch != NULL && IsSceneLoadPrepared(_prefetch) && _prefetch->overBudget)
+    {
+        // 超出预算而中止的预读不能使用
+        DiscardPrefetchOverBudget();
+    }
+
+    if (_prefetch != NULL && _prefetch->sceneIndex == index)
+    {
+        // 预读命中：读取和解码已完成或正在进行
+        _pending = _prefetch;
+        _prefetch = NULL;
+        _prefetchHitCount++;
+        return;
+    }
+
+    if (_prefetch != NULL)
+    {
+        DiscardSceneLoad(_prefetch);
+        _prefetch = NULL;
+    }
+    if (ScenePrefetchEnable)
+    {
+        _prefetchMissCount++;
+    }
+
+    _pending = StartSceneLoad(index);
+}
+
+void LAppLive2DManager::UpdatePendingScene()
+{
+    // 释放已丢弃且PrepareAssets已结束的场景
+    for (size_t i = 0; i < _discardedLoads.size();)
+    {
+        if (IsSceneLoadPrepared(_discardedLoads[i]))
+        {
+            DeleteSceneLoad(_discardedLoads[i]);
+            _discardedLoads.erase(_discardedLoads.begin() + i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    // 预读在解码前超出预算而中止时丢弃（下次切换场景后再预读）
+    if (_prefetch != NULL && IsSceneLoadPrepared(_prefetch) && _prefetch->overBudget)
+    {
+        DiscardPrefetchOverBudget();
+    }
+
+    if (_pending == NULL)
+    {
+        return;
+    }
+
+    if (!IsSceneLoadPrepared(_pending))
+    {
+        return;
+    }
+
+    if (!_pending->prepareResult && _pending->overBudget)
+    {
+        // 命中的预读在加载中超出预算而中止，不限制预算重新加载
+        const csmInt32 index = _pending->sceneIndex;
+        DeleteSceneLoad(_pending);
+        _pending = StartSceneLoad(index);
+        return;
+    }
+
+    if (!_pending->prepareResult)
+    {
+        LAppPal::PrintLog("Failed to ChangeSceneAsync(%d).", _pending->sceneIndex);
+        FinishPendingScene(false);
+    }
+    else
+    {
+        // 每帧只执行一步OpenGL处理。纹理通过PBO分帧上传，由LAppTextureManager::EndFrame推进
+        for (size_t i = 0; i < _pending->models.size(); i++)
+        {
+            if (!_pending->models[i]->UploadAssetsStep(true))
+            {
+                return;
+            }
+        }
+
+        FinishPendingScene(true);
+    }
+
+    if (_requestedSceneIndex >= 0)
+    {
+        const csmInt32 index = _requestedSceneIndex;
+        _requestedSceneIndex = -1;
+        StartPendingScene(index, _requestedPromise, _requestedCallback);
+        _requestedPromise = std::promise<csmBool>();
+        _requestedCallback = NULL;
+    }
+    else
+    {
+        StartPrefetch();
+    }
+}
+
+void LAppLive2DManager::FinishPendingScene(csmBool succeeded)
+{
+    SceneLoad* load = _pending;
+    const csmInt32 index = load->sceneIndex;
+    SceneLoadedCallback callback = _pendingCallback;
+    _pending = NULL;
+
+    if (succeeded)
+    {
+        ReleaseAllModel();
+        for (size_t i = 0; i < load->models.size(); i++)
+        {
+            _models.PushBack(load->models[i]);
+        }
+        load->models.clear();
+
+        // 已切换到其他场景时不再重新加载变更前的场景（其共享素材已从注册表中移除）
+        if (index != _sceneIndex)
+        {
+            _hotReloadScenePending = false;
+        }
+        _sceneIndex = index;
+
+        // 旧场景的模型释放后才卸载其素材包
+        if (_mountedModelPath != load->modelPath)
+        {
+            if (!_mountedModelPath.empty())
+            {
+                LAppPal::UnmountBundle(_mountedModelPath);
+            }
+            _mountedModelPath = load->bundleMounted ? load->modelPath : "";
+        }
+        load->bundleMounted = false;
+
+        SetupScene();
+    }
+
+    DeleteSceneLoad(load);
+
+    _pendingCallback = NULL;
+    _pendingPromise.set_value(succeeded);
+    _pendingPromise = std::promise<csmBool>();
+
+    if (callback != NULL)
+    {
+        callback(index, succeeded);
+    }
+}
+
+void LAppLive2DManager::StartPrefetch()
+{
+    if (!ScenePrefetchEnable || _prefetch != NULL || _pending != NULL)
+    {
+        return;
+    }
+
+    const csmInt32 index = (_sceneIndex + 1) % ModelDirSize;
+    if (index == _sceneIndex)
+    {
+        return;
+    }
+
+    if (DebugLogEnable)
+    {
+        LAppPal::PrintLog("[APP]prefetch scene: %d", index);
+    }
+
+    _prefetch = StartSceneLoad(index, ScenePrefetchBudgetBytes);
+}
+
+void LAppLive2DManager::DiscardPrefetchOverBudget()
+{
+    if (DebugLogEnable)
+    {
+        LAppPal::PrintLog("[APP]scene %d prefetch over budget: %llu bytes", _prefetch->sceneIndex,
+            static_cast<unsigned long long>(_prefetch->budgetBytes));
+    }
+    DeleteSceneLoad(_prefetch);
+    _prefetch = NULL;
+    _prefetchOverBudgetCount++;
+}
+
+void LAppLive2DManager::SetupScene()
+{
     // 显示半透明模型的示例。
     {
 #if defined(USE_RENDER_TARGET)
@@ -248,10 +715,11 @@ void LAppLive2DManager::ChangeScene(Csm::csmInt32 index)
 #endif
 
 #if defined(USE_RENDER_TARGET) || defined(USE_MODEL_RENDER_TARGET)
-        // 作为一个示例，为每个模型分配α值，创建另一个模型，并稍微移动位置
-        _models.PushBack(new LAppModel());
-        _models[1]->LoadAssets(modelPath.c_str(), modelJsonName.c_str());
-        _models[1]->GetModelMatrix()->TranslateX(0.2f);
+        // 稍微移动第二个模型的位置
+        if (_models.GetSize() > 1 && _models[1]->GetModelMatrix() != NULL)
+        {
+            _models[1]->GetModelMatrix()->TranslateX(0.2f);
+        }
 #endif
 
         LAppDelegate::GetInstance()->GetView()->SwitchRenderingTarget(useRenderTarget);
@@ -260,11 +728,108 @@ void LAppLive2DManager::ChangeScene(Csm::csmInt32 index)
         float clearColor[3] = { 1.0f, 1.0f, 1.0f };
         LAppDelegate::GetInstance()->GetView()->SetRenderTargetClearColor(clearColor[0], clearColor[1], clearColor[2]);
     }
+
+    // 从素材包读取时目录中的文件不会被使用，不监视
+    _fileWatcher.Stop();
+    if (HotReloadEnable && _mountedModelPath.empty())
+    {
+        _fileWatcher.Start(ResourcesPath + std::string(ModelDir[_sceneIndex]) + "/");
+    }
+
+    if (DebugLogEnable)
+    {
+        LAppTextureManager* textureManager = LAppDelegate::GetInstance()->GetTextureManager();
+        LAppPal::PrintLog("[APP]textures: %d total %d bytes resident %d bytes evict %d restore %d", textureManager->GetTextureCount(),
+            textureManager->GetTotalBytes(), textureManager->GetResidentBytes(), textureManager->GetEvictionCount(), textureManager->GetRestoreCount());
+    }
+}
+
+void LAppLive2DManager::UpdateHotReload()
+{
+    if (!_fileWatcher.IsWatching())
+    {
+        return;
+    }
+
+    std::vector<std::string> changedFiles;
+    _fileWatcher.TakeChangedFiles(changedFiles);
+
+    const std::string model = ModelDir[_sceneIndex];
+    const std::string modelPath = ResourcesPath + model + "/";
+
+    for (size_t i = 0; i < changedFiles.size(); i++)
+    {
+        const std::string& fileName = changedFiles[i];
+
+        // 纹理按文件名共享，重新上传一次即可
+        if (fileName.size() > 4 && fileName.compare(fileName.size() - 4, 4, ".png") == 0)
+        {
+            if (LAppDelegate::GetInstance()->GetTextureManager()->ReloadTexture(modelPath + fileName))
+            {
+                LAppPal::PrintLog("[APP]reload texture: %s", fileName.c_str());
+            }
+            continue;
+        }
+
+        // 各实例先停止使用旧的表情和动作
+        csmBool reloadScene = false;
+        for (csmInt32 j = 0; j < _models.GetSize(); j++)
+        {
+            if (!_models[j]->ReloadAsset(fileName.c_str()))
+            {
+                reloadScene = true;
+            }
+        }
+
+        // model3.json和moc3无法单独替换，丢弃共享素材后重新加载场景。
+        // 加载中的场景结束后再重新加载（加载中的场景可能读取了变更前的文件）
+        if (reloadScene)
+        {
+            LAppModelRegistry::GetInstance()->Invalidate(modelPath + model + ".model3.json");
+            _hotReloadScenePending = true;
+            continue;
+        }
+
+        // 共享的表情、动作和语音每个model3.json只重新读取一次
+        std::vector<const LAppModelRegistry::Assets*> reloadedAssets;
+        for (csmInt32 j = 0; j < _models.GetSize(); j++)
+        {
+            const LAppModelRegistry::Assets* assets = _models[j]->GetSharedAssets();
+            if (std::find(reloadedAssets.begin(), reloadedAssets.end(), assets) != reloadedAssets.end())
+            {
+                continue;
+            }
+            reloadedAssets.push_back(assets);
+            _models[j]->ReloadSharedAsset(fileName.c_str());
+        }
+    }
+
+    if (_hotReloadScenePending && _pending == NULL)
+    {
+        LAppPal::PrintLog("[APP]reload scene: %d", _sceneIndex);
+        _hotReloadScenePending = false;
+        ChangeSceneAsync(_sceneIndex);
+    }
 }
 
 csmUint32 LAppLive2DManager::GetModelNum() const
 {
-    return _models.GetSize();
+    return static_cast<csmUint32>(_models.GetSize());
+}
+
+csmUint32 LAppLive2DManager::GetPrefetchHitCount() const
+{
+    return _prefetchHitCount;
+}
+
+csmUint32 LAppLive2DManager::GetPrefetchMissCount() const
+{
+    return _prefetchMissCount;
+}
+
+csmUint32 LAppLive2DManager::GetPrefetchOverBudgetCount() const
+{
+    return _prefetchOverBudgetCount;
 }
 
 void LAppLive2DManager::SetViewMatrix(CubismMatrix44* m)
@@ -278,7 +843,7 @@ void LAppLive2DManager::SetViewMatrix(CubismMatrix44* m)
 Csm::CubismMotionQueueEntryHandle LAppLive2DManager::StartMotion(const Csm::csmChar* group, Csm::csmInt32 no, Csm::csmInt32 priority)
 {
     Csm::CubismMotionQueueEntryHandle motionQueueEntryHandle = 0;
-    for (csmUint32 i = 0; i < _models.GetSize(); i++)
+    for (csmInt32 i = 0; i < _models.GetSize(); i++)
     {
         motionQueueEntryHandle = _models[i]->StartMotion(group, no, priority);
     }
@@ -288,7 +853,7 @@ Csm::CubismMotionQueueEntryHandle LAppLive2DManager::StartMotion(const Csm::csmC
 Csm::CubismMotionQueueEntryHandle LAppLive2DManager::StartRandomMotion(const Csm::csmChar* group, Csm::csmInt32 priority)
 {
     Csm::CubismMotionQueueEntryHandle motionQueueEntryHandle = 0;
-    for (csmUint32 i = 0; i < _models.GetSize(); i++)
+    for (csmInt32 i = 0; i < _models.GetSize(); i++)
     {
         motionQueueEntryHandle = _models[i]->StartRandomMotion(group, priority);
     }
@@ -297,7 +862,7 @@ Csm::CubismMotionQueueEntryHandle LAppLive2DManager::StartRandomMotion(const Csm
 
 void LAppLive2DManager::SetExpression(const Csm::csmChar* expressionID)
 {
-    for (csmUint32 i = 0; i < _models.GetSize(); i++)
+    for (csmInt32 i = 0; i < _models.GetSize(); i++)
     {
         _models[i]->SetExpression(expressionID);
     }
@@ -305,7 +870,7 @@ void LAppLive2DManager::SetExpression(const Csm::csmChar* expressionID)
 
 void LAppLive2DManager::SetRandomExpression()
 {
-    for (csmUint32 i = 0; i < _models.GetSize(); i++)
+    for (csmInt32 i = 0; i < _models.GetSize(); i++)
     {
         _models[i]->SetRandomExpression();
     }
@@ -7,10 +7,15 @@
 
 #pragma once
 
+#include <future>
+#include <string>
+#include <vector>
 #include <CubismFramework.hpp>
 #include <Math/CubismMatrix44.hpp>
 #include <Type/csmVector.hpp>
 #include <Motion/CubismMotionQueueEntry.hpp>
+#include "LAppFileWatcher.hpp"
+#include "LAppLipSyncStream.hpp"
 
 class LAppModel;
 
@@ -31,6 +36,12 @@ OnTap()：处理屏幕点击事件。
 OnUpdate()：在更新屏幕时进行模型的更新处理和绘制处理。
 NextScene()：切换到下一个场景，在示例应用程序中执行模型集切换操作。
 ChangeScene()：根据索引值切换场景，在示例应用程序中执行模型集切换操作。
+ChangeSceneAsync()：在工作线程上读取新场景的模型，主线程每帧只进行一小步OpenGL上传，准备完成前继续显示当前的模型。
+显示场景期间在后台预读下一个场景（ScenePrefetchEnable），NextScene时只需替换模型和上传纹理。
+GetPrefetchHitCount()/GetPrefetchMissCount()：获取切换场景时预读命中/未命中的次数。
+预读在解码纹理之前按ScenePrefetchBudgetBytes估算内存，超出时中止，GetPrefetchOverBudgetCount()获取中止的次数。
+HotReloadEnable时监视当前模型的目录，OnUpdate中只重新读取变更的素材（model3.json和moc3变更时重新加载场景）。
+LipSyncStreamPath不为空时从文件或命名管道接收PCM，OnUpdate中每帧计算一次RMS驱动所有模型的口型，结束时输出延迟和欠载的统计。
 GetModelNum()：获取当前场景中的模型数量。
 SetViewMatrix()：设置用于模型绘制的View矩阵。
 类的私有成员包括：
@@ -93,9 +104,9 @@ public:
 
     /**
     * @brief   更新屏幕时的处理
-    *          进行模型的更新处理和绘制处理
+    *          推进异步加载中的场景，并进行模型的更新处理和绘制处理
     */
-    void OnUpdate() const;
+    void OnUpdate();
 
     /**
     * @brief   切换到下一个场景
@@ -109,12 +120,49 @@ public:
     */
     void ChangeScene(Csm::csmInt32 index);
 
+    /**
+    * @brief   场景加载完成时调用的回调函数类型
+    *
+    * @param[in]   index       场景的索引值
+    * @param[in]   succeeded   切换成功时为true
+    */
+    typedef void (*SceneLoadedCallback)(Csm::csmInt32 index, Csm::csmBool succeeded);
+
+    /**
+    * @brief   异步切换场景
+    *           模型的读取和解析在LAppTaskPool上进行，渲染器创建和纹理上传在OnUpdate中每帧执行一步。
+    *           全部完成之前继续显示当前场景的模型，完成时替换。
+    *           加载中再次调用时，请求在当前加载完成后执行（只保留最新的请求，被替换的请求以失败结束）。
+    *
+    *           返回值在OnUpdate中完成切换时才就绪，请勿在主线程上等待（会死锁）。
+    *
+    * @param[in]   index       场景的索引值
+    * @param[in]   callback    切换完成或失败时在主线程上调用的回调函数
+    * @return      切换结果（成功时为true）
+    */
+    std::shared_future<Csm::csmBool> ChangeSceneAsync(Csm::csmInt32 index, SceneLoadedCallback callback = NULL);
+
     /**
      * @brief   获取模型数量
      * @return  持有模型数量
      */
     Csm::csmUint32 GetModelNum() const;
 
+    /**
+     * @brief   获取切换场景时预读命中的次数
+     */
+    Csm::csmUint32 GetPrefetchHitCount() const;
+
+    /**
+     * @brief   获取切换场景时预读未命中的次数（ScenePrefetchEnable时）
+     */
+    Csm::csmUint32 GetPrefetchMissCount() const;
+
+    /**
+     * @brief   获取预读超出预算而丢弃的次数（ScenePrefetchEnable时）
+     */
+    Csm::csmUint32 GetPrefetchOverBudgetCount() const;
+
     /**
      * @brief   设置viewMatrix
      */
@@ -136,7 +184,97 @@ private:
     */
     virtual ~LAppLive2DManager();
 
+    /**
+    * @brief   在后台加载的场景（加载中的场景或预读的场景）
+    */
+    struct SceneLoad
+    {
+        Csm::csmInt32 sceneIndex;           ///< 场景的索引值
+        std::string modelPath;              ///< 模型目录
+        Csm::csmBool bundleMounted;         ///< 是否为此场景挂载了素材包
+        std::vector<LAppModel*> models;     ///< 加载中的模型
+        std::future<void> prepare;          ///< 工作线程上的PrepareAssets
+        Csm::csmBool prepareResult;         ///< PrepareAssets的结果（prepare就绪后有效）
+        Csm::csmSizeInt budgetBytes;        ///< 读取和解码的字节预算（为0时不限制）
+        Csm::csmBool overBudget;            ///< 是否在解码前因超出预算而中止（prepare就绪后有效）
+    };
+
+    /**
+    * @brief   挂载素材包并在工作线程上开始PrepareAssets
+    */
+    SceneLoad* StartSceneLoad(Csm::csmInt32 index, Csm::csmSizeInt budgetBytes = 0);
+
+    /**
+    * @brief   判断工作线程上的PrepareAssets是否已结束
+    */
+    static Csm::csmBool IsSceneLoadPrepared(SceneLoad* load);
+
+    /**
+    * @brief   丢弃后台加载的场景。PrepareAssets未结束时在结束后释放
+    */
+    void DiscardSceneLoad(SceneLoad* load);
+
+    /**
+    * @brief   释放已结束PrepareAssets的场景的模型和素材包
+    */
+    void DeleteSceneLoad(SceneLoad* load);
+
+    /**
+    * @brief   开始加载场景的模型（异步）。已预读时直接使用预读的模型
+    */
+    void StartPendingScene(Csm::csmInt32 index, std::promise<Csm::csmBool>& promise, SceneLoadedCallback callback);
+
+    /**
+    * @brief   推进加载中的场景，准备完成时替换当前场景的模型
+    */
+    void UpdatePendingScene();
+
+    /**
+    * @brief   结束加载中的场景
+    *
+    * @param[in]   succeeded   为true时替换当前场景的模型，为false时丢弃加载中的模型
+    */
+    void FinishPendingScene(Csm::csmBool succeeded);
+
+    /**
+    * @brief   开始预读下一个场景（ScenePrefetchEnable时）
+    */
+    void StartPrefetch();
+
+    /**
+    * @brief   丢弃超出预算而中止的预读并计数
+    */
+    void DiscardPrefetchOverBudget();
+
+    /**
+    * @brief   设置模型加载后的场景（模型位置、渲染目标、文件监视）
+    */
+    void SetupScene();
+
+    /**
+    * @brief   重新读取当前场景中变更的素材（HotReloadEnable时）
+    */
+    void UpdateHotReload();
+
     Csm::CubismMatrix44* _viewMatrix; ///< 用于模型绘制的View矩阵
     Csm::csmVector<LAppModel*>  _models; ///< 模型实例的容器
     Csm::csmInt32               _sceneIndex; ///< 显示场景的索引值
+    std::string                 _mountedModelPath; ///< 已挂载素材包的模型目录
+
+    SceneLoad*                  _pending; ///< 异步加载中的场景（没有时为NULL）
+    std::promise<Csm::csmBool>  _pendingPromise; ///< 加载中场景的切换结果
+    SceneLoadedCallback         _pendingCallback; ///< 加载中场景的回调函数
+    Csm::csmInt32               _requestedSceneIndex; ///< 加载中收到的下一个请求（没有时为-1）
+    std::promise<Csm::csmBool>  _requestedPromise; ///< 下一个请求的切换结果
+    SceneLoadedCallback         _requestedCallback; ///< 下一个请求的回调函数
+
+    SceneLoad*                  _prefetch; ///< 预读的下一个场景（没有时为NULL）
+    std::vector<SceneLoad*>     _discardedLoads; ///< 已丢弃、等待PrepareAssets结束的场景
+    Csm::csmUint32              _prefetchHitCount; ///< 切换时预读命中的次数
+    Csm::csmUint32              _prefetchMissCount; ///< 切换时预读未命中的次数
+    Csm::csmUint32              _prefetchOverBudgetCount; ///< 超出预算而丢弃预读的次数
+
+    LAppFileWatcher             _fileWatcher; ///< 当前场景的模型目录的监视器（热重载用）
+    Csm::csmBool                _hotReloadScenePending; ///< 加载中检测到model3.json或moc3变更，加载结束后重新加载当前场景
+    LAppLipSyncStream*          _lipSyncStream; ///< 实时口型同步的PCM流（LipSyncStreamPath为空时为NULL）
 };
\ No newline at end of file
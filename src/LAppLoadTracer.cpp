@@ -0,0 +1,216 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppLoadTracer.hpp"
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "LAppDefine.hpp"
+#include "LAppPal.hpp"
+
+using namespace Csm;
+using namespace LAppDefine;
+
+namespace
+{
+    /**
+    * @brief 一条记录
+    */
+    struct TraceRecord
+    {
+        const csmChar* phase;
+        std::string detail;
+        csmSizeInt bytes;
+        csmInt64 startMicros;
+        csmInt64 durationMicros;
+        csmUint32 threadIndex;
+    };
+
+    const std::chrono::steady_clock::time_point s_origin = std::chrono::steady_clock::now();
+    std::mutex s_mutex;
+    std::vector<TraceRecord> s_records;
+    csmUint32 s_droppedCount = 0;
+    std::map<std::thread::id, csmUint32> s_threadIndices;
+
+    // 转义JSON字符串
+    std::string EscapeJson(const std::string& text)
+    {
+        std::string result;
+        result.reserve(text.size());
+        for (size_t i = 0; i < text.size(); i++)
+        {
+            const char c = text[i];
+            if (c == '"' || c == '\\')
+            {
+                result += '\\';
+                result += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                const char* hex = "0123456789abcdef";
+                result += "\\u00";
+                result += hex[(c >> 4) & 0xF];
+                result += hex[c & 0xF];
+            }
+            else
+            {
+                result += c;
+            }
+        }
+        return result;
+    }
+}
+
+LAppLoadTracer::Scope::Scope(const csmChar* phase, const csmChar* detail, csmSizeInt bytes)
+    : _phase(phase)
+    , _bytes(bytes)
+    , _startMicros(-1)
+{
+    if (LoadTraceEnable)
+    {
+        _detail = detail;
+        _startMicros = GetMicros();
+    }
+}
+
+LAppLoadTracer::Scope::~Scope()
+{
+    if (_startMicros >= 0)
+    {
+        Record(_phase, _detail, _bytes, _startMicros, GetMicros());
+    }
+}
+
+void LAppLoadTracer::Scope::SetBytes(csmSizeInt bytes)
+{
+    _bytes = bytes;
+}
+
+csmBool LAppLoadTracer::WriteChromeTrace(const std::string& filePath)
+{
+    FILE* file = fopen(filePath.c_str(), "wb");
+    if (file == NULL)
+    {
+        LAppPal::PrintLog("[APP]failed to write load trace: %s", filePath.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    // Complete事件（ph:X）。ts和dur的单位为微秒
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (csmUint32 i = 0; i < s_records.size(); i++)
+    {
+        const TraceRecord& record = s_records[i];
+        fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"load\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%lld,\"dur\":%lld,\"args\":{\"detail\":\"%s\",\"bytes\":%llu}}\n",
+            (i == 0) ? "" : ",", EscapeJson(record.phase).c_str(), record.threadIndex,
+            static_cast<long long>(record.startMicros), static_cast<long long>(record.durationMicros),
+            EscapeJson(record.detail).c_str(), static_cast<unsigned long long>(record.bytes));
+    }
+    fprintf(file, "]}\n");
+    fclose(file);
+
+    if (DebugLogEnable)
+    {
+        LAppPal::PrintLog("[APP]load trace: %s (%d records)", filePath.c_str(), static_cast<csmInt32>(s_records.size()));
+    }
+
+    return true;
+}
+
+void LAppLoadTracer::PrintSummary()
+{
+    struct PhaseSummary
+    {
+        csmUint32 count;
+        csmInt64 totalMicros;
+        csmInt64 maxMicros;
+        csmUint64 bytes;
+    };
+
+    std::vector<std::string> order;
+    std::map<std::string, PhaseSummary> summaries;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        for (csmUint32 i = 0; i < s_records.size(); i++)
+        {
+            const TraceRecord& record = s_records[i];
+            std::map<std::string, PhaseSummary>::iterator it = summaries.find(record.phase);
+            if (it == summaries.end())
+            {
+                PhaseSummary empty = { 0, 0, 0, 0 };
+                it = summaries.insert(std::make_pair(std::string(record.phase), empty)).first;
+                order.push_back(record.phase);
+            }
+            it->second.count++;
+            it->second.totalMicros += record.durationMicros;
+            it->second.bytes += record.bytes;
+            if (record.durationMicros > it->second.maxMicros)
+            {
+                it->second.maxMicros = record.durationMicros;
+            }
+        }
+    }
+
+    LAppPal::PrintLog("[APP]%-20s %8s %12s %12s %14s", "phase", "count", "total[ms]", "max[ms]", "bytes");
+    for (csmUint32 i = 0; i < order.size(); i++)
+    {
+        const PhaseSummary& summary = summaries[order[i]];
+        LAppPal::PrintLog("[APP]%-20s %8u %12.3f %12.3f %14llu", order[i].c_str(), summary.count,
+            summary.totalMicros / 1000.0, summary.maxMicros / 1000.0, static_cast<unsigned long long>(summary.bytes));
+    }
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (s_droppedCount > 0)
+    {
+        LAppPal::PrintLog("[APP]load trace: %u records dropped (LoadTraceMaxRecords %u)", s_droppedCount, LoadTraceMaxRecords);
+    }
+}
+
+void LAppLoadTracer::Clear()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_records.clear();
+    s_droppedCount = 0;
+}
+
+csmInt64 LAppLoadTracer::GetMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - s_origin).count();
+}
+
+void LAppLoadTracer::Record(const csmChar* phase, const std::string& detail, csmSizeInt bytes, csmInt64 startMicros, csmInt64 endMicros)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    // 长时间运行时（热重载、场景切换）记录不无限增长
+    if (s_records.size() >= LoadTraceMaxRecords)
+    {
+        s_droppedCount++;
+        return;
+    }
+
+    // 线程按首次记录的顺序编号（Chrome trace中按线程分行显示）
+    const std::thread::id threadId = std::this_thread::get_id();
+    std::map<std::thread::id, csmUint32>::iterator it = s_threadIndices.find(threadId);
+    if (it == s_threadIndices.end())
+    {
+        it = s_threadIndices.insert(std::make_pair(threadId, static_cast<csmUint32>(s_threadIndices.size()))).first;
+    }
+
+    TraceRecord record;
+    record.phase = phase;
+    record.detail = detail;
+    record.bytes = bytes;
+    record.startMicros = startMicros;
+    record.durationMicros = endMicros - startMicros;
+    record.threadIndex = it->second;
+    s_records.push_back(record);
+}
@@ -0,0 +1,94 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <string>
+#include <CubismFramework.hpp>
+
+ /**
+ * @brief 加载时间追踪
+ *
+ * 记录模型加载各阶段（文件读取、JSON解析、moc复原、PNG解码、GL上传等）的耗时和字节数。
+ *
+ 这段代码定义了一个名为LAppLoadTracer的类（静态类），用于找出启动时间花在哪里。
+
+记录可以在任意线程上添加，按线程分别显示。LoadTraceEnable为false时不记录，Scope不复制详细信息，几乎没有开销。
+记录数超过LoadTraceMaxRecords时丢弃之后的记录（丢弃的条数在PrintSummary中输出）。
+
+Scope：在作用域内计时的辅助类。析构时添加一条记录。
+WriteChromeTrace：将记录以Chrome trace JSON（chrome://tracing、Perfetto可以打开）写入文件。
+PrintSummary：按阶段汇总次数、合计时间、最长时间和字节数并输出到日志。
+Clear：删除所有记录。
+ */
+class LAppLoadTracer
+{
+public:
+    /**
+    * @brief 在作用域内计时，析构时添加记录
+    */
+    class Scope
+    {
+    public:
+        /**
+        * @brief 开始计时
+        *
+        * @param[in]   phase   阶段名（例如read、png_decode）。需为字符串字面量
+        * @param[in]   detail  详细信息（例如文件路径）。只在记录时复制
+        * @param[in]   bytes   处理的字节数。结束前确定时可用SetBytes设置
+        */
+        Scope(const Csm::csmChar* phase, const Csm::csmChar* detail = "", Csm::csmSizeInt bytes = 0);
+
+        /**
+        * @brief 结束计时并添加记录
+        */
+        ~Scope();
+
+        /**
+        * @brief 设置处理的字节数
+        */
+        void SetBytes(Csm::csmSizeInt bytes);
+
+    private:
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+
+        const Csm::csmChar* _phase;     ///< 阶段名
+        std::string _detail;            ///< 详细信息
+        Csm::csmSizeInt _bytes;         ///< 字节数
+        Csm::csmInt64 _startMicros;     ///< 开始时间[微秒]（未记录时为-1）
+    };
+
+    /**
+    * @brief 将记录以Chrome trace JSON写入文件
+    *
+    * @param[in]   filePath    输出文件路径
+    * @return                  成功时返回true
+    */
+    static Csm::csmBool WriteChromeTrace(const std::string& filePath);
+
+    /**
+    * @brief 按阶段汇总记录并输出到日志
+    */
+    static void PrintSummary();
+
+    /**
+    * @brief 删除所有记录
+    */
+    static void Clear();
+
+private:
+    /**
+    * @brief 获取从程序启动开始的时间[微秒]
+    */
+    static Csm::csmInt64 GetMicros();
+
+    /**
+    * @brief 添加一条记录（线程安全）
+    */
+    static void Record(const Csm::csmChar* phase, const std::string& detail, Csm::csmSizeInt bytes, Csm::csmInt64 startMicros, Csm::csmInt64 endMicros);
+};
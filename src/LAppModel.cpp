@@ -7,6 +7,9 @@
 
 #include "LAppModel.hpp"
 #include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
 #include <vector>
 #include <CubismModelSettingJson.hpp>
 #include <Motion/CubismMotion.hpp>
@@ -14,12 +17,21 @@
 #include <CubismDefaultParameterId.hpp>
 #include <Rendering/OpenGL/CubismRenderer_OpenGLES2.hpp>
 #include <Utils/CubismString.hpp>
+#include <Utils/CubismJson.hpp>
 #include <Id/CubismIdManager.hpp>
 #include <Motion/CubismMotionQueueEntry.hpp>
+#include <Math/CubismModelMatrix.hpp>
+#include <Effect/CubismPose.hpp>
+#include <Model/CubismModelUserData.hpp>
+#include "LAppBinaryMotion.hpp"
+#include "LAppBundle.hpp"
 #include "LAppDefine.hpp"
 #include "LAppPal.hpp"
 #include "LAppTextureManager.hpp"
 #include "LAppDelegate.hpp"
+#include "LAppTaskPool.hpp"
+#include "LAppLoadTracer.hpp"
+#include "LAppVoiceCache.hpp"
 
 using namespace Live2D::Cubism::Framework;
 using namespace Live2D::Cubism::Framework::DefaultParameterId;
@@ -32,7 +44,13 @@ namespace {
         {
             LAppPal::PrintLog("[APP]create buffer: %s ", path);
         }
-        return LAppPal::LoadFileAsBytes(path, size);
+        LAppLoadTracer::Scope trace("read", path);
+        csmByte* buffer = LAppPal::LoadFileAsBytes(path, size);
+        if (buffer != NULL)
+        {
+            trace.SetBytes(*size);
+        }
+        return buffer;
     }
 
     void DeleteBuffer(csmByte* buffer, const csmChar* path = "")
@@ -43,12 +61,136 @@ namespace {
         }
         LAppPal::ReleaseBytes(buffer);
     }
+
+    // 框架在解析时注册为ID的JSON键（Curves/Parameters/Groups等的Id，Pose的Link，UserData的Target）
+    const csmChar* PrescanIdKeys[] = { "Id", "Link", "Target" };
+    const csmInt32 PrescanIdKeyCount = sizeof(PrescanIdKeys) / sizeof(PrescanIdKeys[0]);
+
+    // CubismMotion在解析时总会注册的ID
+    const csmChar* MotionEffectIds[] = { "EyeBlink", "LipSync", "Opacity" };
+    const csmInt32 MotionEffectIdCount = sizeof(MotionEffectIds) / sizeof(MotionEffectIds[0]);
+
+    /**
+    * @brief SetupModel中在工作线程上读取、解析的一个素材
+    */
+    struct AssetJob
+    {
+        enum Type
+        {
+            Type_Expression,
+            Type_Physics,
+            Type_Pose,
+            Type_UserData,
+        };
+
+        AssetJob(Type type, const csmString& name, const csmString& path)
+            : type(type)
+            , name(name)
+            , path(path)
+            , buffer(NULL)
+            , size(0)
+            , motion(NULL)
+        {
+        }
+
+        Type type;
+        csmString name;                 ///< 表情名
+        csmString path;                 ///< 文件路径
+        csmByte* buffer;                ///< 读取的文件数据
+        csmSizeInt size;                ///< 文件大小
+        std::vector<std::string> ids;   ///< 文件中出现的ID
+        ACubismMotion* motion;          ///< 生成的表情
+    };
+
+    /**
+    * @brief 递归收集JSON中作为ID使用的字符串
+    */
+    void CollectIds(Utils::Value& value, csmBool isIdValue, std::vector<std::string>& outIds)
+    {
+        if (value.IsString())
+        {
+            if (isIdValue)
+            {
+                outIds.push_back(value.GetRawString());
+            }
+        }
+        else if (value.IsArray())
+        {
+            for (csmInt32 i = 0; i < value.GetSize(); i++)
+            {
+                CollectIds(value[i], isIdValue, outIds);
+            }
+        }
+        else if (value.IsMap())
+        {
+            csmVector<csmString>& keys = value.GetKeys();
+            for (csmInt32 i = 0; i < keys.GetSize(); i++)
+            {
+                csmBool isIdKey = false;
+                for (csmInt32 j = 0; j < PrescanIdKeyCount; j++)
+                {
+                    if (keys[i] == PrescanIdKeys[j])
+                    {
+                        isIdKey = true;
+                        break;
+                    }
+                }
+                CollectIds(value[keys[i]], isIdKey, outIds);
+            }
+        }
+    }
+
+    /**
+    * @brief 读取素材文件并预扫描其中的ID（不访问CubismIdManager）
+    */
+    void ReadAsset(AssetJob& job)
+    {
+        job.buffer = CreateBuffer(job.path.GetRawString(), &job.size);
+        if (job.buffer == NULL || !ParallelSetupEnable)
+        {
+            return;
+        }
+
+        Utils::CubismJson* json = Utils::CubismJson::Create(job.buffer, job.size);
+        if (json == NULL)
+        {
+            return;
+        }
+        CollectIds(json->GetRoot(), false, job.ids);
+        Utils::CubismJson::Delete(json);
+    }
+
+    /**
+    * @brief 执行任务。ParallelSetupEnable时在工作线程池上并行执行
+    */
+    void RunTasks(const std::vector<std::function<void()> >& tasks)
+    {
+        if (ParallelSetupEnable)
+        {
+            LAppTaskPool::GetInstance()->RunAll(tasks);
+            return;
+        }
+
+        for (csmUint32 i = 0; i < tasks.size(); i++)
+        {
+            tasks[i]();
+        }
+    }
 }
 
 LAppModel::LAppModel()
     : CubismUserModel()
     , _modelSetting(NULL)
     , _userTimeSeconds(0.0f)
+    , _assets(NULL)
+    , _lipSyncEnvelope(NULL)
+    , _lipSyncSeconds(0.0f)
+    , _externalLipSync(false)
+    , _externalLipSyncValue(0.0f)
+    , _uploadedTextureCount(0)
+    , _textureQuality(LAppTextureManager::TextureQuality_Full)
+    , _overBudget(false)
+    , _textureUser(false)
 {
     if (MocConsistencyValidationEnable)
     {
@@ -60,6 +202,9 @@ LAppModel::LAppModel()
         _debugMode = true;
     }
 
+    // 其他模型可能正在工作线程上加载
+    std::lock_guard<LAppPal::IdManagerMutex> lock(LAppPal::GetIdManagerMutex());
+
     _idParamAngleX = CubismFramework::GetIdManager()->GetId(ParamAngleX);
     _idParamAngleY = CubismFramework::GetIdManager()->GetId(ParamAngleY);
     _idParamAngleZ = CubismFramework::GetIdManager()->GetId(ParamAngleZ);
@@ -72,105 +217,374 @@ LAppModel::~LAppModel()
 {
     _renderBuffer.DestroyOffscreenFrame();
 
-    ReleaseMotions();
-    ReleaseExpressions();
+    // 先取消计数再释放纹理，避免之后加载的实例以为纹理仍存在
+    if (_textureUser)
+    {
+        std::lock_guard<std::mutex> textureLock(_assets->textureMutex);
+        _assets->textureUsers[_textureQuality]--;
+    }
 
-    for (csmInt32 i = 0; i < _modelSetting->GetMotionGroupCount(); i++)
+    ReleaseTextures();
+
+    for (csmUint32 i = 0; i < _pendingTextures.size(); i++)
     {
-        const csmChar* group = _modelSetting->GetMotionGroupName(i);
-        ReleaseMotionGroup(group);
+        LAppTextureManager::ReleaseDecodedImage(&_pendingTextures[i].image);
+    }
+
+    if (_assets == NULL)
+    {
+        return;
+    }
+
+    if (_debugMode)
+    {
+        LAppMotionCache& motionCache = _assets->motionCache;
+        LAppPal::PrintLog("[APP]motion cache: hit %d miss %d evict %d resident %d motions %d bytes",
+            motionCache.GetHitCount(), motionCache.GetMissCount(), motionCache.GetEvictionCount(),
+            motionCache.GetEntryCount(), motionCache.GetResidentBytes());
+    }
+
+    // 动作和表情由其他实例继续使用，只删除本实例的播放记录
+    _assets->motionCache.Unpin(_motionManager);
+
+    // 本实例的模型从共享的moc生成，_moc为NULL，基类的析构函数不释放
+    if (_model != NULL)
+    {
+        std::lock_guard<std::mutex> mocLock(_assets->mocMutex);
+        _assets->moc->DeleteModel(_model);
+        _model = NULL;
+    }
+
+    // 超出预算而在SetupModel之前中止的实例没有设置
+    if (_modelSetting != NULL)
+    {
+        for (csmInt32 i = 0; i < _modelSetting->GetMotionGroupCount(); i++)
+        {
+            const csmChar* group = _modelSetting->GetMotionGroupName(i);
+            ReleaseMotionGroup(group);
+        }
     }
-    delete(_modelSetting);
+
+    // 最后一个实例释放时，设置、moc、表情和动作也一起释放
+    _modelSetting = NULL;
+    LAppModelRegistry::GetInstance()->Release(_assets);
+    _assets = NULL;
 }
 
 void LAppModel::LoadAssets(const csmChar* dir, const csmChar* fileName)
+{
+    if (!PrepareAssets(dir, fileName))
+    {
+        LAppPal::PrintLog("Failed to LoadAssets().");
+        return;
+    }
+
+    while (!UploadAssetsStep())
+    {
+    }
+}
+
+csmBool LAppModel::PrepareAssets(const csmChar* dir, const csmChar* fileName, csmSizeInt* budgetBytes)
 {
     _modelHomeDir = dir;
+    _overBudget = false;
 
     if (_debugMode)
     {
         LAppPal::PrintLog("[APP]load model setting: %s", fileName);
     }
 
-    csmSizeInt size;
     const csmString path = csmString(dir) + fileName;
+    LAppLoadTracer::Scope trace("prepare_assets", path.GetRawString());
 
-    csmByte* buffer = CreateBuffer(path.GetRawString(), &size);
-    ICubismModelSetting* setting = new CubismModelSettingJson(buffer, size);
-    DeleteBuffer(buffer, path.GetRawString());
+    // 同一个model3.json的实例共享设置、moc、表情和动作。同一模型的加载按顺序进行
+    _assets = LAppModelRegistry::GetInstance()->Acquire(path.GetRawString());
+    std::lock_guard<std::mutex> loadLock(_assets->loadMutex);
 
-    SetupModel(setting);
+    // 超出预算的实例只解析了设置，因此按持有纹理的实例数判断纹理是否已读取
+    csmBool sharedTextures;
+    {
+        std::lock_guard<std::mutex> textureLock(_assets->textureMutex);
+        sharedTextures = _assets->textureUsers[_textureQuality] > 0;
+    }
+
+    if (_assets->setting == NULL)
+    {
+        csmSizeInt size;
+        csmByte* buffer = CreateBuffer(path.GetRawString(), &size);
+        {
+            // 设置的解析会注册碰撞检测、眨眼、唇形同步的ID
+            std::lock_guard<LAppPal::IdManagerMutex> lock(LAppPal::GetIdManagerMutex());
+            LAppLoadTracer::Scope parseTrace("parse_setting", path.GetRawString(), size);
+            _assets->setting = new CubismModelSettingJson(buffer, size);
+        }
+        DeleteBuffer(buffer, path.GetRawString());
+    }
+
+    // 在读取moc和解码纹理之前检查预算，超出时不占用这些内存
+    if (budgetBytes != NULL)
+    {
+        const csmSizeInt bytes = EstimateLoadBytes(_assets->setting, sharedTextures);
+        if (bytes > *budgetBytes)
+        {
+            if (_debugMode)
+            {
+                LAppPal::PrintLog("[APP]load budget exceeded: %s needs %llu bytes, %llu left", path.GetRawString(),
+                    static_cast<unsigned long long>(bytes), static_cast<unsigned long long>(*budgetBytes));
+            }
+            _overBudget = true;
+            return false;
+        }
+        *budgetBytes -= bytes;
+    }
+
+    SetupModel(_assets->setting);
 
     if (_model == NULL)
     {
-        LAppPal::PrintLog("Failed to LoadAssets().");
-        return;
+        return false;
     }
 
-    CreateRenderer();
+    // 语音的口型同步包络也在工作线程上准备，播放时不再读取wav
+    if (LipSyncEnvelopeEnable)
+    {
+        LoadLipSyncEnvelopes();
+    }
 
-    SetupTextures();
+    // 纹理的读取和解码也在此处完成，主线程只进行上传
+    std::vector<csmInt32> textureNumbers;
+    std::vector<std::string> texturePaths;
+    for (csmInt32 modelTextureNumber = 0; modelTextureNumber < _modelSetting->GetTextureCount(); modelTextureNumber++)
+    {
+        // テクスチャ名が空文字だった場合はロード・バインド処理をスキップ
+        if (strcmp(_modelSetting->GetTextureFileName(modelTextureNumber), "") == 0)
+        {
+            continue;
+        }
+
+        csmString texturePath = _modelSetting->GetTextureFileName(modelTextureNumber);
+        texturePath = _modelHomeDir + texturePath;
+
+        textureNumbers.push_back(modelTextureNumber);
+        texturePaths.push_back(texturePath.GetRawString());
+    }
+
+    std::vector<LAppTextureManager::DecodedImage> images;
+    if (sharedTextures)
+    {
+        // 其他实例持有同一质量的纹理，主线程上按文件名从LAppTextureManager取得
+        images.resize(texturePaths.size());
+        for (csmUint32 i = 0; i < texturePaths.size(); i++)
+        {
+            images[i].fileName = texturePaths[i];
+            images[i].width = 0;
+            images[i].height = 0;
+            images[i].quality = _textureQuality;
+            images[i].mipLevels = 1;
+            images[i].pixels = NULL;
+            images[i].mappedData = NULL;
+        }
+    }
+    else
+    {
+        LAppTextureManager::DecodePngFiles(texturePaths, images, _textureQuality);
+    }
+
+    for (csmUint32 i = 0; i < images.size(); i++)
+    {
+        if (!sharedTextures && images[i].pixels == NULL)
+        {
+            continue;
+        }
+
+        PendingTexture pending;
+        pending.modelTextureNumber = textureNumbers[i];
+        pending.image = images[i];
+        _pendingTextures.push_back(pending);
+    }
+    _uploadedTextureCount = 0;
+
+    // 之后的实例不再解码本实例持有的纹理
+    {
+        std::lock_guard<std::mutex> textureLock(_assets->textureMutex);
+        _assets->textureUsers[_textureQuality]++;
+    }
+    _textureUser = true;
+
+    return true;
 }
 
-void LAppModel::SetupModel(ICubismModelSetting* setting)
+csmBool LAppModel::UploadAssetsStep(csmBool streamTextures)
 {
-    _updating = true;
-    _initialized = false;
+    if (GetRenderer<Rendering::CubismRenderer_OpenGLES2>() == NULL)
+    {
+        LAppLoadTracer::Scope trace("create_renderer", _modelHomeDir.GetRawString());
+        CreateRenderer();
+        return false;
+    }
 
-    _modelSetting = setting;
+    LAppTextureManager* textureManager = LAppDelegate::GetInstance()->GetTextureManager();
 
-    csmByte* buffer;
-    csmSizeInt size;
+    // 加载中的模型尚未绘制，防止已上传的纹理被显存预算淘汰
+    for (csmUint32 i = 0; i < _textureIds.size(); i++)
+    {
+        textureManager->UseTexture(_textureIds[i]);
+    }
 
-    //Cubism Model
-    if (strcmp(_modelSetting->GetModelFileName(), "") != 0)
+    if (_uploadedTextureCount < _pendingTextures.size())
     {
-        csmString path = _modelSetting->GetModelFileName();
-        path = _modelHomeDir + path;
+        PendingTexture& pending = _pendingTextures[_uploadedTextureCount];
+        _uploadedTextureCount++;
 
-        if (_debugMode)
+        //OpenGLのテクスチャユニットにテクスチャをロードする
+        LAppTextureManager::TextureInfo* texture;
+        if (pending.image.pixels == NULL)
         {
-            LAppPal::PrintLog("[APP]create model: %s", setting->GetModelFileName());
+            texture = textureManager->CreateTextureFromPngFile(pending.image.fileName, pending.image.quality);
+        }
+        else if (streamTextures)
+        {
+            texture = textureManager->CreateTextureStreamed(&pending.image);
+        }
+        else
+        {
+            texture = textureManager->CreateTextureFromDecodedImage(pending.image);
+            LAppTextureManager::ReleaseDecodedImage(&pending.image);
         }
 
-        buffer = CreateBuffer(path.GetRawString(), &size);
-        LoadModel(buffer, size, _mocConsistency);
-        DeleteBuffer(buffer, path.GetRawString());
+        if (texture != NULL)
+        {
+            _textureIds.push_back(texture->id);
+
+            // 其他模型共享的纹理也可能正在流式上传
+            if (texture->streaming && !streamTextures)
+            {
+                textureManager->FinishTextureStreaming(texture->id);
+            }
+
+            //OpenGL
+            if (texture->streaming)
+            {
+                GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->BindTexture(pending.modelTextureNumber, textureManager->GetPlaceholderTextureId());
+
+                StreamingTexture streaming;
+                streaming.modelTextureNumber = pending.modelTextureNumber;
+                streaming.textureId = texture->id;
+                _streamingTextures.push_back(streaming);
+            }
+            else
+            {
+                GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->BindTexture(pending.modelTextureNumber, texture->id);
+            }
+        }
+        return false;
     }
 
-    //Expression
-    if (_modelSetting->GetExpressionCount() > 0)
+    // 流式上传完成的纹理替换占位纹理
+    for (csmUint32 i = 0; i < _streamingTextures.size();)
     {
-        const csmInt32 count = _modelSetting->GetExpressionCount();
-        for (csmInt32 i = 0; i < count; i++)
+        if (textureManager->IsTextureStreaming(_streamingTextures[i].textureId))
         {
-            csmString name = _modelSetting->GetExpressionName(i);
-            csmString path = _modelSetting->GetExpressionFileName(i);
-            path = _modelHomeDir + path;
+            i++;
+            continue;
+        }
 
-            buffer = CreateBuffer(path.GetRawString(), &size);
-            ACubismMotion* motion = LoadExpression(buffer, size, name.GetRawString());
+        GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->BindTexture(_streamingTextures[i].modelTextureNumber, _streamingTextures[i].textureId);
+        _streamingTextures.erase(_streamingTextures.begin() + i);
+    }
+    if (!_streamingTextures.empty())
+    {
+        return false;
+    }
 
-            if (_expressions[name] != NULL)
-            {
-                ACubismMotion::Delete(_expressions[name]);
-                _expressions[name] = NULL;
-            }
-            _expressions[name] = motion;
+    _pendingTextures.clear();
+    _uploadedTextureCount = 0;
 
-            DeleteBuffer(buffer, path.GetRawString());
+#ifdef PREMULTIPLIED_ALPHA_ENABLE
+    GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->IsPremultipliedAlpha(true);
+#else
+    GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->IsPremultipliedAlpha(false);
+#endif
+
+    return true;
+}
+
+csmSizeInt LAppModel::EstimateLoadBytes(ICubismModelSetting* setting, csmBool sharedTextures) const
+{
+    std::vector<std::string> files;
+    if (_assets->moc == NULL && strcmp(setting->GetModelFileName(), "") != 0)
+    {
+        files.push_back(setting->GetModelFileName());
+    }
+    for (csmInt32 i = 0; i < setting->GetExpressionCount(); i++)
+    {
+        files.push_back(setting->GetExpressionFileName(i));
+    }
+    if (strcmp(setting->GetPhysicsFileName(), "") != 0)
+    {
+        files.push_back(setting->GetPhysicsFileName());
+    }
+    if (strcmp(setting->GetPoseFileName(), "") != 0)
+    {
+        files.push_back(setting->GetPoseFileName());
+    }
+    if (strcmp(setting->GetUserDataFile(), "") != 0)
+    {
+        files.push_back(setting->GetUserDataFile());
+    }
+
+    csmSizeInt bytes = 0;
+    for (csmUint32 i = 0; i < files.size(); i++)
+    {
+        csmSizeInt size = 0;
+        if (LAppPal::GetFileLength(std::string(_modelHomeDir.GetRawString()) + files[i], &size))
+        {
+            bytes += size;
+        }
+    }
+
+    for (csmInt32 i = 0; !sharedTextures && i < setting->GetTextureCount(); i++)
+    {
+        if (strcmp(setting->GetTextureFileName(i), "") == 0)
+        {
+            continue;
+        }
+
+        csmSizeInt size = 0;
+        const std::string path = std::string(_modelHomeDir.GetRawString()) + setting->GetTextureFileName(i);
+        if (LAppTextureManager::GetPngDecodedBytes(path, _textureQuality, &size))
+        {
+            bytes += size;
         }
     }
 
+    return bytes;
+}
+
+void LAppModel::SetupModel(ICubismModelSetting* setting)
+{
+    _updating = true;
+    _initialized = false;
+
+    _modelSetting = setting;
+
+    // 先在调用线程上从设置中列出所有素材（ICubismModelSetting不是线程安全的）
+    std::vector<AssetJob> jobs;
+
+    //Expression（其他实例已加载时共享）
+    for (csmInt32 i = 0; i < _modelSetting->GetExpressionCount() && !_assets->expressionsLoaded; i++)
+    {
+        csmString path = _modelSetting->GetExpressionFileName(i);
+        path = _modelHomeDir + path;
+        jobs.push_back(AssetJob(AssetJob::Type_Expression, _modelSetting->GetExpressionName(i), path));
+    }
+
     //Physics
     if (strcmp(_modelSetting->GetPhysicsFileName(), "") != 0)
     {
         csmString path = _modelSetting->GetPhysicsFileName();
         path = _modelHomeDir + path;
-
-        buffer = CreateBuffer(path.GetRawString(), &size);
-        LoadPhysics(buffer, size);
-        DeleteBuffer(buffer, path.GetRawString());
+        jobs.push_back(AssetJob(AssetJob::Type_Physics, "", path));
     }
 
     //Pose
@@ -178,41 +592,110 @@ void LAppModel::SetupModel(ICubismModelSetting* setting)
     {
         csmString path = _modelSetting->GetPoseFileName();
         path = _modelHomeDir + path;
-
-        buffer = CreateBuffer(path.GetRawString(), &size);
-        LoadPose(buffer, size);
-        DeleteBuffer(buffer, path.GetRawString());
+        jobs.push_back(AssetJob(AssetJob::Type_Pose, "", path));
     }
 
-    //EyeBlink
-    if (_modelSetting->GetEyeBlinkParameterCount() > 0)
+    //UserData
+    if (strcmp(_modelSetting->GetUserDataFile(), "") != 0)
     {
-        _eyeBlink = CubismEyeBlink::Create(_modelSetting);
+        csmString path = _modelSetting->GetUserDataFile();
+        path = _modelHomeDir + path;
+        jobs.push_back(AssetJob(AssetJob::Type_UserData, "", path));
     }
 
-    //Breath
+    // 第1阶段：并行读取moc和素材文件，并预扫描素材中的ID
+    std::vector<std::function<void()> > tasks;
+
+    //Cubism Model
+    if (_assets->moc != NULL)
     {
-        _breath = CubismBreath::Create();
+        // 从共享的moc生成本实例的模型（参数、部件、图形网格的ID已注册）
+        std::lock_guard<LAppPal::IdManagerMutex> lock(LAppPal::GetIdManagerMutex());
+        std::lock_guard<std::mutex> mocLock(_assets->mocMutex);
+        LAppLoadTracer::Scope trace("create_model", _modelSetting->GetModelFileName());
+        _model = _assets->moc->CreateModel();
+        if (_model != NULL)
+        {
+            _modelMatrix = CSM_NEW CubismModelMatrix(_model->GetCanvasWidth(), _model->GetCanvasHeight());
+        }
+    }
+    else if (strcmp(_modelSetting->GetModelFileName(), "") != 0)
+    {
+        csmString path = _modelSetting->GetModelFileName();
+        path = _modelHomeDir + path;
 
-        csmVector<CubismBreath::BreathParameterData> breathParameters;
+        if (_debugMode)
+        {
+            LAppPal::PrintLog("[APP]create model: %s", setting->GetModelFileName());
+        }
 
-        breathParameters.PushBack(CubismBreath::BreathParameterData(_idParamAngleX, 0.0f, 15.0f, 6.5345f, 0.5f));
-        breathParameters.PushBack(CubismBreath::BreathParameterData(_idParamAngleY, 0.0f, 8.0f, 3.5345f, 0.5f));
-        breathParameters.PushBack(CubismBreath::BreathParameterData(_idParamAngleZ, 0.0f, 10.0f, 5.5345f, 0.5f));
-        breathParameters.PushBack(CubismBreath::BreathParameterData(_idParamBodyAngleX, 0.0f, 4.0f, 15.5345f, 0.5f));
-        breathParameters.PushBack(CubismBreath::BreathParameterData(CubismFramework::GetIdManager()->GetId(ParamBreath), 0.5f, 0.5f, 3.2345f, 0.5f));
+        tasks.push_back([this, path]()
+        {
+            csmSizeInt size;
+            csmByte* buffer = CreateBuffer(path.GetRawString(), &size);
+            CubismMoc* moc;
+            {
+                // 一致性验证和复原只调用Core，不注册ID，不持有锁（加载中主线程的动作读取和碰撞检测不等待）
+                // 启用一致性验证时也包含验证的时间
+                LAppLoadTracer::Scope trace("moc_revive", path.GetRawString(), size);
+                moc = CubismMoc::Create(buffer, size, _mocConsistency);
+            }
+            DeleteBuffer(buffer, path.GetRawString());
 
-        _breath->SetParameters(breathParameters);
+            if (moc == NULL)
+            {
+                CubismLogError("Failed to CubismMoc::Create().");
+                return;
+            }
+            _moc = moc;
+
+            {
+                // 生成模型时会注册所有参数、部件、图形网格的ID
+                std::lock_guard<LAppPal::IdManagerMutex> lock(LAppPal::GetIdManagerMutex());
+                LAppLoadTracer::Scope trace("create_model", path.GetRawString());
+                _model = _moc->CreateModel();
+            }
+            if (_model == NULL)
+            {
+                CubismLogError("Failed to CreateModel().");
+                return;
+            }
+            _model->SaveParameters();
+            _modelMatrix = CSM_NEW CubismModelMatrix(_model->GetCanvasWidth(), _model->GetCanvasHeight());
+        });
     }
 
-    //UserData
-    if (strcmp(_modelSetting->GetUserDataFile(), "") != 0)
+    for (csmUint32 i = 0; i < jobs.size(); i++)
     {
-        csmString path = _modelSetting->GetUserDataFile();
-        path = _modelHomeDir + path;
-        buffer = CreateBuffer(path.GetRawString(), &size);
-        LoadUserData(buffer, size);
-        DeleteBuffer(buffer, path.GetRawString());
+        AssetJob* job = &jobs[i];
+        tasks.push_back([job]() { ReadAsset(*job); });
+    }
+    RunTasks(tasks);
+
+    // 将moc交给共享素材，之后的实例从同一个moc生成模型
+    if (_moc != NULL)
+    {
+        std::lock_guard<std::mutex> mocLock(_assets->mocMutex);
+        _assets->moc = _moc;
+        _moc = NULL;
+    }
+
+    // 第2阶段：注册预扫描到的ID。之后解析中的CubismIdManager::GetId只进行查找，可以并行调用
+    std::unique_lock<LAppPal::IdManagerMutex> idLock(LAppPal::GetIdManagerMutex());
+    if (ParallelSetupEnable)
+    {
+        CubismIdManager* idManager = CubismFramework::GetIdManager();
+        for (csmInt32 i = 0; i < MotionEffectIdCount; i++)
+        {
+            idManager->GetId(MotionEffectIds[i]);
+        }
+        for (csmUint32 i = 0; i < jobs.size(); i++)
+        {
+            for (csmUint32 j = 0; j < jobs[i].ids.size(); j++)
+            {
+                idManager->GetId(jobs[i].ids[j].c_str());
+            }
+        }
     }
 
     // EyeBlinkIds
@@ -233,6 +716,94 @@ void LAppModel::SetupModel(ICubismModelSetting* setting)
         }
     }
 
+    // 第3阶段：并行解析。各任务只写入自己的AssetJob或各自独立的成员（_physics/_pose/_modelUserData）
+    // 并行时ID已全部注册，解析期间只持有共享锁，主线程的动作读取和碰撞检测最多等待正在执行的解析任务。
+    // 不并行时没有预注册，解析会注册ID，保持独占锁（任务中的共享锁作为重入处理）
+    if (ParallelSetupEnable)
+    {
+        idLock.unlock();
+    }
+    tasks.clear();
+    for (csmUint32 i = 0; i < jobs.size(); i++)
+    {
+        AssetJob* job = &jobs[i];
+        tasks.push_back([this, job]()
+        {
+            if (job->buffer == NULL)
+            {
+                return;
+            }
+
+            static const csmChar* const TracePhases[] = { "parse_expression", "parse_physics", "parse_pose", "parse_userdata" };
+            LAppLoadTracer::Scope trace(TracePhases[job->type], job->path.GetRawString(), job->size);
+
+            LAppPal::IdManagerMutex::SharedLock idShared(LAppPal::GetIdManagerMutex());
+
+            switch (job->type)
+            {
+            case AssetJob::Type_Expression:
+                job->motion = LoadExpression(job->buffer, job->size, job->name.GetRawString());
+                break;
+            case AssetJob::Type_Physics:
+                LoadPhysics(job->buffer, job->size);
+                break;
+            case AssetJob::Type_Pose:
+                LoadPose(job->buffer, job->size);
+                break;
+            case AssetJob::Type_UserData:
+                LoadUserData(job->buffer, job->size);
+                break;
+            }
+
+            DeleteBuffer(job->buffer, job->path.GetRawString());
+            job->buffer = NULL;
+        });
+    }
+    RunTasks(tasks);
+    if (ParallelSetupEnable)
+    {
+        idLock.lock();
+    }
+
+    // 第4阶段：在调用线程上汇总结果
+    for (csmUint32 i = 0; i < jobs.size(); i++)
+    {
+        if (jobs[i].type != AssetJob::Type_Expression)
+        {
+            continue;
+        }
+
+        csmMap<csmString, ACubismMotion*>& expressions = _assets->expressions;
+        if (expressions[jobs[i].name] != NULL)
+        {
+            ACubismMotion::Delete(expressions[jobs[i].name]);
+        }
+        expressions[jobs[i].name] = jobs[i].motion;
+    }
+    _assets->expressionsLoaded = true;
+
+    //EyeBlink
+    if (_modelSetting->GetEyeBlinkParameterCount() > 0)
+    {
+        _eyeBlink = CubismEyeBlink::Create(_modelSetting);
+    }
+
+    //Breath
+    {
+        _breath = CubismBreath::Create();
+
+        csmVector<CubismBreath::BreathParameterData> breathParameters;
+
+        breathParameters.PushBack(CubismBreath::BreathParameterData(_idParamAngleX, 0.0f, 15.0f, 6.5345f, 0.5f));
+        breathParameters.PushBack(CubismBreath::BreathParameterData(_idParamAngleY, 0.0f, 8.0f, 3.5345f, 0.5f));
+        breathParameters.PushBack(CubismBreath::BreathParameterData(_idParamAngleZ, 0.0f, 10.0f, 5.5345f, 0.5f));
+        breathParameters.PushBack(CubismBreath::BreathParameterData(_idParamBodyAngleX, 0.0f, 4.0f, 15.5345f, 0.5f));
+        breathParameters.PushBack(CubismBreath::BreathParameterData(CubismFramework::GetIdManager()->GetId(ParamBreath), 0.5f, 0.5f, 3.2345f, 0.5f));
+
+        _breath->SetParameters(breathParameters);
+    }
+    idLock.unlock();
+
     if (_modelSetting == NULL || _modelMatrix == NULL)
     {
         LAppPal::PrintLog("Failed to SetupModel().");
@@ -246,60 +817,157 @@ void LAppModel::SetupModel(ICubismModelSetting* setting)
 
     _model->SaveParameters();
 
+    _motionManager->StopAllMotions();
+
+    _updating = false;
+    _initialized = true;
+}
+
+void LAppModel::LoadLipSyncEnvelopes()
+{
+    csmMap<csmString, LAppLipSyncEnvelope*>& envelopes = _assets->lipSyncEnvelopes;
     for (csmInt32 i = 0; i < _modelSetting->GetMotionGroupCount(); i++)
     {
         const csmChar* group = _modelSetting->GetMotionGroupName(i);
-        PreloadMotionGroup(group);
-    }
+        for (csmInt32 no = 0; no < _modelSetting->GetMotionCount(group); no++)
+        {
+            csmString voice = _modelSetting->GetMotionSoundFileName(group, no);
+            if (strcmp(voice.GetRawString(), "") == 0)
+            {
+                continue;
+            }
 
-    _motionManager->StopAllMotions();
+            const csmString path = _modelHomeDir + voice;
+            if (envelopes.IsExist(path))
+            {
+                continue;
+            }
 
-    _updating = false;
-    _initialized = true;
+            // 失败时也记录为NULL，播放时改用LAppWavFileHandler
+            LAppLipSyncEnvelope* envelope = new LAppLipSyncEnvelope();
+            if (!envelope->Load(path.GetRawString()))
+            {
+                if (_debugMode)
+                {
+                    LAppPal::PrintLog("[APP]lip-sync envelope unavailable: %s", path.GetRawString());
+                }
+                delete envelope;
+                envelope = NULL;
+            }
+            envelopes[path] = envelope;
+        }
+    }
 }
 
-void LAppModel::PreloadMotionGroup(const csmChar* group)
+ACubismMotion* LAppModel::LoadMotionFromFile(const csmChar* group, csmInt32 no, csmSizeInt* outBytes)
 {
-    const csmInt32 count = _modelSetting->GetMotionCount(group);
+    csmString path = _modelSetting->GetMotionFileName(group, no);
+    path = _modelHomeDir + path;
 
-    for (csmInt32 i = 0; i < count; i++)
+    if (_debugMode)
     {
-        //ex) idle_0
-        csmString name = Utils::CubismString::GetFormatedString("%s_%d", group, i);
-        csmString path = _modelSetting->GetMotionFileName(group, i);
-        path = _modelHomeDir + path;
+        LAppPal::PrintLog("[APP]load motion: %s => [%s_%d] ", path.GetRawString(), group, no);
+    }
 
-        if (_debugMode)
+    ACubismMotion* motion = NULL;
+    csmSizeInt size;
+    csmByte* jsonBuffer = NULL;
+    csmSizeInt jsonSize = 0;
+
+    // 存在预编译的二进制动作时不解析JSON
+    const std::string binaryPath = LAppBinaryMotion::GetBinaryPath(path.GetRawString());
+    if (BinaryMotionEnable && LAppPal::IsFileExist(binaryPath))
+    {
+        // motion3.json存在时，仅当二进制动作由当前的motion3.json转换而来时使用（比较内容的哈希，远比解析便宜。
+        // 过期时读取的JSON直接用于下面的解析）
+        csmByte* buffer = CreateBuffer(binaryPath.c_str(), &size);
+        if (buffer != NULL && LAppPal::IsFileExist(path.GetRawString()))
+        {
+            jsonBuffer = CreateBuffer(path.GetRawString(), &jsonSize);
+        }
+        if (buffer != NULL && jsonBuffer != NULL && !LAppBinaryMotion::IsUpToDate(buffer, size, jsonBuffer, jsonSize))
         {
-            LAppPal::PrintLog("[APP]load motion: %s => [%s_%d] ", path.GetRawString(), group, i);
+            if (_debugMode)
+            {
+                LAppPal::PrintLog("[APP]stale binary motion, fall back to json: %s", binaryPath.c_str());
+            }
+            DeleteBuffer(buffer, binaryPath.c_str());
+            buffer = NULL;
         }
+        if (buffer != NULL)
+        {
+            LAppBinaryMotion* binaryMotion;
+            {
+                // 生成时会注册曲线的ID
+                std::lock_guard<LAppPal::IdManagerMutex> lock(LAppPal::GetIdManagerMutex());
+                LAppLoadTracer::Scope trace("parse_motion_binary", binaryPath.c_str(), size);
+                binaryMotion = LAppBinaryMotion::Create(buffer, size);
+            }
+            DeleteBuffer(buffer, binaryPath.c_str());
 
-        csmByte* buffer;
-        csmSizeInt size;
-        buffer = CreateBuffer(path.GetRawString(), &size);
-        CubismMotion* tmpMotion = static_cast<CubismMotion*>(LoadMotion(buffer, size, name.GetRawString()));
+            if (binaryMotion != NULL)
+            {
+                binaryMotion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
+                motion = binaryMotion;
+            }
+            else if (_debugMode)
+            {
+                LAppPal::PrintLog("[APP]invalid binary motion, fall back to json: %s", binaryPath.c_str());
+            }
+        }
+    }
 
-        csmFloat32 fadeTime = _modelSetting->GetMotionFadeInTimeValue(group, i);
-        if (fadeTime >= 0.0f)
+    if (motion == NULL)
+    {
+        csmByte* buffer = jsonBuffer;
+        size = jsonSize;
+        jsonBuffer = NULL;
+        if (buffer == NULL)
+        {
+            buffer = CreateBuffer(path.GetRawString(), &size);
+        }
+        if (buffer == NULL)
         {
-            tmpMotion->SetFadeInTime(fadeTime);
+            return NULL;
         }
 
-        fadeTime = _modelSetting->GetMotionFadeOutTimeValue(group, i);
-        if (fadeTime >= 0.0f)
+        CubismMotion* jsonMotion;
         {
-            tmpMotion->SetFadeOutTime(fadeTime);
+            // 解析时会注册曲线的ID
+            std::lock_guard<LAppPal::IdManagerMutex> lock(LAppPal::GetIdManagerMutex());
+            LAppLoadTracer::Scope trace("parse_motion", path.GetRawString(), size);
+            jsonMotion = static_cast<CubismMotion*>(LoadMotion(buffer, size, NULL));
         }
-        tmpMotion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
+        DeleteBuffer(buffer, path.GetRawString());
 
-        if (_motions[name] != NULL)
+        if (jsonMotion == NULL)
         {
-            ACubismMotion::Delete(_motions[name]);
+            return NULL;
         }
-        _motions[name] = tmpMotion;
+        jsonMotion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
+        motion = jsonMotion;
+    }
+    else if (jsonBuffer != NULL)
+    {
+        DeleteBuffer(jsonBuffer, path.GetRawString());
+    }
 
-        DeleteBuffer(buffer, path.GetRawString());
+    csmFloat32 fadeTime = _modelSetting->GetMotionFadeInTimeValue(group, no);
+    if (fadeTime >= 0.0f)
+    {
+        motion->SetFadeInTime(fadeTime);
     }
+
+    fadeTime = _modelSetting->GetMotionFadeOutTimeValue(group, no);
+    if (fadeTime >= 0.0f)
+    {
+        motion->SetFadeOutTime(fadeTime);
+    }
+
+    // 解析后的曲线数据与文件的大小大致成比例，以文件大小估算
+    *outBytes = size;
+
+    return motion;
 }
 
 void LAppModel::ReleaseMotionGroup(const csmChar* group) const
@@ -316,36 +984,6 @@ void LAppModel::ReleaseMotionGroup(const csmChar* group) const
     }
 }
 
-/**
-* @brief すべてのモーションデータの解放
-*
-* すべてのモーションデータを解放する。
-*/
-void LAppModel::ReleaseMotions()
-{
-    for (csmMap<csmString, ACubismMotion*>::const_iterator iter = _motions.Begin(); iter != _motions.End(); ++iter)
-    {
-        ACubismMotion::Delete(iter->Second);
-    }
-
-    _motions.Clear();
-}
-
-/**
-* @brief すべての表情データの解放
-*
-* すべての表情データを解放する。
-*/
-void LAppModel::ReleaseExpressions()
-{
-    for (csmMap<csmString, ACubismMotion*>::const_iterator iter = _expressions.Begin(); iter != _expressions.End(); ++iter)
-    {
-        ACubismMotion::Delete(iter->Second);
-    }
-
-    _expressions.Clear();
-}
-
 void LAppModel::Update()
 {
     const csmFloat32 deltaTimeSeconds = LAppPal::GetDeltaTime();
@@ -368,6 +1006,7 @@ void LAppModel::Update()
     else
     {
         motionUpdated = _motionManager->UpdateMotion(_model, deltaTimeSeconds); // モーションを更新
+        DispatchFinishedMotions();
     }
     _model->SaveParameters(); // 状態を保存
     //-----------------------------------------------------------------
@@ -421,11 +1060,25 @@ void LAppModel::Update()
         // リアルタイムでリップシンクを行う場合、システムから音量を取得して0〜1の範囲で値を入力します。
         csmFloat32 value = 0.0f;
 
-        // 状態更新/RMS値取得
-        _wavFileHandler.Update(deltaTimeSeconds);
-        value = _wavFileHandler.GetRms();
+        // 状態更新/RMS値取得。包絡がある音声は表を引くだけでPCMを走査しない
+        if (_lipSyncEnvelope != NULL)
+        {
+            _lipSyncSeconds += deltaTimeSeconds;
+            value = _lipSyncEnvelope->GetValue(_lipSyncSeconds);
+        }
+        else
+        {
+            _wavFileHandler.Update(deltaTimeSeconds);
+            value = _wavFileHandler.GetRms();
+        }
+
+        // 外部流接收中时优先使用其值（语音的时间照常推进）
+        if (_externalLipSync)
+        {
+            value = _externalLipSyncValue;
+        }
 
-        for (csmUint32 i = 0; i < _lipSyncIds.GetSize(); ++i)
+        for (csmInt32 i = 0; i < _lipSyncIds.GetSize(); ++i)
         {
             _model->AddParameterValue(_lipSyncIds[i], value, 0.8f);
         }
@@ -461,54 +1114,56 @@ CubismMotionQueueEntryHandle LAppModel::StartMotion(const csmChar* group, csmInt
         LAppPal::PrintLog("[APP]motion index out of range. ID:[%d] Range:[%d]", no, count);
         return InvalidMotionQueueEntryHandleValue;
     }
-    const csmString fileName = _modelSetting->GetMotionFileName(group, no);
     //ex) idle_0
     csmString name = Utils::CubismString::GetFormatedString("%s_%d", group, no);
-    CubismMotion* motion = static_cast<CubismMotion*>(_motions[name.GetRawString()]);
-    csmBool autoDelete = false;
+    ACubismMotion* motion = _assets->motionCache.Find(name);
 
     if (motion == NULL)
     {
-        csmString path = fileName;
-        path = _modelHomeDir + path;
-
-        csmByte* buffer;
-        csmSizeInt size;
-        buffer = CreateBuffer(path.GetRawString(), &size);
-        motion = static_cast<CubismMotion*>(LoadMotion(buffer, size, NULL, onFinishedMotionHandler));
-        csmFloat32 fadeTime = _modelSetting->GetMotionFadeInTimeValue(group, no);
-        if (fadeTime >= 0.0f)
-        {
-            motion->SetFadeInTime(fadeTime);
-        }
-
-        fadeTime = _modelSetting->GetMotionFadeOutTimeValue(group, no);
-        if (fadeTime >= 0.0f)
+        // 首次使用时解析，之后留在缓存中
+        csmSizeInt bytes = 0;
+        motion = LoadMotionFromFile(group, no, &bytes);
+        if (motion == NULL)
         {
-            motion->SetFadeOutTime(fadeTime);
+            return InvalidMotionQueueEntryHandleValue;
         }
-        motion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
-        autoDelete = true; // 終了時にメモリから削除
-
-        DeleteBuffer(buffer, path.GetRawString());
-    }
-    else
-    {
-        motion->SetFinishedMotionHandler(onFinishedMotionHandler);
+        _assets->motionCache.Add(name, motion, bytes);
     }
+
     //voice
     csmString voice = _modelSetting->GetMotionSoundFileName(group, no);
     if (strcmp(voice.GetRawString(), "") != 0)
     {
         csmString path = voice;
         path = _modelHomeDir + path;
-        _wavFileHandler.Start(path);
+
+        // 包絡の読み込みに失敗した音声は従来通りwavから計算する
+        _lipSyncEnvelope = _assets->lipSyncEnvelopes.IsExist(path) ? _assets->lipSyncEnvelopes[path] : NULL;
+        _lipSyncSeconds = 0.0f;
+        if (_lipSyncEnvelope == NULL)
+        {
+            _wavFileHandler.Start(path);
+        }
     }
     if (_debugMode)
     {
         LAppPal::PrintLog("[APP]start motion: [%s_%d]", group, no);
     }
-    return  _motionManager->StartMotionPriority(motion, autoDelete, priority);
+    const CubismMotionQueueEntryHandle handle = _motionManager->StartMotionPriority(motion, false, priority);
+    // 播放中的动作不会被淘汰
+    _assets->motionCache.Pin(name, _motionManager, handle);
+
+    // 动作由其他实例共享，SetFinishedMotionHandler会覆盖其他实例的回调函数，因此按本实例的句柄保存
+    if (onFinishedMotionHandler != NULL)
+    {
+        FinishedMotionHandler finished;
+        finished.handle = handle;
+        finished.motion = motion;
+        finished.callback = onFinishedMotionHandler;
+        _finishedMotionHandlers.push_back(finished);
+    }
+
+    return handle;
 }
 
 CubismMotionQueueEntryHandle LAppModel::StartRandomMotion(const csmChar* group, csmInt32 priority, ACubismMotion::FinishedMotionCallback onFinishedMotionHandler)
@@ -521,6 +1176,23 @@ CubismMotionQueueEntryHandle LAppModel::StartRandomMotion(const csmChar* group,
     return StartMotion(group, no, priority, onFinishedMotionHandler);
 }
 
+void LAppModel::DispatchFinishedMotions()
+{
+    for (csmUint32 i = 0; i < _finishedMotionHandlers.size();)
+    {
+        if (!_motionManager->IsFinished(_finishedMotionHandlers[i].handle))
+        {
+            i++;
+            continue;
+        }
+
+        // 回调函数中可能开始新的动作，先从列表中移除
+        const FinishedMotionHandler finished = _finishedMotionHandlers[i];
+        _finishedMotionHandlers.erase(_finishedMotionHandlers.begin() + i);
+        finished.callback(finished.motion);
+    }
+}
+
 void LAppModel::DoDraw()
 {
     if (_model == NULL)
@@ -542,6 +1214,13 @@ void LAppModel::Draw(CubismMatrix44& matrix)
 
     GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->SetMvpMatrix(&matrix);
 
+    // 记录纹理的使用（超出显存预算被淘汰的纹理在此开始重新读取，上传前绘制为透明）
+    LAppTextureManager* textureManager = LAppDelegate::GetInstance()->GetTextureManager();
+    for (csmUint32 i = 0; i < _textureIds.size(); i++)
+    {
+        textureManager->UseTexture(_textureIds[i]);
+    }
+
     DoDraw();
 }
 
@@ -557,7 +1236,12 @@ csmBool LAppModel::HitTest(const csmChar* hitAreaName, csmFloat32 x, csmFloat32
     {
         if (strcmp(_modelSetting->GetHitAreaName(i), hitAreaName) == 0)
         {
-            const CubismIdHandle drawID = _modelSetting->GetHitAreaId(i);
+            CubismIdHandle drawID;
+            {
+                // GetHitAreaId经由CubismIdManager取得ID
+                std::lock_guard<LAppPal::IdManagerMutex> lock(LAppPal::GetIdManagerMutex());
+                drawID = _modelSetting->GetHitAreaId(i);
+            }
             return IsHit(drawID, x, y);
         }
     }
@@ -566,11 +1250,12 @@ csmBool LAppModel::HitTest(const csmChar* hitAreaName, csmFloat32 x, csmFloat32
 
 void LAppModel::SetExpression(const csmChar* expressionID)
 {
-    if (!_expressions.IsExist(expressionID))
+    csmMap<csmString, ACubismMotion*>& expressions = _assets->expressions;
+    if (!expressions.IsExist(expressionID))
     {
-        LAppPal::PrintLog("[APP]expression index out of range. ID:[%d] Range:[%d]", expressionID, _expressions.GetSize());
+        LAppPal::PrintLog("[APP]expression index out of range. ID:[%d] Range:[%d]", expressionID, expressions.GetSize());
     }
-    ACubismMotion* motion = _expressions[expressionID];
+    ACubismMotion* motion = expressions[expressionID];
     if (_debugMode)
     {
         LAppPal::PrintLog("[APP]expression: [%s]", expressionID);
@@ -588,15 +1273,16 @@ void LAppModel::SetExpression(const csmChar* expressionID)
 
 void LAppModel::SetRandomExpression()
 {
-    if (_expressions.GetSize() == 0)
+    const csmMap<csmString, ACubismMotion*>& expressions = _assets->expressions;
+    if (expressions.GetSize() == 0)
     {
         return;
     }
 
-    csmInt32 no = rand() % _expressions.GetSize();
+    csmInt32 no = rand() % expressions.GetSize();
     csmMap<csmString, ACubismMotion*>::const_iterator map_ite;
     csmInt32 i = 0;
-    for (map_ite = _expressions.Begin(); map_ite != _expressions.End(); map_ite++)
+    for (map_ite = expressions.Begin(); map_ite != expressions.End(); map_ite++)
     {
         if (i == no)
         {
@@ -608,17 +1294,35 @@ void LAppModel::SetRandomExpression()
     }
 }
 
+void LAppModel::SetExternalLipSync(csmBool enabled, csmFloat32 value)
+{
+    _externalLipSync = enabled;
+    _externalLipSyncValue = value;
+}
+
 void LAppModel::ReloadRenderer()
 {
     DeleteRenderer();
 
     CreateRenderer();
 
+    // 先重新取得纹理再释放旧的引用，避免只被本实例使用的纹理被删除后重新读取
+    std::vector<GLuint> oldTextureIds;
+    oldTextureIds.swap(_textureIds);
+
     SetupTextures();
+
+    LAppTextureManager* textureManager = LAppDelegate::GetInstance()->GetTextureManager();
+    for (csmUint32 i = 0; i < oldTextureIds.size(); i++)
+    {
+        textureManager->ReleaseTexture(oldTextureIds[i]);
+    }
 }
 
 void LAppModel::SetupTextures()
 {
+    std::vector<csmInt32> textureNumbers;
+    std::vector<std::string> texturePaths;
     for (csmInt32 modelTextureNumber = 0; modelTextureNumber < _modelSetting->GetTextureCount(); modelTextureNumber++)
     {
         // テクスチャ名が空文字だった場合はロード・バインド処理をスキップ
@@ -627,15 +1331,34 @@ void LAppModel::SetupTextures()
             continue;
         }
 
-        //OpenGLのテクスチャユニットにテクスチャをロードする
         csmString texturePath = _modelSetting->GetTextureFileName(modelTextureNumber);
         texturePath = _modelHomeDir + texturePath;
 
-        LAppTextureManager::TextureInfo* texture = LAppDelegate::GetInstance()->GetTextureManager()->CreateTextureFromPngFile(texturePath.GetRawString());
-        const csmInt32 glTextueNumber = texture->id;
+        textureNumbers.push_back(modelTextureNumber);
+        texturePaths.push_back(texturePath.GetRawString());
+    }
+
+    //OpenGLのテクスチャユニットにテクスチャをロードする（デコードは並列に行う）
+    LAppTextureManager* textureManager = LAppDelegate::GetInstance()->GetTextureManager();
+    std::vector<LAppTextureManager::TextureInfo*> textures;
+    textureManager->CreateTexturesFromPngFiles(texturePaths, textures, _textureQuality);
+
+    for (csmUint32 i = 0; i < textures.size(); i++)
+    {
+        if (textures[i] == NULL)
+        {
+            continue;
+        }
+
+        // 与异步加载中的模型共享的纹理先完成流式上传
+        if (textures[i]->streaming)
+        {
+            textureManager->FinishTextureStreaming(textures[i]->id);
+        }
 
         //OpenGL
-        GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->BindTexture(modelTextureNumber, glTextueNumber);
+        GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->BindTexture(textureNumbers[i], textures[i]->id);
+        _textureIds.push_back(textures[i]->id);
     }
 
 #ifdef PREMULTIPLIED_ALPHA_ENABLE
@@ -646,6 +1369,26 @@ void LAppModel::SetupTextures()
 
 }
 
+void LAppModel::SetTextureQuality(LAppTextureManager::TextureQuality quality)
+{
+    _textureQuality = quality;
+}
+
+void LAppModel::ReleaseTextures()
+{
+    if (_textureIds.empty())
+    {
+        return;
+    }
+
+    LAppTextureManager* textureManager = LAppDelegate::GetInstance()->GetTextureManager();
+    for (csmUint32 i = 0; i < _textureIds.size(); i++)
+    {
+        textureManager->ReleaseTexture(_textureIds[i]);
+    }
+    _textureIds.clear();
+}
+
 void LAppModel::MotionEventFired(const csmString& eventValue)
 {
     CubismLogInfo("%s is fired on LAppModel!!", eventValue.GetRawString());
@@ -656,6 +1399,236 @@ Csm::Rendering::CubismOffscreenFrame_OpenGLES2& LAppModel::GetRenderBuffer()
     return _renderBuffer;
 }
 
+csmBool LAppModel::ReloadAsset(const csmChar* fileName)
+{
+    if (_modelSetting == NULL)
+    {
+        return true;
+    }
+
+    const std::string changed = LAppBundle::NormalizePath(fileName);
+
+    // model3.json、moc3的变更需要重新加载整个模型
+    if (LAppBundle::NormalizePath(_assets->key) == LAppBundle::NormalizePath(std::string(_modelHomeDir.GetRawString()) + changed)
+        || LAppBundle::NormalizePath(_modelSetting->GetModelFileName()) == changed)
+    {
+        return false;
+    }
+
+    //Expression（旧表情由ReloadSharedAsset释放，先停止播放）
+    for (csmInt32 i = 0; i < _modelSetting->GetExpressionCount(); i++)
+    {
+        if (LAppBundle::NormalizePath(_modelSetting->GetExpressionFileName(i)) == changed)
+        {
+            _expressionManager->StopAllMotions();
+            return true;
+        }
+    }
+
+    //Motion（从缓存中移除前先停止播放）
+    for (csmInt32 i = 0; i < _modelSetting->GetMotionGroupCount(); i++)
+    {
+        const csmChar* group = _modelSetting->GetMotionGroupName(i);
+        for (csmInt32 no = 0; no < _modelSetting->GetMotionCount(group); no++)
+        {
+            const std::string motionFile = LAppBundle::NormalizePath(_modelSetting->GetMotionFileName(group, no));
+            if (motionFile == changed || LAppBinaryMotion::GetBinaryPath(motionFile) == changed)
+            {
+                // 停止的动作不调用回调函数（与CubismMotionQueueManager相同），动作随后被释放
+                _motionManager->StopAllMotions();
+                _finishedMotionHandlers.clear();
+                return true;
+            }
+        }
+    }
+
+    //Physics
+    if (strcmp(_modelSetting->GetPhysicsFileName(), "") != 0 && LAppBundle::NormalizePath(_modelSetting->GetPhysicsFileName()) == changed)
+    {
+        csmString path = _modelSetting->GetPhysicsFileName();
+        path = _modelHomeDir + path;
+
+        csmSizeInt size;
+        csmByte* buffer = CreateBuffer(path.GetRawString(), &size);
+        if (buffer != NULL)
+        {
+            CubismPhysics::Delete(_physics);
+            _physics = NULL;
+            {
+                std::lock_guard<LAppPal::IdManagerMutex> lock(LAppPal::GetIdManagerMutex());
+                LoadPhysics(buffer, size);
+            }
+            DeleteBuffer(buffer, path.GetRawString());
+
+            LAppPal::PrintLog("[APP]reload physics: %s", path.GetRawString());
+        }
+        return true;
+    }
+
+    //Pose
+    if (strcmp(_modelSetting->GetPoseFileName(), "") != 0 && LAppBundle::NormalizePath(_modelSetting->GetPoseFileName()) == changed)
+    {
+        csmString path = _modelSetting->GetPoseFileName();
+        path = _modelHomeDir + path;
+
+        csmSizeInt size;
+        csmByte* buffer = CreateBuffer(path.GetRawString(), &size);
+        if (buffer != NULL)
+        {
+            CubismPose::Delete(_pose);
+            _pose = NULL;
+            {
+                std::lock_guard<LAppPal::IdManagerMutex> lock(LAppPal::GetIdManagerMutex());
+                LoadPose(buffer, size);
+            }
+            DeleteBuffer(buffer, path.GetRawString());
+
+            LAppPal::PrintLog("[APP]reload pose: %s", path.GetRawString());
+        }
+        return true;
+    }
+
+    //UserData
+    if (strcmp(_modelSetting->GetUserDataFile(), "") != 0 && LAppBundle::NormalizePath(_modelSetting->GetUserDataFile()) == changed)
+    {
+        csmString path = _modelSetting->GetUserDataFile();
+        path = _modelHomeDir + path;
+
+        csmSizeInt size;
+        csmByte* buffer = CreateBuffer(path.GetRawString(), &size);
+        if (buffer != NULL)
+        {
+            CubismModelUserData::Delete(_modelUserData);
+            _modelUserData = NULL;
+            {
+                std::lock_guard<LAppPal::IdManagerMutex> lock(LAppPal::GetIdManagerMutex());
+                LoadUserData(buffer, size);
+            }
+            DeleteBuffer(buffer, path.GetRawString());
+
+            LAppPal::PrintLog("[APP]reload user data: %s", path.GetRawString());
+        }
+        return true;
+    }
+
+    return true;
+}
+
+void LAppModel::ReloadSharedAsset(const csmChar* fileName)
+{
+    if (_modelSetting == NULL)
+    {
+        return;
+    }
+
+    const std::string changed = LAppBundle::NormalizePath(fileName);
+
+    //Expression
+    for (csmInt32 i = 0; i < _modelSetting->GetExpressionCount(); i++)
+    {
+        if (LAppBundle::NormalizePath(_modelSetting->GetExpressionFileName(i)) != changed)
+        {
+            continue;
+        }
+
+        const csmString name = _modelSetting->GetExpressionName(i);
+        csmString path = _modelSetting->GetExpressionFileName(i);
+        path = _modelHomeDir + path;
+
+        csmSizeInt size;
+        csmByte* buffer = CreateBuffer(path.GetRawString(), &size);
+        if (buffer == NULL)
+        {
+            return;
+        }
+        ACubismMotion* motion;
+        {
+            std::lock_guard<LAppPal::IdManagerMutex> lock(LAppPal::GetIdManagerMutex());
+            motion = LoadExpression(buffer, size, name.GetRawString());
+        }
+        DeleteBuffer(buffer, path.GetRawString());
+
+        if (motion != NULL)
+        {
+            csmMap<csmString, ACubismMotion*>& expressions = _assets->expressions;
+            if (expressions[name] != NULL)
+            {
+                ACubismMotion::Delete(expressions[name]);
+            }
+            expressions[name] = motion;
+        }
+
+        LAppPal::PrintLog("[APP]reload expression: %s", path.GetRawString());
+        return;
+    }
+
+    //Motion
+    for (csmInt32 i = 0; i < _modelSetting->GetMotionGroupCount(); i++)
+    {
+        const csmChar* group = _modelSetting->GetMotionGroupName(i);
+        for (csmInt32 no = 0; no < _modelSetting->GetMotionCount(group); no++)
+        {
+            const std::string motionFile = LAppBundle::NormalizePath(_modelSetting->GetMotionFileName(group, no));
+            if (motionFile != changed && LAppBinaryMotion::GetBinaryPath(motionFile) != changed)
+            {
+                continue;
+            }
+
+            // 从缓存中移除，下次播放时重新读取
+            const csmString name = Utils::CubismString::GetFormatedString("%s_%d", group, no);
+            _assets->motionCache.Remove(name);
+
+            LAppPal::PrintLog("[APP]reload motion: [%s]", name.GetRawString());
+            return;
+        }
+    }
+
+    //Voice
+    for (csmInt32 i = 0; i < _modelSetting->GetMotionGroupCount(); i++)
+    {
+        const csmChar* group = _modelSetting->GetMotionGroupName(i);
+        for (csmInt32 no = 0; no < _modelSetting->GetMotionCount(group); no++)
+        {
+            const csmChar* voice = _modelSetting->GetMotionSoundFileName(group, no);
+            if (strcmp(voice, "") == 0 || LAppBundle::NormalizePath(voice) != changed)
+            {
+                continue;
+            }
+
+            csmString path = voice;
+            path = _modelHomeDir + path;
+
+            // 播放中的处理器继续使用旧数据，下次播放时重新读取
+            LAppVoiceCache::GetInstance()->Remove(path.GetRawString());
+
+            // 其他实例可能正在引用，在原位置重新烘焙（失败时保留旧的包络）
+            csmMap<csmString, LAppLipSyncEnvelope*>& envelopes = _assets->lipSyncEnvelopes;
+            if (LipSyncEnvelopeEnable && envelopes.IsExist(path) && envelopes[path] != NULL)
+            {
+                envelopes[path]->Load(path.GetRawString());
+            }
+            else if (LipSyncEnvelopeEnable)
+            {
+                LAppLipSyncEnvelope* envelope = new LAppLipSyncEnvelope();
+                if (!envelope->Load(path.GetRawString()))
+                {
+                    delete envelope;
+                    envelope = NULL;
+                }
+                envelopes[path] = envelope;
+            }
+
+            LAppPal::PrintLog("[APP]reload voice: %s", path.GetRawString());
+            return;
+        }
+    }
+}
+
+const LAppModelRegistry::Assets* LAppModel::GetSharedAssets() const
+{
+    return _assets;
+}
+
 csmBool LAppModel::HasMocConsistencyFromFile(const csmChar* mocFileName)
 {
     CSM_ASSERT(strcmp(mocFileName, ""));
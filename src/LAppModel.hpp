@@ -7,13 +7,17 @@
 
 #pragma once
 
+#include <vector>
 #include <CubismFramework.hpp>
 #include <Model/CubismUserModel.hpp>
 #include <ICubismModelSetting.hpp>
 #include <Type/csmRectF.hpp>
 #include <Rendering/OpenGL/CubismOffscreenSurface_OpenGLES2.hpp>
 
+#include "LAppModelRegistry.hpp"
+#include "LAppTextureManager.hpp"
 #include "LAppWavFileHandler.hpp"
+#include "LAppLipSyncEnvelope.hpp"
 
  /**
   * @brief 用户实际使用的模型实现类
@@ -23,16 +27,22 @@
 
 构造函数和析构函数用于初始化和销毁类的实例。
 LoadAssets用于从指定的目录和文件名加载模型资源。
+PrepareAssets和UploadAssetsStep用于异步加载：前者在工作线程上读取和解析素材，后者在主线程上每帧执行一小步OpenGL处理。
 ReloadRenderer用于重建渲染器。
 Update用于更新模型的状态。
 Draw用于绘制模型。
 StartMotion和StartRandomMotion用于播放指定或随机选择的动画。
 SetExpression和SetRandomExpression用于设置指定或随机选择的表情。
+SetExternalLipSync用于以外部的值（实时PCM流的RMS）驱动口型同步。
 MotionEventFired用于接收动画事件触发。
 HitTest用于进行碰撞检测。
 GetRenderBuffer用于获取绘制缓冲区。
 HasMocConsistencyFromFile用于检查.moc3文件的一致性。
+ReloadAsset/ReloadSharedAsset用于热重载：只重新读取变更的素材。前者处理实例自己的物理运算、姿势、用户数据并停止使用旧的表情和动作，
+后者重新读取与其他实例共享的表情、动作和语音（每个共享素材只调用一次）。GetSharedAssets用于判断实例是否共享素材。
+SetTextureQuality用于设置纹理的读取质量（需在LoadAssets或PrepareAssets之前调用）。
 另外，还有一些私有方法和成员变量，用于在类内部处理模型的加载、纹理设置、动画和表情的加载与释放等功能。
+同一个model3.json的多个实例通过LAppModelRegistry共享模型设置、moc、表情和动作，每个实例只持有参数状态和动作队列等可变数据。
 
   */
 class LAppModel : public Csm::CubismUserModel
@@ -55,6 +65,38 @@ public:
      */
     void LoadAssets(const Csm::csmChar* dir, const  Csm::csmChar* fileName);
 
+    /**
+     * @brief 读取并解析模型的所有素材，解码纹理图像（不调用OpenGL）
+     *         可以在工作线程上调用。之后需在主线程上调用UploadAssetsStep直到返回true。
+     *
+     *         指定budgetBytes时，解析设置后先按文件大小和PNG的IHDR估算需要的内存，
+     *         超出剩余预算时不读取moc、不解码纹理，直接返回false（IsOverBudget返回true）；未超出时从预算中扣除。
+     *
+     * @param[in]   dir         model3.json所在目录
+     * @param[in]   fileName    model3.json的文件名
+     * @param[in,out] budgetBytes   剩余的字节预算（为NULL时不限制）
+     * @return                  模型生成成功时返回true
+     */
+    Csm::csmBool PrepareAssets(const Csm::csmChar* dir, const Csm::csmChar* fileName, Csm::csmSizeInt* budgetBytes = NULL);
+
+    /**
+     * @brief 执行PrepareAssets之后的一步OpenGL处理
+     *         第一次调用创建渲染器，之后每次上传一张纹理。需在主线程上调用。
+     *         流式上传时纹理先绑定占位纹理，LAppTextureManager::EndFrame分帧上传完成后替换为实际的纹理。
+     *
+     * @param[in]   streamTextures  为true时通过LAppTextureManager::CreateTextureStreamed上传（每帧调用EndFrame时使用）
+     * @return  所有处理完成、可以绘制时返回true
+     */
+    Csm::csmBool UploadAssetsStep(Csm::csmBool streamTextures = false);
+
+    /**
+     * @brief PrepareAssets因超出预算而中止时返回true
+     */
+    Csm::csmBool IsOverBudget() const
+    {
+        return _overBudget;
+    }
+
     /**
      * @brief 重建渲染器
      *
@@ -108,6 +150,15 @@ public:
      */
     void SetRandomExpression();
 
+    /**
+     * @brief 设置外部的口型同步值
+     *         有效期间口型参数使用该值代替动作语音的RMS（LAppLive2DManager每帧设置实时流的RMS）。
+     *
+     * @param[in]   enabled     是否使用外部的值
+     * @param[in]   value       口型同步值（0～1）
+     */
+    void SetExternalLipSync(Csm::csmBool enabled, Csm::csmFloat32 value);
+
     /**
     * @brief 接收事件触发
     *
@@ -137,6 +188,39 @@ public:
      */
     Csm::csmBool HasMocConsistencyFromFile(const Csm::csmChar* mocFileName);
 
+    /**
+     * @brief 重新读取变更的素材中本实例持有的部分（热重载）
+     *         物理运算、姿势和用户数据立即重新读取。表情和动作变更时停止播放，
+     *         之后由共享这些素材的任意一个实例调用ReloadSharedAsset重新读取。
+     *         纹理由LAppTextureManager::ReloadTexture重新读取。需在主线程上调用。
+     *
+     * @param[in]   fileName    变更的文件（相对于model3.json所在目录的路径）
+     * @return      model3.json或moc3变更、需要重新加载整个模型时返回false
+     */
+    Csm::csmBool ReloadAsset(const Csm::csmChar* fileName);
+
+    /**
+     * @brief 重新读取变更的素材中与其他实例共享的部分（热重载）
+     *         表情立即重新读取，动作从缓存中移除（下次播放时重新读取），语音的口型同步包络在原位置重新烘焙。
+     *         每个共享素材只需调用一次，需在共享素材的所有实例调用ReloadAsset之后调用。
+     *
+     * @param[in]   fileName    变更的文件（相对于model3.json所在目录的路径）
+     */
+    void ReloadSharedAsset(const Csm::csmChar* fileName);
+
+    /**
+     * @brief 获取与同一模型的其他实例共享的素材（加载前为NULL）
+     */
+    const LAppModelRegistry::Assets* GetSharedAssets() const;
+
+    /**
+     * @brief 设置纹理的读取质量
+     *         需在LoadAssets或PrepareAssets之前调用。UV为归一化坐标，缩小纹理不需要修改模型。
+     *
+     * @param[in]   quality     读取质量
+     */
+    void SetTextureQuality(LAppTextureManager::TextureQuality quality);
+
 protected:
     /**
      *  @brief  绘制模型处理。传递绘制模型空间的View-Projection矩阵。
@@ -148,6 +232,10 @@ private:
     /**
      * @brief 从model3.json创建模型。
      *         根据model3.json的描述创建模型、动作、物理运算等组件。
+     *         moc、表情、物理运算、姿势和用户数据在LAppTaskPool上并行读取和解析，
+     *         汇总后才调用SaveParameters。依赖OpenGL的CreateRenderer、SetupTextures不在此处执行。
+     *         动作不在此处读取，首次播放时才解析并放入共享的动作缓存。
+     *         同一个model3.json的moc和表情已由其他实例加载时，只从共享的moc生成本实例的模型。
      *
      * @param[in]   setting     ICubismModelSetting的实例
      *
@@ -161,12 +249,29 @@ private:
     void SetupTextures();
 
     /**
-     * @brief 从组名一次性加载动作数据。
-     *           动作数据的名称在内部从ModelSetting获取。
+     * @brief 释放本实例持有引用的纹理
+     *         其他模型仍在使用的纹理只减少引用计数。
+     *
+     */
+    void ReleaseTextures();
+
+    /**
+     * @brief 调用本实例已结束的动作的回调函数
+     *         动作由同一模型的实例共享，回调函数不保存在动作中，而是按本实例的队列句柄保存。在UpdateMotion之后调用。
      *
-     * @param[in]   group  动作数据的组名
      */
-    void PreloadMotionGroup(const Csm::csmChar* group);
+    void DispatchFinishedMotions();
+
+    /**
+     * @brief 从文件读取并解析动作
+     *           淡入淡出时间和效果ID按ModelSetting设置。
+     *
+     * @param[in]   group       动作数据的组名
+     * @param[in]   no          组内编号
+     * @param[out]  outBytes    动作占用的字节数（估算）
+     * @return                  动作。读取失败时返回NULL
+     */
+    Csm::ACubismMotion* LoadMotionFromFile(const Csm::csmChar* group, Csm::csmInt32 no, Csm::csmSizeInt* outBytes);
 
     /**
      * @brief 从组名一次性释放动作数据。
@@ -177,26 +282,26 @@ private:
     void ReleaseMotionGroup(const Csm::csmChar* group) const;
 
     /**
-    * @brief 释放所有动作数据
-    *
-    * 释放所有动作数据。
-    */
-    void ReleaseMotions();
+     * @brief 读取或烘焙所有动作语音的口型同步包络
+     *           同一模型的实例共享，已读取的语音跳过。在PrepareAssets中调用。
+     */
+    void LoadLipSyncEnvelopes();
 
     /**
-    * @brief 释放所有表情数据
-    *
-    * 释放所有表情数据。
-    */
-    void ReleaseExpressions();
+     * @brief 估算PrepareAssets读取素材和解码纹理需要的字节数
+     *           moc、表情、物理运算、姿势、用户数据按文件大小，纹理按IHDR的尺寸计算。其他实例已读取的moc和纹理不计。
+     *
+     * @param[in]   setting         模型设置
+     * @param[in]   sharedTextures  其他实例以相同质量持有纹理时为true
+     */
+    Csm::csmSizeInt EstimateLoadBytes(Csm::ICubismModelSetting* setting, Csm::csmBool sharedTextures) const;
 
-    Csm::ICubismModelSetting* _modelSetting; ///< 模型设置信息
+    Csm::ICubismModelSetting* _modelSetting; ///< 模型设置信息（由_assets持有）
     Csm::csmString _modelHomeDir; ///< 模型设置所在目录
     Csm::csmFloat32 _userTimeSeconds; ///< 累积的时间增量（秒）
     Csm::csmVector<Csm::CubismIdHandle> _eyeBlinkIds; ///< 模型中设置的眨眼功能参数ID
     Csm::csmVector<Csm::CubismIdHandle> _lipSyncIds; ///< 模型中设置的唇形同步功能参数ID
-    Csm::csmMap<Csm::csmString, Csm::ACubismMotion*>   _motions; ///< 已加载的动作列表
-    Csm::csmMap<Csm::csmString, Csm::ACubismMotion*>   _expressions; ///< 已加载的表情列表
+    LAppModelRegistry::Assets* _assets; ///< 与同一模型的其他实例共享的素材（设置、moc、表情、动作）
     Csm::csmVector<Csm::csmRectF> _hitArea;
     Csm::csmVector<Csm::csmRectF> _userArea;
     const Csm::CubismId* _idParamAngleX; ///< 参数ID: ParamAngleX
@@ -206,7 +311,48 @@ private:
     const Csm::CubismId* _idParamEyeBallX; ///< 参数ID: ParamEyeBallX
     const Csm::CubismId* _idParamEyeBallY; ///< 参数ID: ParamEyeBallY
 
-    LAppWavFileHandler _wavFileHandler; ///< wav文件处理器
+    LAppWavFileHandler _wavFileHandler; ///< wav文件处理器（没有包络的语音使用）
+    const LAppLipSyncEnvelope* _lipSyncEnvelope; ///< 播放中语音的口型同步包络（由_assets持有）
+    Csm::csmFloat32 _lipSyncSeconds; ///< 从语音开始经过的时间[秒]
+    Csm::csmBool _externalLipSync; ///< 是否使用外部的口型同步值
+    Csm::csmFloat32 _externalLipSyncValue; ///< 外部的口型同步值
 
     Csm::Rendering::CubismOffscreenFrame_OpenGLES2  _renderBuffer;   ///< 用于非帧缓冲区的绘制目标
+
+    /**
+     * @brief 等待上传的纹理
+     */
+    struct PendingTexture
+    {
+        Csm::csmInt32 modelTextureNumber;           ///< 模型中的纹理编号
+        LAppTextureManager::DecodedImage image;     ///< 解码后的图像
+    };
+
+    /**
+     * @brief 等待流式上传完成的纹理
+     */
+    struct StreamingTexture
+    {
+        Csm::csmInt32 modelTextureNumber;           ///< 模型中的纹理编号
+        GLuint textureId;                           ///< 上传完成后绑定的纹理ID
+    };
+
+    /**
+     * @brief 等待播放结束的动作的回调函数
+     */
+    struct FinishedMotionHandler
+    {
+        Csm::CubismMotionQueueEntryHandle handle;           ///< 本实例的动作队列句柄
+        Csm::ACubismMotion* motion;                         ///< 播放中的动作（共享）
+        Csm::ACubismMotion::FinishedMotionCallback callback; ///< 播放结束时调用的回调函数
+    };
+
+    std::vector<FinishedMotionHandler> _finishedMotionHandlers; ///< StartMotion指定的回调函数
+    std::vector<PendingTexture> _pendingTextures;   ///< PrepareAssets解码、等待UploadAssetsStep上传的纹理
+    std::vector<StreamingTexture> _streamingTextures; ///< 绑定了占位纹理、等待流式上传完成的纹理
+    Csm::csmUint32 _uploadedTextureCount;           ///< 已上传的纹理数
+    std::vector<GLuint> _textureIds;                ///< 本实例持有引用的纹理ID
+    LAppTextureManager::TextureQuality _textureQuality; ///< 纹理的读取质量
+    Csm::csmBool _overBudget;                       ///< PrepareAssets是否因超出预算而中止
+    Csm::csmBool _textureUser;                      ///< 是否已计入_assets->textureUsers
 };
@@ -0,0 +1,162 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppModelRegistry.hpp"
+#include "LAppDefine.hpp"
+#include "LAppPal.hpp"
+#include "LAppLipSyncEnvelope.hpp"
+
+using namespace Csm;
+using namespace LAppDefine;
+
+namespace
+{
+    LAppModelRegistry* s_instance = NULL;
+}
+
+LAppModelRegistry::Assets::Assets(const std::string& key)
+    : key(key)
+    , refCount(0)
+    , setting(NULL)
+    , moc(NULL)
+    , expressionsLoaded(false)
+    , motionCache(MotionCacheBudgetBytes)
+{
+}
+
+LAppModelRegistry::Assets::~Assets()
+{
+    motionCache.Clear();
+
+    for (csmMap<csmString, ACubismMotion*>::const_iterator iter = expressions.Begin(); iter != expressions.End(); ++iter)
+    {
+        ACubismMotion::Delete(iter->Second);
+    }
+    expressions.Clear();
+
+    for (csmMap<csmString, LAppLipSyncEnvelope*>::const_iterator iter = lipSyncEnvelopes.Begin(); iter != lipSyncEnvelopes.End(); ++iter)
+    {
+        delete iter->Second;
+    }
+    lipSyncEnvelopes.Clear();
+
+    // 所有实例的CubismModel释放后才能释放moc
+    if (moc != NULL)
+    {
+        CubismMoc::Delete(moc);
+    }
+
+    delete setting;
+}
+
+LAppModelRegistry* LAppModelRegistry::GetInstance()
+{
+    if (s_instance == NULL)
+    {
+        s_instance = new LAppModelRegistry();
+    }
+
+    return s_instance;
+}
+
+void LAppModelRegistry::ReleaseInstance()
+{
+    if (s_instance != NULL)
+    {
+        delete s_instance;
+    }
+
+    s_instance = NULL;
+}
+
+LAppModelRegistry::LAppModelRegistry()
+{
+}
+
+LAppModelRegistry::~LAppModelRegistry()
+{
+    // 正常情况下所有LAppModel已释放
+    for (std::map<std::string, Assets*>::iterator it = _entries.begin(); it != _entries.end(); ++it)
+    {
+        if (DebugLogEnable)
+        {
+            LAppPal::PrintLog("[APP]model assets still referenced: %s (%d)", it->first.c_str(), it->second->refCount);
+        }
+        delete it->second;
+    }
+    _entries.clear();
+}
+
+LAppModelRegistry::Assets* LAppModelRegistry::Acquire(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    Assets* assets;
+    std::map<std::string, Assets*>::iterator it = _entries.find(key);
+    if (it != _entries.end())
+    {
+        assets = it->second;
+    }
+    else
+    {
+        assets = new Assets(key);
+        _entries[key] = assets;
+    }
+    assets->refCount++;
+
+    if (DebugLogEnable)
+    {
+        LAppPal::PrintLog("[APP]acquire model assets: %s (%d)", key.c_str(), assets->refCount);
+    }
+
+    return assets;
+}
+
+void LAppModelRegistry::Release(Assets* assets)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        assets->refCount--;
+        if (assets->refCount > 0)
+        {
+            return;
+        }
+
+        // Invalidate后同一路径可能已注册了新的条目
+        std::map<std::string, Assets*>::iterator it = _entries.find(assets->key);
+        if (it != _entries.end() && it->second == assets)
+        {
+            _entries.erase(it);
+        }
+    }
+
+    if (DebugLogEnable)
+    {
+        LAppPal::PrintLog("[APP]release model assets: %s", assets->key.c_str());
+    }
+
+    delete assets;
+}
+
+void LAppModelRegistry::Invalidate(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::map<std::string, Assets*>::iterator it = _entries.find(key);
+    if (it != _entries.end())
+    {
+        _entries.erase(it);
+    }
+}
+
+csmUint32 LAppModelRegistry::GetEntryCount()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return static_cast<csmUint32>(_entries.size());
+}
@@ -0,0 +1,129 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <CubismFramework.hpp>
+#include <ICubismModelSetting.hpp>
+#include <Model/CubismMoc.hpp>
+#include <Motion/ACubismMotion.hpp>
+#include <Type/csmMap.hpp>
+#include "LAppMotionCache.hpp"
+
+class LAppLipSyncEnvelope;
+
+ /**
+ * @brief 模型素材注册表
+ *
+ * 按model3.json的路径保存多个LAppModel实例可以共享的不可变数据。
+ *
+ 这段代码定义了一个名为LAppModelRegistry的类（单例），用于让同一个model3.json的多个LAppModel共享已解析的数据。
+
+共享的数据：模型设置、moc（每个实例从同一个moc生成自己的CubismModel）、表情、动作缓存、语音的口型同步包络。
+纹理由LAppTextureManager按文件名和质量共享，各质量的纹理是否已读取按持有纹理的实例数判断（设置已解析不代表纹理存在）。
+每个实例只持有可变的状态：CubismModel（参数值）、动作队列、物理运算、姿势、眨眼和呼吸。
+
+GetInstance/ReleaseInstance：获取/释放类的实例。
+Acquire：获取指定路径的共享素材并增加引用计数。不存在时创建空的条目，由第一个加载的实例填充。
+Release：减少引用计数，为0时释放共享素材。
+Invalidate：从注册表中移除指定路径的共享素材，之后的Acquire重新加载（已持有的实例继续使用旧素材）。
+GetEntryCount：获取注册的模型数。
+ */
+class LAppModelRegistry
+{
+public:
+    /**
+    * @brief 同一个model3.json的共享素材
+    */
+    struct Assets
+    {
+        /**
+        * @brief 构造函数
+        */
+        Assets(const std::string& key);
+
+        /**
+        * @brief 析构函数。释放所有共享素材
+        */
+        ~Assets();
+
+        std::string key;                                                ///< model3.json的路径
+        Csm::csmUint32 refCount;                                        ///< 引用此素材的LAppModel数
+        Csm::ICubismModelSetting* setting;                              ///< 模型设置
+        Csm::CubismMoc* moc;                                            ///< moc。各实例的CubismModel由此生成
+        Csm::csmBool expressionsLoaded;                                 ///< 表情是否已加载
+        Csm::csmMap<Csm::csmString, Csm::ACubismMotion*> expressions;   ///< 表情
+        LAppMotionCache motionCache;                                    ///< 动作（首次播放时解析，按LRU淘汰）
+        Csm::csmMap<Csm::csmString, LAppLipSyncEnvelope*> lipSyncEnvelopes; ///< 按语音路径的口型同步包络（读取失败时为NULL）
+        std::mutex loadMutex;                                           ///< 加载时持有，同一模型的加载按顺序进行
+        std::mutex mocMutex;                                            ///< 保护moc的CreateModel/DeleteModel
+        std::map<Csm::csmInt32, Csm::csmUint32> textureUsers;           ///< 按纹理质量（LAppTextureManager::TextureQuality）持有纹理的实例数
+        std::mutex textureMutex;                                        ///< 保护textureUsers
+
+    private:
+        Assets(const Assets&);
+        Assets& operator=(const Assets&);
+    };
+
+    /**
+    * @brief   返回类的实例（单例）。如果实例尚未创建，将在内部创建实例。
+    *
+    * @return  类的实例
+    */
+    static LAppModelRegistry* GetInstance();
+
+    /**
+    * @brief   释放类的实例（单例）。
+    *
+    */
+    static void ReleaseInstance();
+
+    /**
+    * @brief 获取共享素材并增加引用计数（可以在工作线程上调用）
+    *
+    * @param[in]   key     model3.json的路径
+    * @return              共享素材。不存在时返回新创建的空条目
+    */
+    Assets* Acquire(const std::string& key);
+
+    /**
+    * @brief 减少引用计数。为0时释放共享素材
+    *
+    * @param[in]   assets  Acquire返回的共享素材
+    */
+    void Release(Assets* assets);
+
+    /**
+    * @brief 从注册表中移除共享素材，之后的Acquire返回新的空条目
+    *         已持有旧素材的实例继续使用，最后一个实例释放时释放。
+    *
+    * @param[in]   key     model3.json的路径
+    */
+    void Invalidate(const std::string& key);
+
+    /**
+    * @brief 获取注册的模型数
+    */
+    Csm::csmUint32 GetEntryCount();
+
+private:
+    /**
+    * @brief 构造函数
+    */
+    LAppModelRegistry();
+
+    /**
+    * @brief 析构函数
+    */
+    ~LAppModelRegistry();
+
+    std::map<std::string, Assets*> _entries;  ///< 路径到共享素材的映射
+    std::mutex _mutex;                        ///< 保护_entries
+};
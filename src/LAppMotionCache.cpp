@@ -0,0 +1,179 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppMotionCache.hpp"
+#include "LAppDefine.hpp"
+#include "LAppPal.hpp"
+
+using namespace Csm;
+using namespace LAppDefine;
+
+LAppMotionCache::LAppMotionCache(csmSizeInt budgetBytes)
+    : _budgetBytes(budgetBytes)
+    , _residentBytes(0)
+    , _hitCount(0)
+    , _missCount(0)
+    , _evictionCount(0)
+{
+}
+
+LAppMotionCache::~LAppMotionCache()
+{
+    Clear();
+}
+
+ACubismMotion* LAppMotionCache::Find(const csmString& name)
+{
+    std::map<std::string, EntryList::iterator>::iterator it = _index.find(name.GetRawString());
+    if (it == _index.end())
+    {
+        _missCount++;
+        return NULL;
+    }
+
+    // 移到开头（最近使用）
+    _entries.splice(_entries.begin(), _entries, it->second);
+    _hitCount++;
+
+    return it->second->motion;
+}
+
+void LAppMotionCache::Add(const csmString& name, ACubismMotion* motion, csmSizeInt bytes)
+{
+    Remove(name);
+
+    Entry entry;
+    entry.name = name.GetRawString();
+    entry.motion = motion;
+    entry.bytes = bytes;
+    _entries.push_front(entry);
+    _index[entry.name] = _entries.begin();
+    _residentBytes += bytes;
+
+    Evict(&_entries.front());
+}
+
+void LAppMotionCache::Pin(const csmString& name, CubismMotionManager* manager, CubismMotionQueueEntryHandle handle)
+{
+    std::map<std::string, EntryList::iterator>::iterator it = _index.find(name.GetRawString());
+    if (it == _index.end() || handle == InvalidMotionQueueEntryHandleValue)
+    {
+        return;
+    }
+
+    it->second->players.push_back(std::make_pair(manager, handle));
+}
+
+void LAppMotionCache::Unpin(CubismMotionManager* manager)
+{
+    for (EntryList::iterator it = _entries.begin(); it != _entries.end(); ++it)
+    {
+        for (csmUint32 i = 0; i < it->players.size();)
+        {
+            if (it->players[i].first == manager)
+            {
+                it->players.erase(it->players.begin() + i);
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+}
+
+void LAppMotionCache::Remove(const csmString& name)
+{
+    std::map<std::string, EntryList::iterator>::iterator it = _index.find(name.GetRawString());
+    if (it == _index.end())
+    {
+        return;
+    }
+
+    _residentBytes -= it->second->bytes;
+    ACubismMotion::Delete(it->second->motion);
+    _entries.erase(it->second);
+    _index.erase(it);
+}
+
+void LAppMotionCache::Clear()
+{
+    for (EntryList::iterator it = _entries.begin(); it != _entries.end(); ++it)
+    {
+        ACubismMotion::Delete(it->motion);
+    }
+
+    _entries.clear();
+    _index.clear();
+    _residentBytes = 0;
+}
+
+csmUint32 LAppMotionCache::GetHitCount() const
+{
+    return _hitCount;
+}
+
+csmUint32 LAppMotionCache::GetMissCount() const
+{
+    return _missCount;
+}
+
+csmUint32 LAppMotionCache::GetEvictionCount() const
+{
+    return _evictionCount;
+}
+
+csmSizeInt LAppMotionCache::GetResidentBytes() const
+{
+    return _residentBytes;
+}
+
+csmUint32 LAppMotionCache::GetEntryCount() const
+{
+    return static_cast<csmUint32>(_entries.size());
+}
+
+csmBool LAppMotionCache::IsPlaying(Entry& entry)
+{
+    for (csmUint32 i = 0; i < entry.players.size();)
+    {
+        if (entry.players[i].first->IsFinished(entry.players[i].second))
+        {
+            entry.players.erase(entry.players.begin() + i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    return !entry.players.empty();
+}
+
+void LAppMotionCache::Evict(const Entry* keep)
+{
+    EntryList::iterator it = _entries.end();
+    while (_residentBytes > _budgetBytes && it != _entries.begin())
+    {
+        --it;
+        if (&*it == keep || IsPlaying(*it))
+        {
+            continue;
+        }
+
+        if (DebugLogEnable)
+        {
+            LAppPal::PrintLog("[APP]evict motion: [%s]", it->name.c_str());
+        }
+
+        _residentBytes -= it->bytes;
+        ACubismMotion::Delete(it->motion);
+        _index.erase(it->name);
+        it = _entries.erase(it);
+        _evictionCount++;
+    }
+}
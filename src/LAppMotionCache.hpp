@@ -0,0 +1,155 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <CubismFramework.hpp>
+#include <Motion/ACubismMotion.hpp>
+#include <Motion/CubismMotionManager.hpp>
+
+ /**
+ * @brief 动作缓存
+ *
+ * 按名称（例如idle_0）保存已解析的动作，在字节预算内按LRU淘汰。
+ *
+ 这段代码定义了一个名为LAppMotionCache的类，用于在首次使用时解析动作并保留在内存中。
+
+Find：按名称查找动作。找到时计为命中并更新使用顺序，找不到时计为未命中。
+Add：添加新解析的动作，超出预算时从最久未使用的动作开始淘汰。
+Pin：记录正在CubismMotionManager中播放的动作。播放结束前该动作不会被淘汰。
+Unpin：删除指定CubismMotionManager的所有播放记录（释放CubismMotionManager之前调用）。
+Remove/Clear：释放指定的动作/所有动作。
+GetHitCount/GetMissCount/GetEvictionCount：获取命中、未命中、淘汰的次数。
+GetResidentBytes/GetEntryCount：获取常驻的字节数（估算）和动作数。
+ */
+class LAppMotionCache
+{
+public:
+    /**
+    * @brief 构造函数
+    *
+    * @param[in]   budgetBytes     常驻动作的字节预算。为0时只保留正在播放的动作
+    */
+    LAppMotionCache(Csm::csmSizeInt budgetBytes);
+
+    /**
+    * @brief 析构函数。释放所有动作
+    */
+    ~LAppMotionCache();
+
+    /**
+    * @brief 按名称查找动作
+    *
+    * @param[in]   name    动作名（例如idle_0）
+    * @return              缓存中的动作。不存在时返回NULL
+    */
+    Csm::ACubismMotion* Find(const Csm::csmString& name);
+
+    /**
+    * @brief 添加动作，超出预算时淘汰最久未使用的动作
+    *
+    * 同名的动作已存在时替换（旧动作正在播放时也会被释放，调用方需先停止播放）。
+    *
+    * @param[in]   name    动作名
+    * @param[in]   motion  动作。之后由缓存负责释放
+    * @param[in]   bytes   动作占用的字节数（估算）
+    */
+    void Add(const Csm::csmString& name, Csm::ACubismMotion* motion, Csm::csmSizeInt bytes);
+
+    /**
+    * @brief 记录正在播放的动作。在manager中播放结束之前不会被淘汰
+    *
+    * @param[in]   name    动作名
+    * @param[in]   manager 播放动作的CubismMotionManager
+    * @param[in]   handle  StartMotionPriority返回的识别号
+    */
+    void Pin(const Csm::csmString& name, Csm::CubismMotionManager* manager, Csm::CubismMotionQueueEntryHandle handle);
+
+    /**
+    * @brief 删除manager的所有播放记录
+    *         多个模型共享缓存时，释放模型的CubismMotionManager之前调用。
+    *
+    * @param[in]   manager 播放动作的CubismMotionManager
+    */
+    void Unpin(Csm::CubismMotionManager* manager);
+
+    /**
+    * @brief 释放指定的动作
+    *
+    * @param[in]   name    动作名
+    */
+    void Remove(const Csm::csmString& name);
+
+    /**
+    * @brief 释放所有动作
+    */
+    void Clear();
+
+    /**
+    * @brief 获取命中次数
+    */
+    Csm::csmUint32 GetHitCount() const;
+
+    /**
+    * @brief 获取未命中次数
+    */
+    Csm::csmUint32 GetMissCount() const;
+
+    /**
+    * @brief 获取淘汰次数
+    */
+    Csm::csmUint32 GetEvictionCount() const;
+
+    /**
+    * @brief 获取常驻的字节数（估算）
+    */
+    Csm::csmSizeInt GetResidentBytes() const;
+
+    /**
+    * @brief 获取常驻的动作数
+    */
+    Csm::csmUint32 GetEntryCount() const;
+
+private:
+    /**
+    * @brief 缓存条目
+    */
+    struct Entry
+    {
+        std::string name;                   ///< 动作名
+        Csm::ACubismMotion* motion;         ///< 动作
+        Csm::csmSizeInt bytes;              ///< 占用的字节数（估算）
+        std::vector<std::pair<Csm::CubismMotionManager*, Csm::CubismMotionQueueEntryHandle> > players; ///< 播放此动作的队列
+    };
+
+    /**
+    * @brief 判断条目是否正在播放。同时删除已结束的播放记录
+    */
+    static Csm::csmBool IsPlaying(Entry& entry);
+
+    /**
+    * @brief 从最久未使用的条目开始淘汰，直到常驻字节数在预算之内
+    *
+    * @param[in]   keep    不淘汰的条目（刚添加的条目）
+    */
+    void Evict(const Entry* keep);
+
+    typedef std::list<Entry> EntryList;
+
+    EntryList _entries;                                 ///< 条目（开头为最近使用）
+    std::map<std::string, EntryList::iterator> _index;  ///< 名称到条目的索引
+    Csm::csmSizeInt _budgetBytes;                       ///< 字节预算
+    Csm::csmSizeInt _residentBytes;                     ///< 常驻的字节数
+    Csm::csmUint32 _hitCount;                           ///< 命中次数
+    Csm::csmUint32 _missCount;                          ///< 未命中次数
+    Csm::csmUint32 _evictionCount;                      ///< 淘汰次数
+};
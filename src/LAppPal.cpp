@@ -11,10 +11,21 @@
 #include <sys/stat.h>
 #include <iostream>
 #include <fstream>
+#include <map>
+#include <mutex>
+#include <vector>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <Model/CubismMoc.hpp>
 #include "LAppDefine.hpp"
+#include "LAppBundle.hpp"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
 
 using std::endl;
 using namespace Csm;
@@ -25,8 +36,63 @@ double LAppPal::s_currentFrame = 0.0;
 double LAppPal::s_lastFrame = 0.0;
 double LAppPal::s_deltaTime = 0.0;
 
+namespace
+{
+    // MapFileAsBytes返回的映射视图及其大小。ReleaseBytes根据此表区分映射视图和堆内存
+    std::map<const csmByte*, csmSizeInt> s_mappedViews;
+
+    // 已挂载的模型素材包
+    struct MountedBundle
+    {
+        std::string directory;      ///< 挂载的模型目录（规范化后）
+        csmByte* bytes;             ///< 素材包的字节数据
+        LAppBundle bundle;          ///< 素材包的索引
+        csmUint32 outstandingViews; ///< 尚未ReleaseBytes的数据数
+        csmBool unmounted;          ///< 已卸载，等待所有数据释放后关闭
+    };
+    std::vector<MountedBundle*> s_bundles;
+
+    // 保护s_mappedViews和s_bundles（素材由工作线程并行读取）
+    std::recursive_mutex s_fileMutex;
+
+    // 串行化对CubismIdManager的访问
+    LAppPal::IdManagerMutex s_idManagerMutex;
+}
+
 csmByte* LAppPal::LoadFileAsBytes(const string filePath, csmSizeInt* outSize)
 {
+    std::unique_lock<std::recursive_mutex> bundleLock(s_fileMutex);
+    if (!s_bundles.empty())
+    {
+        const string normalizedPath = LAppBundle::NormalizePath(filePath);
+        for (csmUint32 i = 0; i < s_bundles.size(); i++)
+        {
+            MountedBundle* mounted = s_bundles[i];
+            if (mounted->unmounted || normalizedPath.compare(0, mounted->directory.size(), mounted->directory) != 0)
+            {
+                continue;
+            }
+
+            const csmByte* data = mounted->bundle.Find(normalizedPath.substr(mounted->directory.size()), outSize);
+            if (data != NULL)
+            {
+                mounted->outstandingViews++;
+                return const_cast<csmByte*>(data);
+            }
+        }
+    }
+    // 磁盘读取不需要持有锁
+    bundleLock.unlock();
+
+    if (MappedFileReadEnable)
+    {
+        csmByte* view = MapFileAsBytes(filePath, outSize);
+        if (view != NULL)
+        {
+            return view;
+        }
+    }
+
     //filePath;//
     const char* path = filePath.c_str();
 
@@ -58,9 +124,410 @@ csmByte* LAppPal::LoadFileAsBytes(const string filePath, csmSizeInt* outSize)
 
 void LAppPal::ReleaseBytes(csmByte* byteData)
 {
+    std::lock_guard<std::recursive_mutex> lock(s_fileMutex);
+
+    for (csmUint32 i = 0; i < s_bundles.size(); i++)
+    {
+        MountedBundle* mounted = s_bundles[i];
+        if (!mounted->bundle.Contains(byteData))
+        {
+            continue;
+        }
+
+        mounted->outstandingViews--;
+        if (mounted->unmounted && mounted->outstandingViews == 0)
+        {
+            s_bundles.erase(s_bundles.begin() + i);
+            ReleaseBytes(mounted->bytes);
+            delete mounted;
+        }
+        return;
+    }
+
+    if (UnmapBytes(byteData))
+    {
+        return;
+    }
     delete[] byteData;
 }
 
+csmBool LAppPal::IsFileExist(const string& filePath)
+{
+    {
+        std::lock_guard<std::recursive_mutex> lock(s_fileMutex);
+        if (!s_bundles.empty())
+        {
+            const string normalizedPath = LAppBundle::NormalizePath(filePath);
+            for (csmUint32 i = 0; i < s_bundles.size(); i++)
+            {
+                MountedBundle* mounted = s_bundles[i];
+                csmSizeInt size;
+                if (!mounted->unmounted && normalizedPath.compare(0, mounted->directory.size(), mounted->directory) == 0
+                    && mounted->bundle.Find(normalizedPath.substr(mounted->directory.size()), &size) != NULL)
+                {
+                    return true;
+                }
+            }
+        }
+    }
+
+    struct stat statBuf;
+    return stat(filePath.c_str(), &statBuf) == 0;
+}
+
+csmBool LAppPal::GetFileLength(const string& filePath, csmSizeInt* outSize)
+{
+    {
+        std::lock_guard<std::recursive_mutex> lock(s_fileMutex);
+        if (!s_bundles.empty())
+        {
+            const string normalizedPath = LAppBundle::NormalizePath(filePath);
+            for (csmUint32 i = 0; i < s_bundles.size(); i++)
+            {
+                MountedBundle* mounted = s_bundles[i];
+                if (!mounted->unmounted && normalizedPath.compare(0, mounted->directory.size(), mounted->directory) == 0
+                    && mounted->bundle.Find(normalizedPath.substr(mounted->directory.size()), outSize) != NULL)
+                {
+                    return true;
+                }
+            }
+        }
+    }
+
+    struct stat statBuf;
+    if (stat(filePath.c_str(), &statBuf) != 0)
+    {
+        return false;
+    }
+    *outSize = static_cast<csmSizeInt>(statBuf.st_size);
+    return true;
+}
+
+csmBool LAppPal::MountBundle(const string& directory, const string& bundlePath)
+{
+    string normalizedDirectory = LAppBundle::NormalizePath(directory);
+    if (!normalizedDirectory.empty() && normalizedDirectory[normalizedDirectory.size() - 1] != '/')
+    {
+        normalizedDirectory += "/";
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(s_fileMutex);
+
+    for (csmUint32 i = 0; i < s_bundles.size(); i++)
+    {
+        if (!s_bundles[i]->unmounted && s_bundles[i]->directory == normalizedDirectory)
+        {
+            return true;
+        }
+    }
+
+    struct stat statBuf;
+    if (stat(bundlePath.c_str(), &statBuf) != 0)
+    {
+        return false;
+    }
+
+    csmSizeInt size = 0;
+    csmByte* bytes = LoadFileAsBytes(bundlePath, &size);
+    if (bytes == NULL)
+    {
+        return false;
+    }
+
+    MountedBundle* mounted = new MountedBundle();
+    if (!mounted->bundle.Open(bytes, size))
+    {
+        if (DebugLogEnable)
+        {
+            PrintLog("[APP]invalid bundle: %s", bundlePath.c_str());
+        }
+        delete mounted;
+        ReleaseBytes(bytes);
+        return false;
+    }
+    mounted->directory = normalizedDirectory;
+    mounted->bytes = bytes;
+    mounted->outstandingViews = 0;
+    mounted->unmounted = false;
+    s_bundles.push_back(mounted);
+
+    if (DebugLogEnable)
+    {
+        PrintLog("[APP]mount bundle: %s (%d files) => %s", bundlePath.c_str(), mounted->bundle.GetEntryCount(), normalizedDirectory.c_str());
+    }
+
+    return true;
+}
+
+void LAppPal::UnmountBundle(const string& directory)
+{
+    string normalizedDirectory = LAppBundle::NormalizePath(directory);
+    if (!normalizedDirectory.empty() && normalizedDirectory[normalizedDirectory.size() - 1] != '/')
+    {
+        normalizedDirectory += "/";
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(s_fileMutex);
+
+    for (csmUint32 i = 0; i < s_bundles.size(); i++)
+    {
+        MountedBundle* mounted = s_bundles[i];
+        if (mounted->unmounted || mounted->directory != normalizedDirectory)
+        {
+            continue;
+        }
+
+        mounted->unmounted = true;
+        if (mounted->outstandingViews == 0)
+        {
+            s_bundles.erase(s_bundles.begin() + i);
+            ReleaseBytes(mounted->bytes);
+            delete mounted;
+        }
+        return;
+    }
+}
+
+csmByte* LAppPal::MapFileAsBytes(const string& filePath, csmSizeInt* outSize)
+{
+    void* view = NULL;
+    csmSizeInt size = 0;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return NULL;
+    }
+
+    LARGE_INTEGER fileSize;
+    // 空文件无法映射，超过csmSizeInt的文件无法表示大小
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0 || fileSize.QuadPart > 0xFFFFFFFFLL)
+    {
+        CloseHandle(file);
+        return NULL;
+    }
+    size = static_cast<csmSizeInt>(fileSize.QuadPart);
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping != NULL)
+    {
+        view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        // 视图持有映射对象的引用，句柄可以立即关闭
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+#else
+    const int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+
+    struct stat statBuf;
+    if (fstat(fd, &statBuf) != 0 || statBuf.st_size <= 0 || static_cast<unsigned long long>(statBuf.st_size) > 0xFFFFFFFFULL)
+    {
+        close(fd);
+        return NULL;
+    }
+    size = static_cast<csmSizeInt>(statBuf.st_size);
+
+    view = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED)
+    {
+        view = NULL;
+    }
+    // 映射在关闭文件描述符后依然有效
+    close(fd);
+#endif
+
+    if (view == NULL)
+    {
+        if (DebugLogEnable)
+        {
+            PrintLog("[APP]file map failed, fall back to read: %s", filePath.c_str());
+        }
+        return NULL;
+    }
+
+    csmByte* bytes = static_cast<csmByte*>(view);
+    {
+        std::lock_guard<std::recursive_mutex> lock(s_fileMutex);
+        s_mappedViews[bytes] = size;
+    }
+
+    *outSize = size;
+    return bytes;
+}
+
+csmBool LAppPal::UnmapBytes(csmByte* byteData)
+{
+    std::lock_guard<std::recursive_mutex> lock(s_fileMutex);
+
+    std::map<const csmByte*, csmSizeInt>::iterator it = s_mappedViews.find(byteData);
+    if (it == s_mappedViews.end())
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(byteData);
+#else
+    munmap(byteData, it->second);
+#endif
+    s_mappedViews.erase(it);
+
+    return true;
+}
+
+csmBool LAppPal::GetFileStamp(const string& filePath, FileStamp* outStamp)
+{
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExA(filePath.c_str(), GetFileExInfoStandard, &attributes))
+    {
+        return false;
+    }
+    outStamp->size = (static_cast<csmUint64>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+    outStamp->modifiedTime = (static_cast<csmUint64>(attributes.ftLastWriteTime.dwHighDateTime) << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+#else
+    struct stat statBuf;
+    if (stat(filePath.c_str(), &statBuf) != 0)
+    {
+        return false;
+    }
+    outStamp->size = static_cast<csmUint64>(statBuf.st_size);
+#ifdef __APPLE__
+    outStamp->modifiedTime = static_cast<csmUint64>(statBuf.st_mtimespec.tv_sec) * 1000000000ULL + statBuf.st_mtimespec.tv_nsec;
+#else
+    outStamp->modifiedTime = static_cast<csmUint64>(statBuf.st_mtim.tv_sec) * 1000000000ULL + statBuf.st_mtim.tv_nsec;
+#endif
+#endif
+    return true;
+}
+
+csmUint64 LAppPal::HashBytes(const csmByte* data, csmSizeInt size)
+{
+    csmUint64 hash = 14695981039346656037ULL;
+    for (csmSizeInt i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+string LAppPal::MakeCacheFileName(const string& key)
+{
+    csmUint64 hash = HashBytes(reinterpret_cast<const csmByte*>(key.data()), static_cast<csmSizeInt>(key.size()));
+
+    const char* hex = "0123456789abcdef";
+    string name(16, '0');
+    for (int i = 15; i >= 0; i--)
+    {
+        name[i] = hex[hash & 0xF];
+        hash >>= 4;
+    }
+
+    return name;
+}
+
+void LAppPal::MakeDirectory(const string& directory)
+{
+    string path = directory;
+    if (!path.empty() && (path[path.size() - 1] == '/' || path[path.size() - 1] == '\\'))
+    {
+        path.erase(path.size() - 1);
+    }
+
+#ifdef _WIN32
+    CreateDirectoryA(path.c_str(), NULL);
+#else
+    mkdir(path.c_str(), 0755);
+#endif
+}
+
+LAppPal::IdManagerMutex& LAppPal::GetIdManagerMutex()
+{
+    return s_idManagerMutex;
+}
+
+LAppPal::IdManagerMutex::IdManagerMutex()
+    : _ownerDepth(0)
+    , _readers(0)
+    , _waitingWriters(0)
+{
+}
+
+void LAppPal::IdManagerMutex::lock()
+{
+    const std::thread::id self = std::this_thread::get_id();
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_ownerDepth > 0 && _owner == self)
+    {
+        _ownerDepth++;
+        return;
+    }
+
+    _waitingWriters++;
+    while (_ownerDepth > 0 || _readers > 0)
+    {
+        _condition.wait(lock);
+    }
+    _waitingWriters--;
+    _owner = self;
+    _ownerDepth = 1;
+}
+
+void LAppPal::IdManagerMutex::unlock()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (--_ownerDepth == 0)
+    {
+        _owner = std::thread::id();
+        _condition.notify_all();
+    }
+}
+
+void LAppPal::IdManagerMutex::lock_shared()
+{
+    const std::thread::id self = std::this_thread::get_id();
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_ownerDepth > 0 && _owner == self)
+    {
+        _ownerDepth++;
+        return;
+    }
+
+    // 有等待独占的线程时不再接受新的共享，防止注册ID的一方饿死
+    while (_ownerDepth > 0 || _waitingWriters > 0)
+    {
+        _condition.wait(lock);
+    }
+    _readers++;
+}
+
+void LAppPal::IdManagerMutex::unlock_shared()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_ownerDepth > 0 && _owner == std::this_thread::get_id())
+    {
+        if (--_ownerDepth == 0)
+        {
+            _owner = std::thread::id();
+            _condition.notify_all();
+        }
+        return;
+    }
+
+    if (--_readers == 0)
+    {
+        _condition.notify_all();
+    }
+}
+
 csmFloat32  LAppPal::GetDeltaTime()
 {
     return static_cast<csmFloat32>(s_deltaTime);
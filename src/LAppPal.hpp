@@ -8,7 +8,10 @@
 #pragma once
 
 #include <CubismFramework.hpp>
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
 
  /**
  * @brief Cubism Platform Abstraction Layer，用于抽象平台依赖功能。
@@ -19,9 +22,23 @@
 
 类中包含以下成员函数：
 
-LoadFileAsBytes：以字节数据形式读取文件。输入参数为文件路径，输出参数为文件大小，返回值为字节数据。
+LoadFileAsBytes：以字节数据形式读取文件。输入参数为文件路径，输出参数为文件大小，返回值为字节数据。启用MappedFileReadEnable时返回只读的内存映射视图。
 
-ReleaseBytes：释放字节数据。输入参数为要释放的字节数据。
+ReleaseBytes：释放字节数据。输入参数为要释放的字节数据。对内存映射视图执行解除映射。
+
+IsFileExist：判断文件是否存在（包括已挂载的素材包中的文件）。
+
+GetFileLength：获取文件大小，不读取内容（包括已挂载的素材包中的文件）。
+
+GetFileStamp：获取磁盘上文件的大小和修改时间，供纹理缓存、口型同步包络判断源文件是否变更。
+
+HashBytes：计算数据的FNV-1a哈希（二进制动作用于判断motion3.json是否变更）。
+
+MakeCacheFileName/MakeDirectory：由键生成缓存文件名（哈希）/创建缓存目录。
+
+MountBundle/UnmountBundle：将模型素材包挂载到模型目录，之后该目录下文件的LoadFileAsBytes直接返回素材包内的数据。
+
+GetIdManagerMutex：获取保护CubismIdManager的读写锁，供在工作线程上读取素材时使用（注册ID时独占，只查找已注册的ID时共享）。
 
 GetDeltaTime：获取与上一帧的时间差。返回值为时间差（毫秒）。
 
@@ -37,10 +54,64 @@ PrintMessage：输出消息。输入参数为字符串。
 class LAppPal
 {
 public:
+    /**
+    * @brief 保护CubismIdManager的读写锁
+    *
+    * lock/unlock为独占，同一线程可以重入。lock_shared/unlock_shared为共享，
+    * 只查找已注册的ID（并行解析）时使用；持有独占的线程也可以调用（作为重入处理）。
+    * 有线程等待独占时新的共享请求也等待，主线程注册ID时最多等待正在执行的解析任务结束。
+    * 持有共享的线程不能再请求独占或共享。
+    */
+    class IdManagerMutex
+    {
+    public:
+        IdManagerMutex();
+
+        void lock();
+        void unlock();
+        void lock_shared();
+        void unlock_shared();
+
+        /**
+        * @brief 在作用域内持有共享锁
+        */
+        class SharedLock
+        {
+        public:
+            explicit SharedLock(IdManagerMutex& mutex)
+                : _mutex(mutex)
+            {
+                _mutex.lock_shared();
+            }
+
+            ~SharedLock()
+            {
+                _mutex.unlock_shared();
+            }
+
+        private:
+            SharedLock(const SharedLock&);
+            SharedLock& operator=(const SharedLock&);
+
+            IdManagerMutex& _mutex;
+        };
+
+    private:
+        std::mutex _mutex;                      ///< 保护以下成员
+        std::condition_variable _condition;     ///< 锁释放的通知
+        std::thread::id _owner;                 ///< 持有独占的线程
+        Csm::csmUint32 _ownerDepth;             ///< 独占的重入次数
+        Csm::csmUint32 _readers;                ///< 持有共享的线程数
+        Csm::csmUint32 _waitingWriters;         ///< 等待独占的线程数
+    };
+
     /**
     * @brief 以字节数据形式读取文件
     *
-    * 以字节数据形式读取文件
+    * 以字节数据形式读取文件。
+    * LAppDefine::MappedFileReadEnable为true时，返回文件的只读内存映射视图（不进行复制），
+    * 映射失败时（空文件等）回退到复制到堆内存的方式。
+    * 返回的数据在两种方式下都只能读取，且必须通过ReleaseBytes释放。
     *
     * @param[in]   filePath    要读取的目标文件的路径
     * @param[out]  outSize     文件大小
@@ -52,12 +123,110 @@ public:
     /**
     * @brief 释放字节数据
     *
-    * 释放字节数据
+    * 释放字节数据。内存映射视图会被解除映射，堆内存会被delete。
     *
     * @param[in]   byteData    要释放的字节数据
     */
     static void ReleaseBytes(Csm::csmByte* byteData);
 
+    /**
+    * @brief 判断文件是否存在
+    *
+    * 也会在已挂载的素材包中查找。
+    *
+    * @param[in]   filePath    文件路径
+    * @return                  存在时返回true
+    */
+    static Csm::csmBool IsFileExist(const std::string& filePath);
+
+    /**
+    * @brief 获取文件大小
+    *
+    * 也会在已挂载的素材包中查找。不读取文件内容。
+    *
+    * @param[in]   filePath    文件路径
+    * @param[out]  outSize     文件大小
+    * @return                  存在时返回true
+    */
+    static Csm::csmBool GetFileLength(const std::string& filePath, Csm::csmSizeInt* outSize);
+
+    /**
+    * @brief 文件的标识（大小和修改时间）
+    */
+    struct FileStamp
+    {
+        Csm::csmUint64 size;            ///< 文件大小
+        Csm::csmUint64 modifiedTime;    ///< 修改时间（平台相关的单位）
+    };
+
+    /**
+    * @brief 获取磁盘上文件的大小和修改时间
+    *
+    * 不在素材包中查找（素材包内的文件没有修改时间）。
+    *
+    * @param[in]   filePath    文件路径
+    * @param[out]  outStamp    文件的标识
+    * @return                  磁盘上存在该文件时返回true
+    */
+    static Csm::csmBool GetFileStamp(const std::string& filePath, FileStamp* outStamp);
+
+    /**
+    * @brief 计算数据的FNV-1a哈希
+    *
+    * @param[in]   data        数据
+    * @param[in]   size        数据大小
+    * @return                  64位哈希值
+    */
+    static Csm::csmUint64 HashBytes(const Csm::csmByte* data, Csm::csmSizeInt size);
+
+    /**
+    * @brief 由键生成缓存文件名
+    *
+    * @param[in]   key         键（源文件路径等）
+    * @return                  键的FNV-1a哈希的16位十六进制字符串
+    */
+    static std::string MakeCacheFileName(const std::string& key);
+
+    /**
+    * @brief 创建目录（已存在时什么都不做）
+    *
+    * @param[in]   directory   目录路径（可以以分隔符结尾）
+    */
+    static void MakeDirectory(const std::string& directory);
+
+    /**
+    * @brief 挂载模型素材包
+    *
+    * 挂载后，路径以directory开头的LoadFileAsBytes先在素材包中查找，
+    * 找到时返回素材包内部的数据（不进行复制），找不到时照常从磁盘读取。
+    *
+    * @param[in]   directory   模型目录（例如"resources/Mao/"）
+    * @param[in]   bundlePath  素材包文件的路径
+    * @return                  挂载成功时返回true。素材包不存在或格式不正确时返回false
+    */
+    static Csm::csmBool MountBundle(const std::string& directory, const std::string& bundlePath);
+
+    /**
+    * @brief 卸载模型素材包
+    *
+    * 仍有未释放的数据时，素材包在最后一次ReleaseBytes时才被关闭。
+    *
+    * @param[in]   directory   挂载时指定的模型目录
+    */
+    static void UnmountBundle(const std::string& directory);
+
+    /**
+    * @brief 获取保护CubismIdManager的读写锁
+    *
+    * CubismIdManager不是线程安全的。调用会注册ID的框架函数
+    * （CubismMoc::CreateModel、LoadMotion等）时，必须持有独占锁；
+    * 所有ID都已注册、只进行查找时持有共享锁即可，多个线程可以并行。
+    * LoadFileAsBytes/ReleaseBytes/MountBundle/UnmountBundle本身是线程安全的。
+    *
+    * @return  读写锁
+    */
+    static IdManagerMutex& GetIdManagerMutex();
+
     /**
     * @brief 获取与上一帧的时间差
     *
@@ -90,6 +259,23 @@ public:
     static void PrintMessage(const Csm::csmChar* message);
 
 private:
+    /**
+    * @brief 以只读内存映射的方式读取文件
+    *
+    * @param[in]   filePath    要读取的目标文件的路径
+    * @param[out]  outSize     文件大小
+    * @return                  映射视图的起始地址。映射失败时返回NULL
+    */
+    static Csm::csmByte* MapFileAsBytes(const std::string& filePath, Csm::csmSizeInt* outSize);
+
+    /**
+    * @brief 解除内存映射视图
+    *
+    * @param[in]   byteData    MapFileAsBytes返回的映射视图
+    * @return                  是映射视图并已解除时返回true，不是映射视图时返回false
+    */
+    static Csm::csmBool UnmapBytes(Csm::csmByte* byteData);
+
     static double s_currentFrame;
     static double s_lastFrame;
     static double s_deltaTime;
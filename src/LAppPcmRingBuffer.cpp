@@ -0,0 +1,86 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppPcmRingBuffer.hpp"
+#include <algorithm>
+#include <cstring>
+
+using namespace Csm;
+
+LAppPcmRingBuffer::LAppPcmRingBuffer(csmUint32 minimumCapacity)
+    : _samples(NULL)
+    , _mask(0)
+    , _writeIndex(0)
+    , _readIndex(0)
+{
+    // 位置计数器回绕时下标仍然连续，容量需为2的幂且不超过2^31
+    csmUint32 capacity = 1;
+    while (capacity < minimumCapacity && capacity < 0x80000000u)
+    {
+        capacity *= 2;
+    }
+
+    _samples = new csmInt16[capacity];
+    _mask = capacity - 1;
+}
+
+LAppPcmRingBuffer::~LAppPcmRingBuffer()
+{
+    delete[] _samples;
+}
+
+csmUint32 LAppPcmRingBuffer::Write(const csmInt16* samples, csmUint32 count)
+{
+    const csmUint32 writeIndex = _writeIndex.load(std::memory_order_relaxed);
+    const csmUint32 readIndex = _readIndex.load(std::memory_order_acquire);
+    const csmUint32 writable = GetCapacity() - (writeIndex - readIndex);
+    count = std::min(count, writable);
+
+    // 跨过数组末尾时分两次复制
+    const csmUint32 offset = writeIndex & _mask;
+    const csmUint32 first = std::min(count, GetCapacity() - offset);
+    memcpy(_samples + offset, samples, first * sizeof(csmInt16));
+    memcpy(_samples, samples + first, (count - first) * sizeof(csmInt16));
+
+    _writeIndex.store(writeIndex + count, std::memory_order_release);
+    return count;
+}
+
+csmUint32 LAppPcmRingBuffer::Read(csmInt16* samples, csmUint32 count)
+{
+    const csmUint32 readIndex = _readIndex.load(std::memory_order_relaxed);
+    const csmUint32 writeIndex = _writeIndex.load(std::memory_order_acquire);
+    count = std::min(count, writeIndex - readIndex);
+
+    const csmUint32 offset = readIndex & _mask;
+    const csmUint32 first = std::min(count, GetCapacity() - offset);
+    memcpy(samples, _samples + offset, first * sizeof(csmInt16));
+    memcpy(samples + first, _samples, (count - first) * sizeof(csmInt16));
+
+    _readIndex.store(readIndex + count, std::memory_order_release);
+    return count;
+}
+
+csmUint32 LAppPcmRingBuffer::Skip(csmUint32 count)
+{
+    const csmUint32 readIndex = _readIndex.load(std::memory_order_relaxed);
+    const csmUint32 writeIndex = _writeIndex.load(std::memory_order_acquire);
+    count = std::min(count, writeIndex - readIndex);
+
+    _readIndex.store(readIndex + count, std::memory_order_release);
+    return count;
+}
+
+csmUint32 LAppPcmRingBuffer::GetReadableCount() const
+{
+    return _writeIndex.load(std::memory_order_acquire) - _readIndex.load(std::memory_order_acquire);
+}
+
+csmUint32 LAppPcmRingBuffer::GetWritableCount() const
+{
+    return GetCapacity() - GetReadableCount();
+}
@@ -0,0 +1,99 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <CubismFramework.hpp>
+
+ /**
+ * @brief PCM样本的无锁环形缓冲区
+ *
+ * 一个生产者线程写入、一个消费者线程读取的16位PCM环形缓冲区（SPSC）。
+ *
+ 这段代码定义了一个名为LAppPcmRingBuffer的类，用于把外部音频线程收到的PCM交给主线程的口型同步，不使用互斥锁。
+
+容量向上取整为2的幂，读写位置是只增不减的计数器（溢出后自然回绕），用掩码得到数组下标。
+写入位置只由生产者修改，读取位置只由消费者修改：写入样本后以release存储写入位置，读取方以acquire加载后再读取样本，反之亦然。
+两个位置分别放在不同的缓存行中，避免生产者和消费者之间的伪共享。
+缓冲区满时Write只写入能放下的部分（不阻塞），多出的部分由调用方处理。
+
+LAppPcmRingBuffer()/~LAppPcmRingBuffer()：构造函数（指定最小容量）/析构函数。
+Write()：写入样本（生产者线程）。
+Read()/Skip()：读取/丢弃最旧的样本（消费者线程）。
+GetReadableCount()/GetWritableCount()/GetCapacity()：可读取的样本数/可写入的样本数/容量。
+ */
+class LAppPcmRingBuffer
+{
+public:
+    /**
+    * @brief 构造函数
+    *
+    * @param[in]   minimumCapacity 最少能保存的样本数（向上取整为2的幂）
+    */
+    LAppPcmRingBuffer(Csm::csmUint32 minimumCapacity);
+
+    /**
+    * @brief 析构函数
+    */
+    ~LAppPcmRingBuffer();
+
+    /**
+    * @brief 写入样本（只能从生产者线程调用）
+    *
+    * @param[in]   samples     样本
+    * @param[in]   count       样本数
+    * @return                  实际写入的样本数（缓冲区满时小于count）
+    */
+    Csm::csmUint32 Write(const Csm::csmInt16* samples, Csm::csmUint32 count);
+
+    /**
+    * @brief 按从旧到新的顺序读取样本（只能从消费者线程调用）
+    *
+    * @param[out]  samples     样本的写入位置
+    * @param[in]   count       最多读取的样本数
+    * @return                  实际读取的样本数
+    */
+    Csm::csmUint32 Read(Csm::csmInt16* samples, Csm::csmUint32 count);
+
+    /**
+    * @brief 丢弃最旧的样本（只能从消费者线程调用）
+    *
+    * @param[in]   count       最多丢弃的样本数
+    * @return                  实际丢弃的样本数
+    */
+    Csm::csmUint32 Skip(Csm::csmUint32 count);
+
+    /**
+    * @brief 获取可读取的样本数
+    */
+    Csm::csmUint32 GetReadableCount() const;
+
+    /**
+    * @brief 获取可写入的样本数
+    */
+    Csm::csmUint32 GetWritableCount() const;
+
+    /**
+    * @brief 获取容量（样本数）
+    */
+    Csm::csmUint32 GetCapacity() const
+    {
+        return _mask + 1;
+    }
+
+private:
+    static const Csm::csmUint32 CacheLineSize = 64;
+
+    Csm::csmInt16* _samples;                        ///< 样本数组
+    Csm::csmUint32 _mask;                           ///< 容量-1
+    char _padding0[CacheLineSize];
+    std::atomic<Csm::csmUint32> _writeIndex;        ///< 写入位置（只由生产者修改）
+    char _padding1[CacheLineSize - sizeof(std::atomic<Csm::csmUint32>)];
+    std::atomic<Csm::csmUint32> _readIndex;         ///< 读取位置（只由消费者修改）
+    char _padding2[CacheLineSize - sizeof(std::atomic<Csm::csmUint32>)];
+};
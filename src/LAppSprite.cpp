@@ -6,10 +6,11 @@
  */
 
 #include "LAppSprite.hpp"
-#include "LAppDelegate.hpp"
+#include "LAppWindowState.hpp"
 
 LAppSprite::LAppSprite(float x, float y, float width, float height, GLuint textureId, GLuint programId)
     : _rect()
+    , _revision(0)
 {
     _rect.left = (x - width * 0.5f);
     _rect.right = (x + width * 0.5f);
@@ -27,31 +28,33 @@ LAppSprite::LAppSprite(float x, float y, float width, float height, GLuint textu
     _spriteColor[1] = 1.0f;
     _spriteColor[2] = 1.0f;
     _spriteColor[3] = 1.0f;
+
+    // 默认使用整张纹理
+    const GLfloat uvVertex[] =
+    {
+        1.0f, 0.0f,
+        0.0f, 0.0f,
+        0.0f, 1.0f,
+        1.0f, 1.0f,
+    };
+    SetUvVertex(uvVertex);
 }
 
 LAppSprite::~LAppSprite()
 {
 }
 
-void LAppSprite::Render() const
+void LAppSprite::Render(bool bindTexture) const
 {
     // 画面サイズを取得する
-    int maxWidth, maxHeight;
-    glfwGetWindowSize(LAppDelegate::GetInstance()->GetWindow(), &maxWidth, &maxHeight);
+    int maxWidth = LAppWindowState::GetInstance()->GetWidth();
+    int maxHeight = LAppWindowState::GetInstance()->GetHeight();
 
     if (maxWidth == 0 || maxHeight == 0)
     {
         return; // この際は描画できず
     }
 
-    const GLfloat uvVertex[] =
-    {
-        1.0f, 0.0f,
-        0.0f, 0.0f,
-        0.0f, 1.0f,
-        1.0f, 1.0f,
-    };
-
     // attribute属性を有効にする
     glEnableVertexAttribArray(_positionLocation);
     glEnableVertexAttribArray(_uvLocation);
@@ -70,21 +73,24 @@ void LAppSprite::Render() const
 
     // attribute属性を登録
     glVertexAttribPointer(_positionLocation, 2, GL_FLOAT, false, 0, positionVertex);
-    glVertexAttribPointer(_uvLocation, 2, GL_FLOAT, false, 0, uvVertex);
+    glVertexAttribPointer(_uvLocation, 2, GL_FLOAT, false, 0, _uvVertex);
 
     glUniform4f(_colorLocation, _spriteColor[0], _spriteColor[1], _spriteColor[2], _spriteColor[3]);
 
 
     // モデルの描画
-    glBindTexture(GL_TEXTURE_2D, _textureId);
+    if (bindTexture)
+    {
+        glBindTexture(GL_TEXTURE_2D, _textureId);
+    }
     glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 }
 
 void LAppSprite::RenderImmidiate(GLuint textureId, const GLfloat uvVertex[8]) const
 {
     // 画面サイズを取得する
-    int maxWidth, maxHeight;
-    glfwGetWindowSize(LAppDelegate::GetInstance()->GetWindow(), &maxWidth, &maxHeight);
+    int maxWidth = LAppWindowState::GetInstance()->GetWidth();
+    int maxHeight = LAppWindowState::GetInstance()->GetHeight();
 
     if (maxWidth == 0 || maxHeight == 0)
     {
@@ -121,8 +127,8 @@ void LAppSprite::RenderImmidiate(GLuint textureId, const GLfloat uvVertex[8]) co
 bool LAppSprite::IsHit(float pointX, float pointY) const
 {
     // 画面サイズを取得する
-    int maxWidth, maxHeight;
-    glfwGetWindowSize(LAppDelegate::GetInstance()->GetWindow(), &maxWidth, &maxHeight);
+    int maxWidth = LAppWindowState::GetInstance()->GetWidth();
+    int maxHeight = LAppWindowState::GetInstance()->GetHeight();
 
     if (maxWidth == 0 || maxHeight == 0)
     {
@@ -141,6 +147,16 @@ void LAppSprite::SetColor(float r, float g, float b, float a)
     _spriteColor[1] = g;
     _spriteColor[2] = b;
     _spriteColor[3] = a;
+    _revision++;
+}
+
+void LAppSprite::SetUvVertex(const GLfloat uvVertex[8])
+{
+    for (int i = 0; i < 8; i++)
+    {
+        _uvVertex[i] = uvVertex[i];
+    }
+    _revision++;
 }
 
 void LAppSprite::ResetRect(float x, float y, float width, float height)
@@ -149,4 +165,5 @@ void LAppSprite::ResetRect(float x, float y, float width, float height)
     _rect.right = (x + width * 0.5f);
     _rect.up = (y + height * 0.5f);
     _rect.down = (y - height * 0.5f);
+    _revision++;
 }
@@ -21,10 +21,12 @@ Rect结构体：用于表示精灵的矩形区域，包含左、右、上、下
 构造函数：用于创建一个LAppSprite对象，需要提供x、y坐标，宽度、高度，纹理ID和着色器ID。
 析构函数：用于销毁LAppSprite对象。
 GetTextureId()方法：获取纹理ID。
-Render()方法：绘制精灵。
+Render()方法：绘制精灵。bindTexture为false时使用调用方已绑定的纹理（多个精灵共用一张图集时只绑定一次）。
 RenderImmidiate()方法：使用指定的纹理ID和UV顶点立即绘制精灵。
 IsHit()方法：检测给定的x和y坐标是否在精灵的矩形区域内。
 SetColor()方法：设置精灵的颜色，需要提供红、绿、蓝、透明度
+SetUvVertex()方法：设置Render使用的UV（引用图集中的子矩形时使用）
+GetRect()/GetUvVertex()/GetColor()/GetRevision()方法：供LAppSpriteBatch生成顶点。修订号在矩形、UV、颜色变化时加1
 
  */
 class LAppSprite
@@ -63,16 +65,50 @@ public:
     * @brief Getter 纹理ID
     * @return 返回纹理ID
     */
-    GLuint GetTextureId()
+    GLuint GetTextureId() const
     {
         return _textureId;
     }
 
+    /**
+    * @brief Getter 矩形
+    */
+    const Rect& GetRect() const
+    {
+        return _rect;
+    }
+
+    /**
+    * @brief Getter Render使用的UV（右上、左上、左下、右下）
+    */
+    const GLfloat* GetUvVertex() const
+    {
+        return _uvVertex;
+    }
+
+    /**
+    * @brief Getter 颜色（r、g、b、a）
+    */
+    const float* GetColor() const
+    {
+        return _spriteColor;
+    }
+
+    /**
+    * @brief Getter 修订号
+    *         矩形、UV、颜色变化时加1。LAppSpriteBatch据此判断是否需要重新生成顶点。
+    */
+    unsigned int GetRevision() const
+    {
+        return _revision;
+    }
+
     /**
     * @brief 绘制
     *
+    * @param[in]       bindTexture  为false时不绑定纹理，使用调用方已绑定的纹理
     */
-    void Render() const;
+    void Render(bool bindTexture = true) const;
 
     /**
     * @brief 使用指定的纹理ID绘制
@@ -98,6 +134,13 @@ public:
      */
     void SetColor(float r, float g, float b, float a);
 
+    /**
+     * @brief 设置Render使用的UV
+     *
+     * @param[in]       uvVertex    右上、左上、左下、右下顶点的UV
+     */
+    void SetUvVertex(const GLfloat uvVertex[8]);
+
     /**
      * @brief 重新设置大小
      *
@@ -117,4 +160,6 @@ private:
     int _colorLocation;     ///< 颜色属性
 
     float _spriteColor[4];  ///< 显示颜色
+    GLfloat _uvVertex[8];   ///< Render使用的UV
+    unsigned int _revision; ///< 修订号
 };
@@ -0,0 +1,238 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppSpriteAtlas.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "LAppDefine.hpp"
+#include "LAppLoadTracer.hpp"
+#include "LAppPal.hpp"
+#include "LAppTextureManager.hpp"
+
+using namespace LAppDefine;
+
+namespace
+{
+    int ClampInt(int value, int low, int high)
+    {
+        return value < low ? low : (value > high ? high : value);
+    }
+}
+
+LAppSpriteAtlas::LAppSpriteAtlas()
+    : _textureId(0)
+    , _width(0)
+    , _height(0)
+{
+}
+
+LAppSpriteAtlas::~LAppSpriteAtlas()
+{
+    Release();
+}
+
+bool LAppSpriteAtlas::Build(const std::vector<std::string>& fileNames)
+{
+    Release();
+
+    if (fileNames.empty())
+    {
+        return false;
+    }
+
+    std::vector<LAppTextureManager::DecodedImage> images;
+    LAppTextureManager::DecodePngFiles(fileNames, images);
+
+    bool decoded = true;
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        if (images[i].pixels == NULL)
+        {
+            LAppPal::PrintLog("[APP]sprite atlas: failed to load %s", fileNames[i].c_str());
+            decoded = false;
+        }
+    }
+
+    const int padding = SpriteAtlasPadding > 0 ? SpriteAtlasPadding : 0;
+    std::vector<PackItem> items;
+    int maxItemWidth = 0;
+    double totalArea = 0.0;
+    for (size_t i = 0; decoded && i < images.size(); i++)
+    {
+        PackItem item;
+        item.index = static_cast<int>(i);
+        item.width = images[i].width + padding * 2;
+        item.height = images[i].height + padding * 2;
+        item.x = 0;
+        item.y = 0;
+        items.push_back(item);
+
+        maxItemWidth = std::max(maxItemWidth, item.width);
+        totalArea += static_cast<double>(item.width) * item.height;
+    }
+
+    // 高的排在前面，同样高度时宽的排在前面
+    struct PackOrder
+    {
+        bool operator()(const PackItem& a, const PackItem& b) const
+        {
+            return a.height != b.height ? a.height > b.height : a.width > b.width;
+        }
+    };
+    std::sort(items.begin(), items.end(), PackOrder());
+
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+
+    // 从能放下最宽图像且接近总面积平方根的2的幂开始，排列后比宽度高时加宽
+    int width = 1;
+    const int minWidth = std::max(maxItemWidth, static_cast<int>(std::ceil(std::sqrt(totalArea))));
+    while (width < minWidth)
+    {
+        width *= 2;
+    }
+
+    int height = 0;
+    if (decoded)
+    {
+        for (;;)
+        {
+            height = PackShelves(items, width);
+            if (height <= width || width * 2 > maxSize)
+            {
+                break;
+            }
+            width *= 2;
+        }
+    }
+
+    if (!decoded || width > maxSize || height > maxSize)
+    {
+        if (decoded)
+        {
+            LAppPal::PrintLog("[APP]sprite atlas: %dx%d exceeds GL_MAX_TEXTURE_SIZE %d", width, height, maxSize);
+        }
+        for (size_t i = 0; i < images.size(); i++)
+        {
+            LAppTextureManager::ReleaseDecodedImage(&images[i]);
+        }
+        return false;
+    }
+
+    // 复制像素，边距用最近的边缘像素填充
+    std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 4, 0);
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        const PackItem& item = items[i];
+        LAppTextureManager::DecodedImage& image = images[item.index];
+
+        for (int y = 0; y < item.height; y++)
+        {
+            const int sourceY = ClampInt(y - padding, 0, image.height - 1);
+            const unsigned char* sourceRow = image.pixels + static_cast<size_t>(sourceY) * image.width * 4;
+            unsigned char* destRow = &pixels[(static_cast<size_t>(item.y + y) * width + item.x) * 4];
+
+            for (int x = 0; x < padding; x++)
+            {
+                memcpy(destRow + x * 4, sourceRow, 4);
+                memcpy(destRow + (padding + image.width + x) * 4, sourceRow + (image.width - 1) * 4, 4);
+            }
+            memcpy(destRow + padding * 4, sourceRow, static_cast<size_t>(image.width) * 4);
+        }
+
+        const GLfloat left = static_cast<GLfloat>(item.x + padding) / width;
+        const GLfloat right = static_cast<GLfloat>(item.x + padding + image.width) / width;
+        const GLfloat top = static_cast<GLfloat>(item.y + padding) / height;
+        const GLfloat bottom = static_cast<GLfloat>(item.y + padding + image.height) / height;
+
+        Region region;
+        region.x = item.x + padding;
+        region.y = item.y + padding;
+        region.width = image.width;
+        region.height = image.height;
+        region.uvVertex[0] = right;
+        region.uvVertex[1] = top;
+        region.uvVertex[2] = left;
+        region.uvVertex[3] = top;
+        region.uvVertex[4] = left;
+        region.uvVertex[5] = bottom;
+        region.uvVertex[6] = right;
+        region.uvVertex[7] = bottom;
+        _regions[image.fileName] = region;
+
+        LAppTextureManager::ReleaseDecodedImage(&image);
+    }
+
+    {
+        LAppLoadTracer::Scope trace("gl_upload", "sprite_atlas", pixels.size());
+
+        // UI按原尺寸附近绘制，不生成mip链（缩小的mip级会混入相邻图像）
+        glGenTextures(1, &_textureId);
+        glBindTexture(GL_TEXTURE_2D, _textureId);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    _width = width;
+    _height = height;
+
+    if (DebugLogEnable)
+    {
+        LAppPal::PrintLog("[APP]sprite atlas: %d images in %dx%d", static_cast<int>(items.size()), width, height);
+    }
+
+    return true;
+}
+
+int LAppSpriteAtlas::PackShelves(std::vector<PackItem>& items, int width)
+{
+    // 从左向右排列，放不下时换到下一个货架。高度降序，货架高度为第一张图像的高度
+    int shelfX = 0;
+    int shelfY = 0;
+    int shelfHeight = 0;
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        PackItem& item = items[i];
+        if (shelfX + item.width > width)
+        {
+            shelfY += shelfHeight;
+            shelfX = 0;
+            shelfHeight = 0;
+        }
+
+        item.x = shelfX;
+        item.y = shelfY;
+        shelfX += item.width;
+        shelfHeight = std::max(shelfHeight, item.height);
+    }
+
+    return shelfY + shelfHeight;
+}
+
+const LAppSpriteAtlas::Region* LAppSpriteAtlas::GetRegion(const std::string& fileName) const
+{
+    std::map<std::string, Region>::const_iterator it = _regions.find(fileName);
+    return it != _regions.end() ? &it->second : NULL;
+}
+
+void LAppSpriteAtlas::Release()
+{
+    if (_textureId != 0)
+    {
+        glDeleteTextures(1, &_textureId);
+        _textureId = 0;
+    }
+
+    _width = 0;
+    _height = 0;
+    _regions.clear();
+}
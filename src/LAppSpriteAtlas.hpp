@@ -0,0 +1,133 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+ /**
+ * @brief 精灵图集
+ *
+ * 将多张UI图像打包到一张纹理中。
+ *
+ 这段代码定义了一个名为LAppSpriteAtlas的类，用于把LAppView的背景、按钮等UI图像合并为一张纹理。
+
+读取时并行解码所有图像，按高度降序用货架算法（shelf）排列，每张图像周围留出SpriteAtlasPadding像素，
+并用边缘像素填充，双线性过滤时不会混入相邻图像的颜色。各精灵通过子矩形的UV引用图集，
+整个UI层只需绑定一次纹理，增加精灵时绑定次数和纹理数量都不会增加。
+
+图集纹理由本类持有（不经过LAppTextureManager，不受显存预算的淘汰影响），不生成mip链。
+
+Region：图像在图集中的位置和UV。
+Build()：读取图像并生成图集纹理。
+GetRegion()：根据文件名获取图像的位置和UV。
+GetTextureId()/GetWidth()/GetHeight()：获取图集的纹理ID和尺寸。
+Release()：删除图集纹理。
+ */
+class LAppSpriteAtlas
+{
+public:
+    /**
+    * @brief 图像在图集中的位置
+    */
+    struct Region
+    {
+        int x;                  ///< 左上角的x坐标（像素）
+        int y;                  ///< 左上角的y坐标（像素）
+        int width;              ///< 宽度
+        int height;             ///< 高度
+        GLfloat uvVertex[8];    ///< 与LAppSprite的顶点顺序（右上、左上、左下、右下）对应的UV
+    };
+
+    /**
+    * @brief 构造函数
+    */
+    LAppSpriteAtlas();
+
+    /**
+    * @brief 析构函数
+    */
+    ~LAppSpriteAtlas();
+
+    /**
+    * @brief 读取图像并生成图集纹理
+    *
+    * 需在OpenGL上下文所在的线程上调用。已生成时先释放。
+    *
+    * @param[in]   fileNames   图像文件路径名
+    * @return                  所有图像都读取并放入图集时返回true
+    */
+    bool Build(const std::vector<std::string>& fileNames);
+
+    /**
+    * @brief 根据文件名获取图像在图集中的位置
+    *
+    * @param[in]   fileName    Build时指定的图像文件路径名
+    * @return                  不在图集中时返回NULL
+    */
+    const Region* GetRegion(const std::string& fileName) const;
+
+    /**
+    * @brief 获取图集的纹理ID
+    */
+    GLuint GetTextureId() const
+    {
+        return _textureId;
+    }
+
+    /**
+    * @brief 获取图集的宽度
+    */
+    int GetWidth() const
+    {
+        return _width;
+    }
+
+    /**
+    * @brief 获取图集的高度
+    */
+    int GetHeight() const
+    {
+        return _height;
+    }
+
+    /**
+    * @brief 删除图集纹理
+    */
+    void Release();
+
+private:
+    /**
+    * @brief 排列的单位
+    */
+    struct PackItem
+    {
+        int index;      ///< 图像的编号
+        int width;      ///< 包括边距的宽度
+        int height;     ///< 包括边距的高度
+        int x;          ///< 排列后包括边距的左上角的x坐标
+        int y;          ///< 排列后包括边距的左上角的y坐标
+    };
+
+    /**
+    * @brief 以指定的宽度按货架算法排列
+    *
+    * @param[in,out]   items       按高度降序排列的图像
+    * @param[in]       width       图集的宽度
+    * @return                      使用的高度
+    */
+    static int PackShelves(std::vector<PackItem>& items, int width);
+
+    GLuint _textureId;                          ///< 图集纹理ID
+    int _width;                                 ///< 图集的宽度
+    int _height;                                ///< 图集的高度
+    std::map<std::string, Region> _regions;     ///< 文件名到位置的映射
+};
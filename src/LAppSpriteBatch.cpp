@@ -0,0 +1,231 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppSpriteBatch.hpp"
+#include <algorithm>
+#include "LAppDefine.hpp"
+#include "LAppPal.hpp"
+#include "LAppSprite.hpp"
+
+using namespace LAppDefine;
+
+namespace
+{
+    const int FloatsPerVertex = 4;      // x, y, u, v
+    const int VerticesPerSprite = 4;
+    const int IndicesPerSprite = 6;
+}
+
+LAppSpriteBatch::LAppSpriteBatch(GLuint programId)
+    : _vertexBuffer(0)
+    , _indexBuffer(0)
+    , _indexCapacity(0)
+    , _viewportWidth(0)
+    , _viewportHeight(0)
+    , _dirty(true)
+    , _builtRevision(0)
+    , _drawCallCount(0)
+{
+    _positionLocation = glGetAttribLocation(programId, "position");
+    _uvLocation = glGetAttribLocation(programId, "uv");
+    _textureLocation = glGetUniformLocation(programId, "texture");
+    _colorLocation = glGetUniformLocation(programId, "baseColor");
+
+    glGenBuffers(1, &_vertexBuffer);
+    glGenBuffers(1, &_indexBuffer);
+}
+
+LAppSpriteBatch::~LAppSpriteBatch()
+{
+    glDeleteBuffers(1, &_vertexBuffer);
+    glDeleteBuffers(1, &_indexBuffer);
+}
+
+void LAppSpriteBatch::AddSprite(LAppSprite* sprite)
+{
+    if (sprite == NULL)
+    {
+        return;
+    }
+
+    if (static_cast<int>(_sprites.size()) >= MaxSprites)
+    {
+        if (DebugLogEnable)
+        {
+            LAppPal::PrintLog("[APP]sprite batch is full: %d sprites", MaxSprites);
+        }
+        return;
+    }
+
+    _sprites.push_back(sprite);
+    _dirty = true;
+}
+
+void LAppSpriteBatch::RemoveSprite(LAppSprite* sprite)
+{
+    std::vector<LAppSprite*>::iterator it = std::find(_sprites.begin(), _sprites.end(), sprite);
+    if (it != _sprites.end())
+    {
+        _sprites.erase(it);
+        _dirty = true;
+    }
+}
+
+void LAppSpriteBatch::SetViewportSize(int width, int height)
+{
+    if (width != _viewportWidth || height != _viewportHeight)
+    {
+        _viewportWidth = width;
+        _viewportHeight = height;
+        _dirty = true;
+    }
+}
+
+unsigned int LAppSpriteBatch::GetRevisionSum() const
+{
+    unsigned int sum = 0;
+    for (size_t i = 0; i < _sprites.size(); i++)
+    {
+        sum += _sprites[i]->GetRevision();
+    }
+    return sum;
+}
+
+void LAppSpriteBatch::Rebuild()
+{
+    const int spriteCount = static_cast<int>(_sprites.size());
+
+    // 索引对所有精灵相同，只在精灵数超过容量时重新生成
+    if (spriteCount > _indexCapacity)
+    {
+        int capacity = _indexCapacity > 0 ? _indexCapacity : 16;
+        while (capacity < spriteCount)
+        {
+            capacity *= 2;
+        }
+        capacity = std::min(capacity, static_cast<int>(MaxSprites));
+
+        std::vector<GLushort> indices(static_cast<size_t>(capacity) * IndicesPerSprite);
+        for (int i = 0; i < capacity; i++)
+        {
+            const GLushort base = static_cast<GLushort>(i * VerticesPerSprite);
+            GLushort* quad = &indices[static_cast<size_t>(i) * IndicesPerSprite];
+            quad[0] = base;
+            quad[1] = static_cast<GLushort>(base + 1);
+            quad[2] = static_cast<GLushort>(base + 2);
+            quad[3] = base;
+            quad[4] = static_cast<GLushort>(base + 2);
+            quad[5] = static_cast<GLushort>(base + 3);
+        }
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), &indices[0], GL_STATIC_DRAW);
+        _indexCapacity = capacity;
+    }
+
+    // 顶点顺序与LAppSprite相同（右上、左上、左下、右下）
+    std::vector<GLfloat> vertices(static_cast<size_t>(spriteCount) * VerticesPerSprite * FloatsPerVertex);
+    const float halfWidth = _viewportWidth * 0.5f;
+    const float halfHeight = _viewportHeight * 0.5f;
+    _ranges.clear();
+    for (int i = 0; i < spriteCount; i++)
+    {
+        const LAppSprite* sprite = _sprites[i];
+        const LAppSprite::Rect& rect = sprite->GetRect();
+        const GLfloat* uv = sprite->GetUvVertex();
+
+        const float right = (rect.right - halfWidth) / halfWidth;
+        const float left = (rect.left - halfWidth) / halfWidth;
+        const float up = (rect.up - halfHeight) / halfHeight;
+        const float down = (rect.down - halfHeight) / halfHeight;
+        const float positions[] = { right, up, left, up, left, down, right, down };
+
+        GLfloat* vertex = &vertices[static_cast<size_t>(i) * VerticesPerSprite * FloatsPerVertex];
+        for (int v = 0; v < VerticesPerSprite; v++)
+        {
+            vertex[v * FloatsPerVertex + 0] = positions[v * 2];
+            vertex[v * FloatsPerVertex + 1] = positions[v * 2 + 1];
+            vertex[v * FloatsPerVertex + 2] = uv[v * 2];
+            vertex[v * FloatsPerVertex + 3] = uv[v * 2 + 1];
+        }
+
+        // 纹理和颜色与前一个精灵相同时合并为一次绘制
+        const float* color = sprite->GetColor();
+        DrawRange* last = _ranges.empty() ? NULL : &_ranges.back();
+        if (last != NULL && last->textureId == sprite->GetTextureId()
+            && std::equal(color, color + 4, last->color))
+        {
+            last->indexCount += IndicesPerSprite;
+            continue;
+        }
+
+        DrawRange range;
+        range.textureId = sprite->GetTextureId();
+        std::copy(color, color + 4, range.color);
+        range.firstIndex = static_cast<GLsizei>(i * IndicesPerSprite);
+        range.indexCount = IndicesPerSprite;
+        _ranges.push_back(range);
+    }
+
+    if (!vertices.empty())
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), &vertices[0], GL_DYNAMIC_DRAW);
+    }
+
+    _builtRevision = GetRevisionSum();
+    _dirty = false;
+}
+
+void LAppSpriteBatch::Render()
+{
+    _drawCallCount = 0;
+
+    if (_sprites.empty() || _viewportWidth == 0 || _viewportHeight == 0)
+    {
+        return; // この際は描画できず
+    }
+
+    if (_dirty || GetRevisionSum() != _builtRevision)
+    {
+        Rebuild();
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+
+    // attribute属性を有効にする
+    glEnableVertexAttribArray(_positionLocation);
+    glEnableVertexAttribArray(_uvLocation);
+
+    const GLsizei stride = FloatsPerVertex * sizeof(GLfloat);
+    glVertexAttribPointer(_positionLocation, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(0));
+    glVertexAttribPointer(_uvLocation, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(2 * sizeof(GLfloat)));
+
+    // uniform属性の登録
+    glUniform1i(_textureLocation, 0);
+
+    GLuint boundTexture = 0;
+    for (size_t i = 0; i < _ranges.size(); i++)
+    {
+        const DrawRange& range = _ranges[i];
+        if (i == 0 || range.textureId != boundTexture)
+        {
+            glBindTexture(GL_TEXTURE_2D, range.textureId);
+            boundTexture = range.textureId;
+        }
+
+        glUniform4f(_colorLocation, range.color[0], range.color[1], range.color[2], range.color[3]);
+        glDrawElements(GL_TRIANGLES, range.indexCount, GL_UNSIGNED_SHORT,
+            reinterpret_cast<const void*>(range.firstIndex * sizeof(GLushort)));
+        _drawCallCount++;
+    }
+
+    // 其他绘制（LAppSprite::RenderImmidiate、Cubism渲染器）使用客户端数组，解除绑定
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
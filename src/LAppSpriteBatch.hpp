@@ -0,0 +1,125 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <vector>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+class LAppSprite;
+
+ /**
+ * @brief 精灵的批量绘制
+ *
+ * 将多个LAppSprite的顶点保存在VBO中，合并绘制。
+ *
+ 这段代码定义了一个名为LAppSpriteBatch的类，用于减少UI精灵每帧的驱动开销。
+
+顶点（位置和UV）保存在常驻的VBO中，只有精灵的矩形、UV、颜色（LAppSprite的修订号）或视口尺寸变化时才重新生成，
+其余的帧只设置属性并绘制。按添加顺序连续、纹理和颜色相同的精灵用一次glDrawElements绘制
+（使用图集时整个UI层为一次绘制）。颜色通过着色器的baseColor统一变量设置，颜色不同时分为多次绘制。
+
+LAppSpriteBatch()：构造函数，需要提供着色器ID。
+~LAppSpriteBatch()：析构函数，删除VBO和IBO。
+AddSprite()/RemoveSprite()：添加/移除精灵（不持有，精灵需在批次之后释放或先移除）。
+SetViewportSize()：设置视口尺寸（窗口尺寸变化时调用）。
+Render()：绘制所有精灵。
+GetDrawCallCount()：获取上次Render的绘制调用次数。
+ */
+class LAppSpriteBatch
+{
+public:
+    /**
+    * @brief 构造函数
+    *
+    * @param[in]       programId    着色器ID
+    */
+    LAppSpriteBatch(GLuint programId);
+
+    /**
+    * @brief 析构函数
+    */
+    ~LAppSpriteBatch();
+
+    /**
+    * @brief 添加精灵
+    *         按添加顺序绘制。最多MaxSprites个。
+    *
+    * @param[in]       sprite       精灵
+    */
+    void AddSprite(LAppSprite* sprite);
+
+    /**
+    * @brief 移除精灵
+    *
+    * @param[in]       sprite       精灵
+    */
+    void RemoveSprite(LAppSprite* sprite);
+
+    /**
+    * @brief 设置视口尺寸
+    *
+    * @param[in]       width        宽度
+    * @param[in]       height       高度
+    */
+    void SetViewportSize(int width, int height);
+
+    /**
+    * @brief 绘制所有精灵
+    *         需在着色器程序生效的状态下调用。结束后解除VBO、IBO的绑定。
+    */
+    void Render();
+
+    /**
+    * @brief 获取上次Render的绘制调用次数
+    */
+    int GetDrawCallCount() const
+    {
+        return _drawCallCount;
+    }
+
+    static const int MaxSprites = 16384;    ///< 16位索引可以表示的精灵数
+
+private:
+    /**
+    * @brief 一次绘制调用
+    */
+    struct DrawRange
+    {
+        GLuint textureId;       ///< 纹理ID
+        float color[4];         ///< 颜色
+        GLsizei firstIndex;     ///< 第一个索引
+        GLsizei indexCount;     ///< 索引数
+    };
+
+    /**
+    * @brief 重新生成顶点和绘制调用
+    */
+    void Rebuild();
+
+    /**
+    * @brief 所有精灵的修订号的合计
+    *         修订号只增不减，合计不变即没有精灵被修改。
+    */
+    unsigned int GetRevisionSum() const;
+
+    std::vector<LAppSprite*> _sprites;  ///< 按绘制顺序排列的精灵
+    std::vector<DrawRange> _ranges;     ///< 绘制调用
+    GLuint _vertexBuffer;               ///< 顶点（x、y、u、v）的VBO
+    GLuint _indexBuffer;                ///< 索引的IBO
+    int _indexCapacity;                 ///< IBO中可绘制的精灵数
+    int _viewportWidth;                 ///< 视口的宽度
+    int _viewportHeight;                ///< 视口的高度
+    bool _dirty;                        ///< 精灵的增减或视口变化后为true
+    unsigned int _builtRevision;        ///< 生成顶点时的修订号的合计
+    int _drawCallCount;                 ///< 上次Render的绘制调用次数
+    int _positionLocation;              ///< 位置属性
+    int _uvLocation;                    ///< UV属性
+    int _textureLocation;               ///< 纹理属性
+    int _colorLocation;                 ///< 颜色属性
+};
@@ -0,0 +1,175 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppTaskPool.hpp"
+#include <chrono>
+#include "LAppDefine.hpp"
+#include "LAppPal.hpp"
+
+using namespace Csm;
+using namespace LAppDefine;
+
+namespace
+{
+    LAppTaskPool* s_instance = NULL;
+}
+
+LAppTaskPool* LAppTaskPool::GetInstance()
+{
+    if (s_instance == NULL)
+    {
+        s_instance = new LAppTaskPool();
+    }
+
+    return s_instance;
+}
+
+void LAppTaskPool::ReleaseInstance()
+{
+    if (s_instance != NULL)
+    {
+        delete s_instance;
+    }
+
+    s_instance = NULL;
+}
+
+LAppTaskPool::LAppTaskPool()
+    : _stopping(false)
+{
+    // 未指定时保留一个核心给渲染线程
+    csmUint32 workerCount = WorkerThreadCount;
+    if (workerCount == 0)
+    {
+        const csmUint32 hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = (hardwareThreads > 1) ? hardwareThreads - 1 : 1;
+    }
+
+    for (csmUint32 i = 0; i < workerCount; i++)
+    {
+        _workers.push_back(std::thread(&LAppTaskPool::WorkerMain, this));
+    }
+}
+
+LAppTaskPool::~LAppTaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _condition.notify_all();
+
+    for (csmUint32 i = 0; i < _workers.size(); i++)
+    {
+        _workers[i].join();
+    }
+}
+
+std::future<void> LAppTaskPool::Submit(const std::function<void()>& task)
+{
+    std::packaged_task<void()> packagedTask(task);
+    std::future<void> future = packagedTask.get_future();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.push_back(std::move(packagedTask));
+    }
+    _condition.notify_one();
+
+    return future;
+}
+
+void LAppTaskPool::RunAll(const std::vector<std::function<void()> >& tasks)
+{
+    std::vector<std::future<void> > futures;
+    futures.reserve(tasks.size());
+    for (csmUint32 i = 0; i < tasks.size(); i++)
+    {
+        futures.push_back(Submit(tasks[i]));
+    }
+
+    // 等待期间调用线程也执行队列中的任务（在工作线程上调用时也不会死锁）
+    for (csmUint32 i = 0; i < futures.size(); i++)
+    {
+        while (futures[i].wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            if (!RunPendingTask())
+            {
+                futures[i].wait();
+            }
+        }
+    }
+
+    // 任务可能引用调用方栈上的数据，全部结束后再传播异常
+    std::exception_ptr firstException;
+    for (csmUint32 i = 0; i < futures.size(); i++)
+    {
+        try
+        {
+            futures[i].get();
+        }
+        catch (...)
+        {
+            if (!firstException)
+            {
+                firstException = std::current_exception();
+            }
+        }
+    }
+
+    if (firstException)
+    {
+        if (DebugLogEnable)
+        {
+            LAppPal::PrintLog("[APP]task pool: task threw an exception");
+        }
+        std::rethrow_exception(firstException);
+    }
+}
+
+csmUint32 LAppTaskPool::GetWorkerCount() const
+{
+    return static_cast<csmUint32>(_workers.size());
+}
+
+void LAppTaskPool::WorkerMain()
+{
+    for (;;)
+    {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (!_stopping && _tasks.empty())
+            {
+                _condition.wait(lock);
+            }
+            if (_tasks.empty())
+            {
+                return;
+            }
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+        task();
+    }
+}
+
+csmBool LAppTaskPool::RunPendingTask()
+{
+    std::packaged_task<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_tasks.empty())
+        {
+            return false;
+        }
+        task = std::move(_tasks.front());
+        _tasks.pop_front();
+    }
+    task();
+
+    return true;
+}
@@ -0,0 +1,99 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <CubismFramework.hpp>
+
+ /**
+ * @brief 工作线程池
+ *
+ * 在固定数量的工作线程上执行素材读取、解析等与OpenGL无关的任务。
+ *
+ 这段代码定义了一个名为LAppTaskPool的类（单例），用于在后台线程上并行执行任务。
+
+GetInstance/ReleaseInstance：获取/释放类的实例。
+Submit：向队列添加一个任务，返回用于等待完成的future。
+RunAll：并行执行一组任务并等待全部完成。等待期间调用线程也会执行队列中的任务，因此可以在任务内部嵌套调用。
+任务抛出的异常在全部任务结束后由RunAll重新抛出。
+GetWorkerCount：获取工作线程数。
+ */
+class LAppTaskPool
+{
+public:
+    /**
+    * @brief   返回类的实例（单例）。如果实例尚未创建，将在内部创建实例。
+    *          创建不加锁，首次调用需在主线程上进行（LAppDelegate::Initialize中创建）。
+    *
+    * @return  类的实例
+    */
+    static LAppTaskPool* GetInstance();
+
+    /**
+    * @brief   释放类的实例（单例）。等待已提交的任务全部结束。
+    *
+    */
+    static void ReleaseInstance();
+
+    /**
+    * @brief   向队列添加任务
+    *
+    * @param[in]   task    要执行的任务
+    * @return              任务完成时变为就绪的future
+    */
+    std::future<void> Submit(const std::function<void()>& task);
+
+    /**
+    * @brief   并行执行任务并等待全部完成
+    *          任务抛出异常时，等待其他任务全部结束后重新抛出第一个异常。
+    *
+    * @param[in]   tasks   要执行的任务
+    */
+    void RunAll(const std::vector<std::function<void()> >& tasks);
+
+    /**
+    * @brief   获取工作线程数
+    */
+    Csm::csmUint32 GetWorkerCount() const;
+
+private:
+    /**
+    * @brief  构造函数
+    */
+    LAppTaskPool();
+
+    /**
+    * @brief  析构函数
+    */
+    ~LAppTaskPool();
+
+    /**
+    * @brief  工作线程的主循环
+    */
+    void WorkerMain();
+
+    /**
+    * @brief  从队列中取出一个任务并在调用线程上执行
+    *
+    * @return 执行了任务时返回true，队列为空时返回false
+    */
+    Csm::csmBool RunPendingTask();
+
+    std::vector<std::thread> _workers;                  ///< 工作线程
+    std::deque<std::packaged_task<void()> > _tasks;     ///< 等待执行的任务
+    std::mutex _mutex;                                  ///< 保护_tasks和_stopping
+    std::condition_variable _condition;                 ///< 通知任务到达和结束请求
+    Csm::csmBool _stopping;                             ///< 结束请求
+};
@@ -0,0 +1,256 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppTextureCache.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <vector>
+#include <sys/stat.h>
+#include "LAppDefine.hpp"
+#include "LAppImageKernel.hpp"
+#include "LAppLoadTracer.hpp"
+#include "LAppPal.hpp"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace Csm;
+using namespace LAppDefine;
+
+namespace
+{
+    const csmUint32 CacheMagic = 0x4354324C; // "L2TC"
+    const csmUint32 CacheVersion = 1;
+    const csmUint32 CacheFlagPremultiplied = 1 << 0;
+    const csmUint32 CacheQualityShift = 8;
+
+    /**
+    * @brief 缓存文件头（之后依次为源文件路径和像素，像素从dataOffset开始）
+    */
+    struct CacheHeader
+    {
+        csmUint32 magic;
+        csmUint32 version;
+        csmUint32 flags;
+        csmUint32 width;
+        csmUint32 height;
+        csmUint32 mipLevels;
+        csmUint64 sourceSize;
+        csmUint64 sourceModifiedTime;
+        csmUint32 pathLength;
+        csmUint32 dataOffset;
+    };
+
+    std::once_flag s_directoryOnce;
+    std::atomic<csmUint32> s_tempCounter(0);
+
+    csmUint32 GetCacheFlags(LAppTextureManager::TextureQuality quality)
+    {
+        const csmUint32 qualityFlags = static_cast<csmUint32>(quality) << CacheQualityShift;
+#ifdef PREMULTIPLIED_ALPHA_ENABLE
+        return CacheFlagPremultiplied | qualityFlags;
+#else
+        return qualityFlags;
+#endif
+    }
+
+    // 以源文件路径（和质量）的哈希作为缓存文件名
+    std::string GetCachePath(const std::string& fileName, LAppTextureManager::TextureQuality quality)
+    {
+        std::string key = fileName;
+        if (quality != LAppTextureManager::TextureQuality_Full)
+        {
+            key += '#';
+            key += static_cast<char>('0' + quality);
+        }
+
+        return std::string(TextureCacheDirectory) + LAppPal::MakeCacheFileName(key) + ".l2tc";
+    }
+
+    void CreateCacheDirectory()
+    {
+        LAppPal::MakeDirectory(TextureCacheDirectory);
+    }
+
+    csmUint32 GetMipLevelCount(csmUint32 width, csmUint32 height)
+    {
+        csmUint32 levels = 1;
+        while (width > 1 || height > 1)
+        {
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+            levels++;
+        }
+        return levels;
+    }
+}
+
+csmBool LAppTextureCache::Load(const std::string& fileName, const LAppPal::FileStamp& stamp, LAppTextureManager::TextureQuality quality, LAppTextureManager::DecodedImage* outImage)
+{
+    const std::string cachePath = GetCachePath(fileName, quality);
+
+    struct stat statBuf;
+    if (stat(cachePath.c_str(), &statBuf) != 0)
+    {
+        return false;
+    }
+
+    LAppLoadTracer::Scope trace("texture_cache_read", fileName.c_str());
+
+    csmSizeInt size = 0;
+    csmByte* bytes = LAppPal::LoadFileAsBytes(cachePath, &size);
+    if (bytes == NULL)
+    {
+        return false;
+    }
+
+    CacheHeader header;
+    csmBool valid = size >= sizeof(CacheHeader);
+    if (valid)
+    {
+        memcpy(&header, bytes, sizeof(CacheHeader));
+        valid = header.magic == CacheMagic
+            && header.version == CacheVersion
+            && header.flags == GetCacheFlags(quality)
+            && header.sourceSize == stamp.size
+            && header.sourceModifiedTime == stamp.modifiedTime
+            && header.pathLength == fileName.size()
+            && header.width > 0 && header.height > 0
+            && header.mipLevels >= 1 && header.mipLevels <= GetMipLevelCount(header.width, header.height)
+            && sizeof(CacheHeader) + header.pathLength <= size
+            && memcmp(bytes + sizeof(CacheHeader), fileName.c_str(), header.pathLength) == 0;
+    }
+
+    if (valid)
+    {
+        // 校验像素数据的长度
+        csmUint64 pixelBytes = 0;
+        csmUint32 width = header.width;
+        csmUint32 height = header.height;
+        for (csmUint32 level = 0; level < header.mipLevels; level++)
+        {
+            pixelBytes += static_cast<csmUint64>(width) * height * 4;
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+        valid = header.dataOffset >= sizeof(CacheHeader) + header.pathLength
+            && header.dataOffset + pixelBytes == size;
+        trace.SetBytes(static_cast<csmSizeInt>(pixelBytes));
+    }
+
+    if (!valid)
+    {
+        LAppPal::ReleaseBytes(bytes);
+        return false;
+    }
+
+    outImage->fileName = fileName;
+    outImage->width = static_cast<int>(header.width);
+    outImage->height = static_cast<int>(header.height);
+    outImage->quality = quality;
+    outImage->mipLevels = static_cast<int>(header.mipLevels);
+    outImage->pixels = bytes + header.dataOffset;
+    outImage->mappedData = bytes;
+
+    return true;
+}
+
+csmBool LAppTextureCache::Store(const LAppPal::FileStamp& stamp, const LAppTextureManager::DecodedImage& image)
+{
+    if (image.pixels == NULL || image.width <= 0 || image.height <= 0)
+    {
+        return false;
+    }
+
+    LAppLoadTracer::Scope trace("texture_cache_write", image.fileName.c_str());
+
+    std::call_once(s_directoryOnce, CreateCacheDirectory);
+
+    CacheHeader header;
+    header.magic = CacheMagic;
+    header.version = CacheVersion;
+    header.flags = GetCacheFlags(image.quality);
+    header.width = static_cast<csmUint32>(image.width);
+    header.height = static_cast<csmUint32>(image.height);
+    header.mipLevels = TextureCacheMipmapEnable ? GetMipLevelCount(header.width, header.height) : 1;
+    header.sourceSize = stamp.size;
+    header.sourceModifiedTime = stamp.modifiedTime;
+    header.pathLength = static_cast<csmUint32>(image.fileName.size());
+    // 像素按16字节对齐，映射后可以直接上传
+    header.dataOffset = (static_cast<csmUint32>(sizeof(CacheHeader)) + header.pathLength + 15) & ~15u;
+
+    const std::string cachePath = GetCachePath(image.fileName, image.quality);
+    std::ostringstream tempPath;
+    tempPath << cachePath << ".tmp" << s_tempCounter++;
+
+    std::ofstream file(tempPath.str().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        if (DebugLogEnable)
+        {
+            LAppPal::PrintLog("[APP]texture cache write error: %s", tempPath.str().c_str());
+        }
+        return false;
+    }
+
+    const char padding[16] = { 0 };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+    file.write(image.fileName.c_str(), header.pathLength);
+    file.write(padding, header.dataOffset - sizeof(CacheHeader) - header.pathLength);
+
+    csmUint32 width = header.width;
+    csmUint32 height = header.height;
+    csmSizeInt totalBytes = static_cast<csmSizeInt>(width) * height * 4;
+    file.write(reinterpret_cast<const char*>(image.pixels), totalBytes);
+
+    if (header.mipLevels > 1)
+    {
+        std::vector<csmUint8> source(image.pixels, image.pixels + totalBytes);
+        std::vector<csmUint8> level;
+        for (csmUint32 i = 1; i < header.mipLevels; i++)
+        {
+            const csmUint32 nextWidth = width > 1 ? width / 2 : 1;
+            const csmUint32 nextHeight = height > 1 ? height / 2 : 1;
+            level.resize(static_cast<size_t>(nextWidth) * nextHeight * 4);
+            LAppImageKernel::DownsampleBox(&source[0], width, height, &level[0], nextWidth, nextHeight);
+            file.write(reinterpret_cast<const char*>(&level[0]), level.size());
+            totalBytes += static_cast<csmSizeInt>(level.size());
+
+            source.swap(level);
+            width = nextWidth;
+            height = nextHeight;
+        }
+    }
+
+    file.close();
+    trace.SetBytes(totalBytes);
+
+    if (file.fail())
+    {
+        std::remove(tempPath.str().c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    const csmBool renamed = MoveFileExA(tempPath.str().c_str(), cachePath.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    const csmBool renamed = std::rename(tempPath.str().c_str(), cachePath.c_str()) == 0;
+#endif
+    if (!renamed)
+    {
+        std::remove(tempPath.str().c_str());
+        return false;
+    }
+
+    return true;
+}
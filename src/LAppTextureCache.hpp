@@ -0,0 +1,55 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <string>
+#include <CubismFramework.hpp>
+#include "LAppPal.hpp"
+#include "LAppTextureManager.hpp"
+
+ /**
+ * @brief 解码后纹理的磁盘缓存
+ *
+ * 将PNG解码后的RGBA8像素保存到磁盘，下次启动时不再解码。
+ *
+ 这段代码定义了一个名为LAppTextureCache的类（静态类），用于缩短启动到第一帧的时间。
+
+缓存文件以源文件路径和读取质量的哈希命名，保存在TextureCacheDirectory中。文件头记录源文件的路径、大小和修改时间，
+任意一项不一致时视为未命中（编辑PNG后自动重新生成）。像素在PREMULTIPLIED_ALPHA_ENABLE时已预乘，
+TextureCacheMipmapEnable为true时还保存完整的mip链。以1/2、1/4质量读取时保存缩小后的像素。
+
+Load：从缓存读取图像。像素直接指向缓存文件的内存映射视图（MappedFileReadEnable为true时），不进行复制。
+Store：将解码后的图像写入缓存。
+
+只缓存磁盘上存在的源文件，素材包内的图像不缓存。所有函数都可以在工作线程上调用。
+ */
+class LAppTextureCache
+{
+public:
+    /**
+    * @brief 从缓存读取图像
+    *
+    * @param[in]   fileName    源文件路径
+    * @param[in]   stamp       源文件的标识
+    * @param[in]   quality     读取质量
+    * @param[out]  outImage    读取的图像。使用后需通过LAppTextureManager::ReleaseDecodedImage释放
+    * @return                  命中时返回true
+    */
+    static Csm::csmBool Load(const std::string& fileName, const LAppPal::FileStamp& stamp, LAppTextureManager::TextureQuality quality, LAppTextureManager::DecodedImage* outImage);
+
+    /**
+    * @brief 将解码后的图像写入缓存
+    *
+    * 先写入临时文件再重命名，写入中途失败也不会留下不完整的缓存。
+    *
+    * @param[in]   stamp   解码前获取的源文件的标识
+    * @param[in]   image   解码后的图像（只使用第0级，按image.quality保存）
+    * @return              成功时返回true
+    */
+    static Csm::csmBool Store(const LAppPal::FileStamp& stamp, const LAppTextureManager::DecodedImage& image);
+};
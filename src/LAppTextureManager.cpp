@@ -7,13 +7,91 @@
 
 #include "LAppTextureManager.hpp"
 #include <iostream>
+#include <cstring>
 #define STBI_NO_STDIO
 #define STBI_ONLY_PNG
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include "LAppPal.hpp"
+#include "LAppLoadTracer.hpp"
+#include "LAppDefine.hpp"
+#include "LAppImageKernel.hpp"
+#include "LAppTaskPool.hpp"
+#include "LAppTextureCache.hpp"
+#include <chrono>
+#include <cstring>
+#include <functional>
+
+namespace
+{
+    // 索引的键。原始分辨率为文件名本身，其他质量在文件名后附加后缀
+    std::string MakeTextureKey(const std::string& fileName, LAppTextureManager::TextureQuality quality)
+    {
+        switch (quality)
+        {
+        case LAppTextureManager::TextureQuality_Half:
+            return fileName + "#half";
+        case LAppTextureManager::TextureQuality_Quarter:
+            return fileName + "#quarter";
+        default:
+            return fileName;
+        }
+    }
+
+    // 显存字节数（包括mip链）
+    Csm::csmSizeInt GetTextureBytes(int width, int height)
+    {
+        Csm::csmSizeInt bytes = 0;
+        for (;;)
+        {
+            bytes += static_cast<Csm::csmSizeInt>(width) * height * 4;
+            if (width <= 1 && height <= 1)
+            {
+                break;
+            }
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+        return bytes;
+    }
+
+    // 图像中连续存放的所有mip级的字节数
+    Csm::csmSizeInt GetImageBytes(const LAppTextureManager::DecodedImage& image)
+    {
+        Csm::csmSizeInt bytes = 0;
+        int width = image.width;
+        int height = image.height;
+        for (int level = 0; level < image.mipLevels; level++)
+        {
+            bytes += static_cast<Csm::csmSizeInt>(width) * height * 4;
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+        return bytes;
+    }
+
+    // 将当前绑定的纹理的第0级设为1x1透明图像（与占位纹理相同）
+    void SetPlaceholderImage()
+    {
+        const unsigned char transparent[4] = { 0, 0, 0, 0 };
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, transparent);
+    }
+
+    // PBO、glMapBufferRange和同步对象都可用时才进行流式上传
+    bool IsStreamingSupported()
+    {
+        return GLEW_VERSION_3_2
+            || (GLEW_ARB_pixel_buffer_object && GLEW_ARB_map_buffer_range && GLEW_ARB_sync);
+    }
+}
 
 LAppTextureManager::LAppTextureManager()
+    : _totalBytes(0)
+    , _residentBytes(0)
+    , _frame(0)
+    , _evictionCount(0)
+    , _restoreCount(0)
+    , _placeholderTextureId(0)
 {
 }
 
@@ -22,24 +100,57 @@ LAppTextureManager::~LAppTextureManager()
     ReleaseTextures();
 }
 
-LAppTextureManager::TextureInfo* LAppTextureManager::CreateTextureFromPngFile(std::string fileName)
+LAppTextureManager::TextureInfo* LAppTextureManager::CreateTextureFromPngFile(std::string fileName, TextureQuality quality)
 {
     //search loaded texture already.
-    for (Csm::csmUint32 i = 0; i < _textures.GetSize(); i++)
+    TextureInfo* loaded = GetTextureInfoByName(fileName, quality);
+    if (loaded != NULL)
     {
-        if (_textures[i]->fileName == fileName)
-        {
-            return _textures[i];
-        }
+        loaded->refCount++;
+        return loaded;
     }
 
-    GLuint textureId;
+    DecodedImage image;
+    if (!DecodePngFile(fileName, &image, quality))
+    {
+        return NULL;
+    }
+
+    TextureInfo* textureInfo = CreateTextureFromDecodedImage(image);
+    ReleaseDecodedImage(&image);
+
+    return textureInfo;
+}
+
+bool LAppTextureManager::DecodePngFile(const std::string& fileName, DecodedImage* outImage, TextureQuality quality)
+{
     int width, height, channels;
     unsigned int size;
     unsigned char* png;
     unsigned char* address;
 
-    address = LAppPal::LoadFileAsBytes(fileName, &size);
+    // 源文件未变更时直接使用缓存中解码后的像素
+    LAppPal::FileStamp stamp;
+    const bool cacheable = LAppDefine::TextureCacheEnable && LAppPal::GetFileStamp(fileName, &stamp);
+    if (cacheable && LAppTextureCache::Load(fileName, stamp, quality, outImage))
+    {
+        return true;
+    }
+
+    {
+        LAppLoadTracer::Scope trace("read", fileName.c_str());
+        address = LAppPal::LoadFileAsBytes(fileName, &size);
+        if (address != NULL)
+        {
+            trace.SetBytes(size);
+        }
+    }
+    if (address == NULL)
+    {
+        return false;
+    }
+
+    LAppLoadTracer::Scope trace("png_decode", fileName.c_str());
 
     // png情報を取得する
     png = stbi_load_from_memory(
@@ -49,92 +160,926 @@ LAppTextureManager::TextureInfo* LAppTextureManager::CreateTextureFromPngFile(st
         &height,
         &channels,
         STBI_rgb_alpha);
+    LAppPal::ReleaseBytes(address);
+
+    if (png == NULL)
     {
+        LAppPal::PrintLog("[APP]png decode error: %s", fileName.c_str());
+        return false;
+    }
 
 #ifdef PREMULTIPLIED_ALPHA_ENABLE
-        unsigned int* fourBytes = reinterpret_cast<unsigned int*>(png);
-        for (int i = 0; i < width * height; i++)
+    // 按CPU选择SIMD实现，结果与Premultiply逐位一致
+    LAppImageKernel::PremultiplyAlpha(png, static_cast<Csm::csmSizeInt>(width) * height);
+#endif
+
+    // 按质量原地缩小（UV为归一化坐标，不受影响）
+    for (int i = 0; i < quality && (width > 1 || height > 1); i++)
+    {
+        const int nextWidth = width > 1 ? width / 2 : 1;
+        const int nextHeight = height > 1 ? height / 2 : 1;
+        LAppImageKernel::DownsampleBox(png, width, height, png, nextWidth, nextHeight);
+        width = nextWidth;
+        height = nextHeight;
+    }
+
+    trace.SetBytes(static_cast<Csm::csmSizeInt>(width) * height * 4);
+
+    outImage->fileName = fileName;
+    outImage->width = width;
+    outImage->height = height;
+    outImage->quality = quality;
+    outImage->mipLevels = 1;
+    outImage->pixels = png;
+    outImage->mappedData = NULL;
+
+    if (cacheable)
+    {
+        LAppTextureCache::Store(stamp, *outImage);
+    }
+
+    return true;
+}
+
+bool LAppTextureManager::GetPngDecodedBytes(const std::string& fileName, TextureQuality quality, Csm::csmSizeInt* outBytes)
+{
+    // 签名8字节、IHDR块的长度和类型8字节之后是大端的宽度和高度
+    static const unsigned char Signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    const Csm::csmSizeInt HeaderSize = 24;
+
+    Csm::csmSizeInt size = 0;
+    Csm::csmByte* data = LAppPal::LoadFileAsBytes(fileName, &size);
+    if (data == NULL)
+    {
+        return false;
+    }
+
+    const bool valid = size >= HeaderSize && memcmp(data, Signature, sizeof(Signature)) == 0 && memcmp(data + 12, "IHDR", 4) == 0;
+    Csm::csmUint32 width = 0;
+    Csm::csmUint32 height = 0;
+    if (valid)
+    {
+        width = (static_cast<Csm::csmUint32>(data[16]) << 24) | (data[17] << 16) | (data[18] << 8) | data[19];
+        height = (static_cast<Csm::csmUint32>(data[20]) << 24) | (data[21] << 16) | (data[22] << 8) | data[23];
+    }
+    LAppPal::ReleaseBytes(data);
+
+    if (!valid)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < quality && (width > 1 || height > 1); i++)
+    {
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+
+    *outBytes = static_cast<Csm::csmSizeInt>(width) * height * 4;
+    return true;
+}
+
+void LAppTextureManager::ReleaseDecodedImage(DecodedImage* image)
+{
+    if (image->mappedData != NULL)
+    {
+        LAppPal::ReleaseBytes(image->mappedData);
+        image->mappedData = NULL;
+        image->pixels = NULL;
+    }
+    else if (image->pixels != NULL)
+    {
+        stbi_image_free(image->pixels);
+        image->pixels = NULL;
+    }
+}
+
+void LAppTextureManager::DecodePngFiles(const std::vector<std::string>& fileNames, std::vector<DecodedImage>& outImages, TextureQuality quality)
+{
+    outImages.resize(fileNames.size());
+    for (Csm::csmUint32 i = 0; i < fileNames.size(); i++)
+    {
+        outImages[i].fileName = fileNames[i];
+        outImages[i].width = 0;
+        outImages[i].height = 0;
+        outImages[i].quality = quality;
+        outImages[i].mipLevels = 1;
+        outImages[i].pixels = NULL;
+        outImages[i].mappedData = NULL;
+    }
+
+    // 每张纹理的inflate相互独立，按文件并行解码
+    std::vector<std::function<void()> > tasks;
+    for (Csm::csmUint32 i = 0; i < fileNames.size(); i++)
+    {
+        DecodedImage* image = &outImages[i];
+        tasks.push_back([image, quality]()
+        {
+            const std::string fileName = image->fileName;
+            DecodePngFile(fileName, image, quality);
+        });
+    }
+
+    if (LAppDefine::ParallelSetupEnable && tasks.size() > 1)
+    {
+        LAppTaskPool::GetInstance()->RunAll(tasks);
+    }
+    else
+    {
+        for (Csm::csmUint32 i = 0; i < tasks.size(); i++)
         {
-            unsigned char* p = png + i * 4;
-            fourBytes[i] = Premultiply(p[0], p[1], p[2], p[3]);
+            tasks[i]();
+        }
+    }
+}
+
+void LAppTextureManager::CreateTexturesFromPngFiles(const std::vector<std::string>& fileNames, std::vector<TextureInfo*>& outTextures, TextureQuality quality)
+{
+    outTextures.assign(fileNames.size(), NULL);
+
+    // 已加载的图像不再解码
+    std::vector<std::string> decodeFileNames;
+    std::vector<Csm::csmUint32> decodeIndices;
+    for (Csm::csmUint32 i = 0; i < fileNames.size(); i++)
+    {
+        outTextures[i] = GetTextureInfoByName(fileNames[i], quality);
+        if (outTextures[i] != NULL)
+        {
+            outTextures[i]->refCount++;
+        }
+        else
+        {
+            decodeFileNames.push_back(fileNames[i]);
+            decodeIndices.push_back(i);
         }
-#endif
     }
 
+    std::vector<DecodedImage> images;
+    DecodePngFiles(decodeFileNames, images, quality);
+
+    // 在OpenGL的线程上一次上传
+    for (Csm::csmUint32 i = 0; i < images.size(); i++)
+    {
+        if (images[i].pixels == NULL)
+        {
+            continue;
+        }
+
+        outTextures[decodeIndices[i]] = CreateTextureFromDecodedImage(images[i]);
+        ReleaseDecodedImage(&images[i]);
+    }
+}
+
+LAppTextureManager::TextureInfo* LAppTextureManager::CreateTextureFromDecodedImage(const DecodedImage& image)
+{
+    //search loaded texture already.
+    TextureInfo* loaded = GetTextureInfoByName(image.fileName, image.quality);
+    if (loaded != NULL)
+    {
+        loaded->refCount++;
+        return loaded;
+    }
+
+    LAppLoadTracer::Scope trace("gl_upload", image.fileName.c_str(), static_cast<Csm::csmSizeInt>(image.width) * image.height * 4);
+
+    GLuint textureId;
+
     // OpenGL用のテクスチャを生成する
     glGenTextures(1, &textureId);
     glBindTexture(GL_TEXTURE_2D, textureId);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, png);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    UploadImage(image);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glBindTexture(GL_TEXTURE_2D, 0);
 
-    // 解放処理
-    stbi_image_free(png);
-    LAppPal::ReleaseBytes(address);
+    return RegisterTexture(textureId, image);
+}
 
+LAppTextureManager::TextureInfo* LAppTextureManager::RegisterTexture(GLuint textureId, const DecodedImage& image)
+{
     LAppTextureManager::TextureInfo* textureInfo = new LAppTextureManager::TextureInfo();
     if (textureInfo != NULL)
     {
-        textureInfo->fileName = fileName;
-        textureInfo->width = width;
-        textureInfo->height = height;
+        textureInfo->fileName = image.fileName;
+        textureInfo->quality = image.quality;
+        textureInfo->width = image.width;
+        textureInfo->height = image.height;
         textureInfo->id = textureId;
+        textureInfo->refCount = 1;
+        textureInfo->byteSize = GetTextureBytes(image.width, image.height);
+        textureInfo->resident = true;
+        textureInfo->lastUsedFrame = _frame;
+        textureInfo->lruPosition = _lru.insert(_lru.begin(), textureInfo);
+        textureInfo->streaming = false;
+        textureInfo->restoring = false;
+        textureInfo->restoreFailed = false;
+
+        _texturesByName[MakeTextureKey(textureInfo->fileName, textureInfo->quality)] = textureInfo;
+        _texturesById[textureId] = textureInfo;
+        _totalBytes += textureInfo->byteSize;
+        _residentBytes += textureInfo->byteSize;
+    }
+
+    return textureInfo;
+}
+
+LAppTextureManager::TextureInfo* LAppTextureManager::CreateTextureStreamed(DecodedImage* image)
+{
+    TextureInfo* loaded = GetTextureInfoByName(image->fileName, image->quality);
+    if (loaded != NULL)
+    {
+        loaded->refCount++;
+        ReleaseDecodedImage(image);
+        return loaded;
+    }
+
+    StreamJob* job = NULL;
+    if (LAppDefine::TextureStreamingEnable && IsStreamingSupported())
+    {
+        LAppLoadTracer::Scope trace("pbo_map", image->fileName.c_str());
 
-        _textures.PushBack(textureInfo);
+        const Csm::csmSizeInt bytes = GetImageBytes(*image);
+        trace.SetBytes(bytes);
+
+        GLuint buffer;
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), NULL, GL_STREAM_DRAW);
+        void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        if (mapped == NULL)
+        {
+            // 映射失败时同步上传
+            glDeleteBuffers(1, &buffer);
+        }
+        else
+        {
+            job = new StreamJob();
+            job->texture = NULL;
+            job->image = *image;
+            job->buffer = buffer;
+            job->mapped = mapped;
+            job->uploadedRows = 0;
+            job->fence = NULL;
+
+            // 像素的所有权转移给任务
+            image->pixels = NULL;
+            image->mappedData = NULL;
+
+            // 映射的地址可以在任何线程上写入，只有GL调用留在主线程
+            const unsigned char* source = job->image.pixels;
+            if (LAppDefine::ParallelSetupEnable)
+            {
+                // 主线程需要等待时直接领取复制，因此任务开始时先确认是否已被领取
+                std::shared_ptr<std::atomic<bool> > claimed = std::make_shared<std::atomic<bool> >(false);
+                job->copyClaimed = claimed;
+                job->copy = LAppTaskPool::GetInstance()->Submit([claimed, mapped, source, bytes]()
+                {
+                    if (!claimed->exchange(true))
+                    {
+                        memcpy(mapped, source, bytes);
+                    }
+                });
+            }
+            else
+            {
+                memcpy(mapped, source, bytes);
+            }
+        }
+    }
+
+    if (job == NULL)
+    {
+        TextureInfo* textureInfo = CreateTextureFromDecodedImage(*image);
+        ReleaseDecodedImage(image);
+        return textureInfo;
     }
 
+    // 存储在复制完成后分配，此前纹理不完整，由占位纹理代替绘制
+    GLuint textureId;
+    glGenTextures(1, &textureId);
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    TextureInfo* textureInfo = RegisterTexture(textureId, job->image);
+    textureInfo->streaming = true;
+    job->texture = textureInfo;
+    _streamJobs.push_back(job);
+
     return textureInfo;
+}
 
+bool LAppTextureManager::IsTextureStreaming(GLuint textureId) const
+{
+    const TextureInfo* textureInfo = GetTextureInfoById(textureId);
+    return textureInfo != NULL && textureInfo->streaming;
 }
 
-void LAppTextureManager::ReleaseTextures()
+void LAppTextureManager::FinishTextureStreaming(GLuint textureId)
 {
-    for (Csm::csmUint32 i = 0; i < _textures.GetSize(); i++)
+    for (std::list<StreamJob*>::iterator it = _streamJobs.begin(); it != _streamJobs.end(); ++it)
     {
-        delete _textures[i];
+        StreamJob* job = *it;
+        if (job->texture == NULL || job->texture->id != textureId)
+        {
+            continue;
+        }
+
+        Csm::csmSizeInt budget = static_cast<Csm::csmSizeInt>(-1);
+        while (!StepStreamJob(job, &budget, true))
+        {
+        }
+
+        DestroyStreamJob(job);
+        _streamJobs.erase(it);
+        return;
+    }
+}
+
+GLuint LAppTextureManager::GetPlaceholderTextureId()
+{
+    if (_placeholderTextureId == 0)
+    {
+        const unsigned char transparent[4] = { 0, 0, 0, 0 };
+        glGenTextures(1, &_placeholderTextureId);
+        glBindTexture(GL_TEXTURE_2D, _placeholderTextureId);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, transparent);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glBindTexture(GL_TEXTURE_2D, 0);
     }
 
-    _textures.Clear();
+    return _placeholderTextureId;
 }
 
-void LAppTextureManager::ReleaseTexture(Csm::csmUint32 textureId)
+void LAppTextureManager::UpdateStreaming()
+{
+    Csm::csmSizeInt budget = LAppDefine::TextureStreamBytesPerFrame;
+    for (std::list<StreamJob*>::iterator it = _streamJobs.begin(); it != _streamJobs.end();)
+    {
+        StreamJob* job = *it;
+        if (StepStreamJob(job, &budget, false))
+        {
+            DestroyStreamJob(job);
+            it = _streamJobs.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+bool LAppTextureManager::StepStreamJob(StreamJob* job, Csm::csmSizeInt* budget, bool wait)
+{
+    if (job->mapped != NULL && job->copy.valid())
+    {
+        if (wait)
+        {
+            CompleteStreamCopy(job, true);
+        }
+        else if (job->copy.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            return false;
+        }
+    }
+
+    // 完成前纹理已被释放
+    if (job->texture == NULL)
+    {
+        return true;
+    }
+
+    TextureInfo* textureInfo = job->texture;
+    const DecodedImage& image = job->image;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, job->buffer);
+    glBindTexture(GL_TEXTURE_2D, textureInfo->id);
+
+    if (job->mapped != NULL)
+    {
+        // 解除映射后GL才能读取PBO
+        const bool unmapped = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+        job->mapped = NULL;
+        ReleaseDecodedImage(&job->image);
+
+        if (!unmapped)
+        {
+            // 映射期间显存内容丢失。作为被淘汰的纹理处理，下次UseTexture时重新读取
+            if (LAppDefine::DebugLogEnable)
+            {
+                LAppPal::PrintLog("[APP]texture stream lost: %s", textureInfo->fileName.c_str());
+            }
+            SetPlaceholderImage();
+            glBindTexture(GL_TEXTURE_2D, 0);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            textureInfo->streaming = false;
+            textureInfo->resident = false;
+            _residentBytes -= textureInfo->byteSize;
+            return true;
+        }
+
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    }
+
+    // 第0级按预算分行上传，每帧至少一行
+    if (job->uploadedRows < image.height && *budget > 0)
+    {
+        LAppLoadTracer::Scope trace("pbo_upload", textureInfo->fileName.c_str());
+
+        const Csm::csmSizeInt rowBytes = static_cast<Csm::csmSizeInt>(image.width) * 4;
+        Csm::csmSizeInt rows = *budget / rowBytes;
+        if (rows < 1)
+        {
+            rows = 1;
+        }
+        if (rows > static_cast<Csm::csmSizeInt>(image.height - job->uploadedRows))
+        {
+            rows = static_cast<Csm::csmSizeInt>(image.height - job->uploadedRows);
+        }
+
+        const Csm::csmSizeInt offset = static_cast<Csm::csmSizeInt>(job->uploadedRows) * rowBytes;
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, job->uploadedRows, image.width, static_cast<GLsizei>(rows),
+            GL_RGBA, GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(offset));
+
+        job->uploadedRows += static_cast<int>(rows);
+        *budget -= rows * rowBytes < *budget ? rows * rowBytes : *budget;
+        trace.SetBytes(rows * rowBytes);
+    }
+
+    if (job->uploadedRows == image.height && job->fence == NULL)
+    {
+        if (image.mipLevels > 1)
+        {
+            // 纹理缓存中的mip链紧接在第0级之后
+            Csm::csmSizeInt offset = static_cast<Csm::csmSizeInt>(image.width) * image.height * 4;
+            int width = image.width;
+            int height = image.height;
+            for (int level = 1; level < image.mipLevels; level++)
+            {
+                width = width > 1 ? width / 2 : 1;
+                height = height > 1 ? height / 2 : 1;
+                glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                    reinterpret_cast<const void*>(offset));
+                offset += static_cast<Csm::csmSizeInt>(width) * height * 4;
+            }
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.mipLevels - 1);
+        }
+        else
+        {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+
+        job->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (job->fence == NULL)
+    {
+        return false;
+    }
+
+    // 同步时命令已按顺序提交，之后的绘制一定读取到上传后的内容，不需要等待GPU
+    if (!wait)
+    {
+        const GLenum status = glClientWaitSync(job->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        {
+            return false;
+        }
+    }
+
+    textureInfo->streaming = false;
+    return true;
+}
+
+void LAppTextureManager::CompleteStreamCopy(StreamJob* job, bool copy)
+{
+    if (!job->copy.valid())
+    {
+        return;
+    }
+
+    if (!job->copyClaimed->exchange(true))
+    {
+        // 任务尚未开始。之后任务只确认领取状态，不再访问映射的地址
+        if (copy)
+        {
+            memcpy(job->mapped, job->image.pixels, GetImageBytes(job->image));
+        }
+    }
+    else
+    {
+        // 工作线程正在复制
+        job->copy.wait();
+    }
+
+    job->copy = std::future<void>();
+}
+
+void LAppTextureManager::DestroyStreamJob(StreamJob* job)
+{
+    CompleteStreamCopy(job, false);
+
+    if (job->mapped != NULL)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, job->buffer);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    if (job->fence != NULL)
+    {
+        glDeleteSync(job->fence);
+    }
+
+    glDeleteBuffers(1, &job->buffer);
+    ReleaseDecodedImage(&job->image);
+    delete job;
+}
+
+void LAppTextureManager::UploadImage(const DecodedImage& image)
 {
-    for (Csm::csmUint32 i = 0; i < _textures.GetSize(); i++)
+    if (image.mipLevels <= 1)
     {
-        if (_textures[i]->id != textureId)
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        return;
+    }
+
+    // 纹理缓存中的mip链逐级上传
+    const unsigned char* pixels = image.pixels;
+    int width = image.width;
+    int height = image.height;
+    for (int level = 0; level < image.mipLevels; level++)
+    {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        pixels += static_cast<size_t>(width) * height * 4;
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.mipLevels - 1);
+}
+
+bool LAppTextureManager::ReloadTexture(const std::string& fileName)
+{
+    // 以不同质量加载的纹理全部重新读取
+    bool reloaded = false;
+    for (int quality = TextureQuality_Full; quality <= TextureQuality_Quarter; quality++)
+    {
+        TextureInfo* textureInfo = GetTextureInfoByName(fileName, static_cast<TextureQuality>(quality));
+        if (textureInfo == NULL)
         {
             continue;
         }
-        delete _textures[i];
-        _textures.Remove(i);
-        break;
+
+        // 流式上传中的纹理先完成上传，之后再覆盖
+        if (textureInfo->streaming)
+        {
+            FinishTextureStreaming(textureInfo->id);
+        }
+
+        DecodedImage image;
+        if (!DecodePngFile(fileName, &image, textureInfo->quality))
+        {
+            return false;
+        }
+
+        // 同一个纹理ID上重新生成图像，绑定此ID的渲染器保持不变
+        glBindTexture(GL_TEXTURE_2D, textureInfo->id);
+        UploadImage(image);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        textureInfo->width = image.width;
+        textureInfo->height = image.height;
+        _totalBytes -= textureInfo->byteSize;
+        if (textureInfo->resident)
+        {
+            _residentBytes -= textureInfo->byteSize;
+        }
+        textureInfo->byteSize = GetTextureBytes(image.width, image.height);
+        textureInfo->resident = true;
+        textureInfo->restoreFailed = false;
+        _totalBytes += textureInfo->byteSize;
+        _residentBytes += textureInfo->byteSize;
+
+        ReleaseDecodedImage(&image);
+        reloaded = true;
     }
+
+    return reloaded;
 }
 
-void LAppTextureManager::ReleaseTexture(std::string fileName)
+void LAppTextureManager::DestroyTexture(TextureInfo* textureInfo)
 {
-    for (Csm::csmUint32 i = 0; i < _textures.GetSize(); i++)
+    // 流式上传中时，任务在工作线程的复制结束后由UpdateStreaming释放
+    if (textureInfo->streaming)
+    {
+        for (std::list<StreamJob*>::iterator it = _streamJobs.begin(); it != _streamJobs.end(); ++it)
+        {
+            if ((*it)->texture == textureInfo)
+            {
+                (*it)->texture = NULL;
+            }
+        }
+    }
+
+    // 重新读取中时，任务在工作线程的读取结束后由UpdateRestores释放
+    if (textureInfo->restoring)
     {
-        if (_textures[i]->fileName == fileName)
+        for (std::list<RestoreJob*>::iterator it = _restoreJobs.begin(); it != _restoreJobs.end(); ++it)
         {
-            delete _textures[i];
-            _textures.Remove(i);
-            break;
+            if ((*it)->texture == textureInfo)
+            {
+                (*it)->texture = NULL;
+            }
         }
     }
+
+    glDeleteTextures(1, &textureInfo->id);
+
+    _texturesByName.erase(MakeTextureKey(textureInfo->fileName, textureInfo->quality));
+    _texturesById.erase(textureInfo->id);
+    _lru.erase(textureInfo->lruPosition);
+    _totalBytes -= textureInfo->byteSize;
+    if (textureInfo->resident)
+    {
+        _residentBytes -= textureInfo->byteSize;
+    }
+
+    delete textureInfo;
+}
+
+void LAppTextureManager::EvictTexture(TextureInfo* textureInfo)
+{
+    // 第0级设为1x1透明图像，其余级别以0x0重新指定，释放图像数据。纹理ID保持有效，
+    // 重新上传之前绑定该ID的渲染器绘制为透明（与占位纹理相同），不会采样不完整的纹理
+    glBindTexture(GL_TEXTURE_2D, textureInfo->id);
+    SetPlaceholderImage();
+    int width = textureInfo->width;
+    int height = textureInfo->height;
+    for (int level = 1; width > 1 || height > 1; level++)
+    {
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    textureInfo->resident = false;
+    _residentBytes -= textureInfo->byteSize;
+    _evictionCount++;
 }
 
-LAppTextureManager::TextureInfo* LAppTextureManager::GetTextureInfoById(GLuint textureId) const
+void LAppTextureManager::RestoreTexture(TextureInfo* textureInfo)
+{
+    RestoreJob* job = new RestoreJob();
+    job->texture = textureInfo;
+    job->image.fileName = textureInfo->fileName;
+    job->image.width = 0;
+    job->image.height = 0;
+    job->image.quality = textureInfo->quality;
+    job->image.mipLevels = 1;
+    job->image.pixels = NULL;
+    job->image.mappedData = NULL;
+    job->decoded = false;
+    textureInfo->restoring = true;
+
+    // 源文件未变更时从纹理缓存读取，不需要重新解码。
+    // 绘制路径上不等待读取，上传在读取完成后的EndFrame中进行
+    DecodedImage* image = &job->image;
+    bool* decoded = &job->decoded;
+    const std::string fileName = textureInfo->fileName;
+    const TextureQuality quality = textureInfo->quality;
+    if (LAppDefine::ParallelSetupEnable)
+    {
+        job->decode = LAppTaskPool::GetInstance()->Submit([image, decoded, fileName, quality]()
+        {
+            *decoded = DecodePngFile(fileName, image, quality);
+        });
+    }
+    else
+    {
+        *decoded = DecodePngFile(fileName, image, quality);
+    }
+
+    _restoreJobs.push_back(job);
+}
+
+void LAppTextureManager::UpdateRestores()
+{
+    for (std::list<RestoreJob*>::iterator it = _restoreJobs.begin(); it != _restoreJobs.end();)
+    {
+        RestoreJob* job = *it;
+        if (job->decode.valid() && job->decode.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++it;
+            continue;
+        }
+
+        FinishRestoreJob(job);
+        delete job;
+        it = _restoreJobs.erase(it);
+    }
+}
+
+void LAppTextureManager::FinishRestoreJob(RestoreJob* job)
+{
+    TextureInfo* textureInfo = job->texture;
+    if (textureInfo != NULL)
+    {
+        textureInfo->restoring = false;
+
+        if (!job->decoded)
+        {
+            // 每帧重试只会重复同样的失败，保持透明图像直到ReloadTexture成功
+            if (LAppDefine::DebugLogEnable)
+            {
+                LAppPal::PrintLog("[APP]texture restore error: %s", textureInfo->fileName.c_str());
+            }
+            textureInfo->restoreFailed = true;
+        }
+        else if (!textureInfo->resident)
+        {
+            // 读取期间ReloadTexture已上传时不覆盖
+            glBindTexture(GL_TEXTURE_2D, textureInfo->id);
+            UploadImage(job->image);
+            glBindTexture(GL_TEXTURE_2D, 0);
+
+            textureInfo->width = job->image.width;
+            textureInfo->height = job->image.height;
+            _totalBytes -= textureInfo->byteSize;
+            textureInfo->byteSize = GetTextureBytes(job->image.width, job->image.height);
+            textureInfo->resident = true;
+            _totalBytes += textureInfo->byteSize;
+            _residentBytes += textureInfo->byteSize;
+            _restoreCount++;
+        }
+    }
+
+    ReleaseDecodedImage(&job->image);
+}
+
+void LAppTextureManager::TouchTexture(TextureInfo* textureInfo)
+{
+    _lru.splice(_lru.begin(), _lru, textureInfo->lruPosition);
+    textureInfo->lastUsedFrame = _frame;
+}
+
+void LAppTextureManager::UseTexture(GLuint textureId)
+{
+    TextureInfo* textureInfo = GetTextureInfoById(textureId);
+    if (textureInfo == NULL)
+    {
+        return;
+    }
+
+    // 读取中或已失败的纹理不再开始读取
+    if (!textureInfo->resident && !textureInfo->restoring && !textureInfo->restoreFailed)
+    {
+        RestoreTexture(textureInfo);
+    }
+    TouchTexture(textureInfo);
+}
+
+void LAppTextureManager::EndFrame()
+{
+    UpdateStreaming();
+    UpdateRestores();
+
+    if (LAppDefine::TextureBudgetBytes > 0)
+    {
+        // 从最久未使用的纹理开始淘汰，遇到本帧使用的纹理时停止（之后的都在本帧使用过）
+        for (std::list<TextureInfo*>::reverse_iterator it = _lru.rbegin();
+            it != _lru.rend() && _residentBytes > LAppDefine::TextureBudgetBytes; ++it)
+        {
+            TextureInfo* textureInfo = *it;
+            if (textureInfo->lastUsedFrame == _frame)
+            {
+                break;
+            }
+
+            // 流式上传中的纹理不淘汰
+            if (textureInfo->resident && !textureInfo->streaming)
+            {
+                EvictTexture(textureInfo);
+            }
+        }
+    }
+
+    _frame++;
+}
+
+void LAppTextureManager::ReleaseTextures()
 {
-    for (Csm::csmUint32 i = 0; i < _textures.GetSize(); i++)
+    for (std::list<StreamJob*>::iterator it = _streamJobs.begin(); it != _streamJobs.end(); ++it)
+    {
+        DestroyStreamJob(*it);
+    }
+    _streamJobs.clear();
+
+    for (std::list<RestoreJob*>::iterator it = _restoreJobs.begin(); it != _restoreJobs.end(); ++it)
     {
-        if (_textures[i]->id == textureId)
+        if ((*it)->decode.valid())
         {
-            return _textures[i];
+            (*it)->decode.wait();
         }
+        ReleaseDecodedImage(&(*it)->image);
+        delete *it;
+    }
+    _restoreJobs.clear();
+
+    if (_placeholderTextureId != 0)
+    {
+        glDeleteTextures(1, &_placeholderTextureId);
+        _placeholderTextureId = 0;
+    }
+
+    for (std::unordered_map<GLuint, TextureInfo*>::iterator it = _texturesById.begin(); it != _texturesById.end(); ++it)
+    {
+        glDeleteTextures(1, &it->second->id);
+        delete it->second;
+    }
+
+    _texturesByName.clear();
+    _texturesById.clear();
+    _lru.clear();
+    _totalBytes = 0;
+    _residentBytes = 0;
+}
+
+void LAppTextureManager::ReleaseTexture(Csm::csmUint32 textureId)
+{
+    TextureInfo* textureInfo = GetTextureInfoById(textureId);
+    if (textureInfo == NULL)
+    {
+        return;
+    }
+
+    // 其他模型仍在使用时只减少引用计数
+    textureInfo->refCount--;
+    if (textureInfo->refCount == 0)
+    {
+        DestroyTexture(textureInfo);
+    }
+}
+
+void LAppTextureManager::ReleaseTexture(std::string fileName, TextureQuality quality)
+{
+    TextureInfo* textureInfo = GetTextureInfoByName(fileName, quality);
+    if (textureInfo == NULL)
+    {
+        return;
     }
 
-    return NULL;
+    textureInfo->refCount--;
+    if (textureInfo->refCount == 0)
+    {
+        DestroyTexture(textureInfo);
+    }
+}
+
+LAppTextureManager::TextureInfo* LAppTextureManager::GetTextureInfoById(GLuint textureId) const
+{
+    std::unordered_map<GLuint, TextureInfo*>::const_iterator it = _texturesById.find(textureId);
+    return it != _texturesById.end() ? it->second : NULL;
+}
+
+LAppTextureManager::TextureInfo* LAppTextureManager::GetTextureInfoByName(const std::string& fileName, TextureQuality quality) const
+{
+    std::unordered_map<std::string, TextureInfo*>::const_iterator it = _texturesByName.find(MakeTextureKey(fileName, quality));
+    return it != _texturesByName.end() ? it->second : NULL;
+}
+
+Csm::csmUint32 LAppTextureManager::GetTextureCount() const
+{
+    return static_cast<Csm::csmUint32>(_texturesById.size());
+}
+
+Csm::csmSizeInt LAppTextureManager::GetTotalBytes() const
+{
+    return _totalBytes;
+}
+
+Csm::csmSizeInt LAppTextureManager::GetResidentBytes() const
+{
+    return _residentBytes;
+}
+
+Csm::csmUint32 LAppTextureManager::GetEvictionCount() const
+{
+    return _evictionCount;
+}
+
+Csm::csmUint32 LAppTextureManager::GetRestoreCount() const
+{
+    return _restoreCount;
 }
@@ -7,7 +7,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <future>
+#include <list>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <Type/csmVector.hpp>
@@ -19,7 +25,21 @@
  * 
  这段代码定义了一个名为LAppTextureManager的纹理管理类。这个类主要负责图像的读取和管理。以下是代码的详细解释：
 
-struct TextureInfo：定义了一个包含纹理ID、宽度、高度和文件名的图像信息结构体。
+enum TextureQuality：纹理的读取质量。读取时按盒式滤波缩小为1/2或1/4（UV为归一化坐标，模型不需要修改）。同一图像的不同质量作为不同的纹理管理。
+
+struct TextureInfo：定义了一个包含纹理ID、宽度、高度、文件名、引用计数和显存字节数的图像信息结构体。
+
+纹理按文件名和纹理ID建立哈希索引，查找为O(1)。Create系列函数每次返回纹理时引用计数加1（包括已加载的纹理），
+ReleaseTexture减1，最后一个使用者释放时才删除OpenGL纹理。多个模型共享同一图像时，释放其中一个模型不影响其他模型。
+
+显存预算（TextureBudgetBytes）：绘制时通过UseTexture记录纹理的使用，每帧结束时EndFrame在常驻字节数超出预算时，
+按最久未使用的顺序淘汰本帧未绘制的纹理。淘汰只释放纹理的图像数据，纹理ID保持不变，
+再次UseTexture时在工作线程上从纹理缓存或源文件重新读取，之后的EndFrame上传到同一个ID，绑定该ID的渲染器不需要任何处理。
+被淘汰的纹理在重新上传之前保持与占位纹理相同的1x1透明图像。重新读取失败的纹理不再重试，直到ReloadTexture成功。
+
+流式上传（TextureStreamingEnable）：CreateTextureStreamed立即返回纹理ID，像素由工作线程复制到映射的像素缓冲区对象（PBO），
+之后每帧在EndFrame中按TextureStreamBytesPerFrame分批从PBO执行glTexSubImage2D，全部上传后插入围栏，GPU完成时结束。
+上传完成之前绘制应绑定GetPlaceholderTextureId()的占位纹理。流式上传中的纹理不会被淘汰。
 
 LAppTextureManager()：类的构造函数。
 
@@ -27,22 +47,60 @@ LAppTextureManager()：类的构造函数。
 
 Premultiply()：预乘处理函数，用于处理图像的Red、Green、Blue和Alpha值，返回预乘处理后的颜色值。
 
-CreateTextureFromPngFile()：从PNG文件创建纹理，传入文件路径名，返回图像信息结构体。如果读取失败，返回NULL。
+CreateTextureFromPngFile()：从PNG文件创建纹理，传入文件路径名，返回图像信息结构体（引用计数加1）。如果读取失败，返回NULL。
+
+DecodePngFile()：读取并解码PNG文件（不调用OpenGL，可以在工作线程上调用）。TextureCacheEnable为true时先从LAppTextureCache读取，未命中时解码后写入缓存。
+
+DecodePngFiles()：在LAppTaskPool上并行读取并解码多个PNG文件。
+
+GetPngDecodedBytes()：只读取PNG的IHDR，返回按质量解码后的像素字节数（解码前估算内存用）。
+
+CreateTexturesFromPngFiles()：批量创建纹理。未加载的图像并行解码后，在调用线程上一次上传。
+
+CreateTextureFromDecodedImage()：将解码后的图像上传为纹理（需在OpenGL上下文所在的线程上调用）。
+
+CreateTextureStreamed()：通过PBO分帧上传解码后的图像。不支持PBO或同步对象时与CreateTextureFromDecodedImage相同。
+
+IsTextureStreaming()/FinishTextureStreaming()：判断纹理是否正在流式上传/立即完成流式上传。
 
-ReleaseTextures()：释放数组中的所有图像。
+GetPlaceholderTextureId()：获取流式上传完成前代替绑定的1x1透明纹理。
 
-ReleaseTexture(Csm::csmUint32 textureId)：释放指定纹理ID的图像。
+ReleaseDecodedImage()：释放解码后的图像（从纹理缓存读取时解除映射）。
 
-ReleaseTexture(std::string fileName)：释放指定名称的图像。
+ReleaseTextures()：不论引用计数，释放所有图像。
+
+ReleaseTexture(Csm::csmUint32 textureId)：将指定纹理ID的图像的引用计数减1，为0时释放。
+
+ReleaseTexture(std::string fileName)：将指定名称的图像的引用计数减1，为0时释放。
 
 GetTextureInfoById(GLuint textureId) const：根据纹理ID获取纹理信息。如果纹理存在，则返回TextureInfo结构体。
 
-_textures：私有成员变量，用于存储纹理信息结构体的数组
+GetTextureInfoByName()：根据文件名获取纹理信息（不改变引用计数）。
+
+GetTextureCount()/GetTotalBytes()：获取已加载的纹理数和显存字节数的合计。
+
+UseTexture()/EndFrame()：记录纹理的使用/在帧结束时推进流式上传并按预算淘汰纹理。
+
+GetResidentBytes()/GetEvictionCount()/GetRestoreCount()：获取常驻的字节数、淘汰和重新上传的次数。
+
+ReloadTexture(std::string fileName)：重新读取已加载的图像（所有质量）并上传到同一个纹理ID（热重载用）。
+
+_texturesByName/_texturesById：私有成员变量，按文件名和纹理ID索引纹理信息结构体的哈希表
  */
 class LAppTextureManager
 {
 public:
 
+    /**
+    * @brief 纹理的读取质量
+    */
+    enum TextureQuality
+    {
+        TextureQuality_Full = 0,    ///< 原始分辨率
+        TextureQuality_Half = 1,    ///< 宽高各1/2
+        TextureQuality_Quarter = 2, ///< 宽高各1/4
+    };
+
     /**
     * @brief 图像信息结构体
     */
@@ -52,6 +110,29 @@ public:
         int width;              ///< 宽度
         int height;             ///< 高度
         std::string fileName;   ///< 文件名
+        TextureQuality quality; ///< 读取质量
+        Csm::csmUint32 refCount; ///< 引用计数
+        Csm::csmSizeInt byteSize; ///< 显存字节数（包括mip链）
+        bool resident;          ///< 图像数据在显存中时为true（被淘汰时为false）
+        Csm::csmUint32 lastUsedFrame; ///< 最后一次使用的帧
+        std::list<TextureInfo*>::iterator lruPosition; ///< 在LRU列表中的位置（内部使用）
+        bool streaming;         ///< 正在通过PBO流式上传时为true（完成前不能用于绘制）
+        bool restoring;         ///< 被淘汰后正在工作线程上重新读取时为true
+        bool restoreFailed;     ///< 重新读取失败时为true（不再重试，ReloadTexture成功时清除）
+    };
+
+    /**
+    * @brief 解码后的图像
+    */
+    struct DecodedImage
+    {
+        std::string fileName;   ///< 文件名
+        int width;              ///< 宽度
+        int height;             ///< 高度
+        TextureQuality quality; ///< 读取质量（width、height为缩小后的尺寸）
+        int mipLevels;          ///< pixels中连续存放的mip级数（1时上传后由glGenerateMipmap生成）
+        unsigned char* pixels;  ///< RGBA像素（PREMULTIPLIED_ALPHA_ENABLE时已预乘）
+        Csm::csmByte* mappedData; ///< 从纹理缓存读取时为缓存文件的映射视图（pixels指向其内部），否则为NULL
     };
 
     /**
@@ -76,7 +157,7 @@ public:
     *
     * @return 预乘处理后的颜色值
     */
-    inline unsigned int Premultiply(unsigned char red, unsigned char green, unsigned char blue, unsigned char alpha)
+    static inline unsigned int Premultiply(unsigned char red, unsigned char green, unsigned char blue, unsigned char alpha)
     {
         return static_cast<unsigned>(\
             (red * (alpha + 1) >> 8) | \
@@ -89,22 +170,126 @@ public:
     /**
     * @brief 读取图像
     *
+    * 已加载时直接返回。无论哪种情况，引用计数都加1，使用结束后需通过ReleaseTexture释放。
+    *
     * @param[in] fileName  读取的图像文件路径名
+    * @param[in] quality   读取质量
     * @return 图像信息。读取失败时返回NULL
     */
-    TextureInfo* CreateTextureFromPngFile(std::string fileName);
+    TextureInfo* CreateTextureFromPngFile(std::string fileName, TextureQuality quality = TextureQuality_Full);
+
+    /**
+    * @brief 读取并解码PNG文件
+    *
+    * 不调用OpenGL，可以在工作线程上调用。
+    * TextureCacheEnable为true时，源文件未变更则直接映射纹理缓存中的像素，跳过解码。
+    *
+    * @param[in]  fileName  读取的图像文件路径名
+    * @param[out] outImage  解码后的图像。使用后需通过ReleaseDecodedImage释放
+    * @param[in]  quality   读取质量。低于原始分辨率时解码后缩小
+    * @return 成功时返回true
+    */
+    static bool DecodePngFile(const std::string& fileName, DecodedImage* outImage, TextureQuality quality = TextureQuality_Full);
+
+    /**
+    * @brief 并行读取并解码多个PNG文件
+    *
+    * 每个文件作为一个任务在LAppTaskPool上解码（ParallelSetupEnable为false时按顺序解码）。
+    * 不调用OpenGL，可以在工作线程上调用。
+    *
+    * @param[in]  fileNames  读取的图像文件路径名
+    * @param[out] outImages  解码后的图像（与fileNames的顺序相同，失败时pixels为NULL）。使用后需通过ReleaseDecodedImage释放
+    * @param[in]  quality    读取质量
+    */
+    static void DecodePngFiles(const std::vector<std::string>& fileNames, std::vector<DecodedImage>& outImages, TextureQuality quality = TextureQuality_Full);
+
+    /**
+    * @brief 获取PNG文件解码后的像素字节数
+    *
+    * 只读取文件开头的IHDR中的宽度和高度，不进行解码。可以在工作线程上调用。
+    *
+    * @param[in]  fileName  图像文件路径名
+    * @param[in]  quality   读取质量
+    * @param[out] outBytes  按质量缩小后的RGBA像素的字节数
+    * @return 读取成功时返回true
+    */
+    static bool GetPngDecodedBytes(const std::string& fileName, TextureQuality quality, Csm::csmSizeInt* outBytes);
+
+    /**
+    * @brief 批量从PNG文件创建纹理
+    *
+    * 已加载的图像直接返回，其余的图像并行解码后一次上传。需在OpenGL上下文所在的线程上调用。
+    * 返回的每个纹理的引用计数加1。
+    *
+    * @param[in]  fileNames    读取的图像文件路径名
+    * @param[out] outTextures  图像信息（与fileNames的顺序相同，读取失败时为NULL）
+    * @param[in]  quality      读取质量
+    */
+    void CreateTexturesFromPngFiles(const std::vector<std::string>& fileNames, std::vector<TextureInfo*>& outTextures, TextureQuality quality = TextureQuality_Full);
+
+    /**
+    * @brief 释放解码后的图像
+    *
+    * @param[in] image  DecodePngFile生成的图像
+    */
+    static void ReleaseDecodedImage(DecodedImage* image);
+
+    /**
+    * @brief 将解码后的图像上传为纹理
+    *
+    * 需在OpenGL上下文所在的线程上调用。同名的纹理已存在时直接返回。引用计数加1。
+    *
+    * @param[in] image  解码后的图像
+    * @return 图像信息
+    */
+    TextureInfo* CreateTextureFromDecodedImage(const DecodedImage& image);
+
+    /**
+    * @brief 通过像素缓冲区对象分帧上传解码后的图像
+    *
+    * 纹理ID立即返回，像素由工作线程复制到映射的PBO，之后每帧在EndFrame中上传一部分行。
+    * 上传完成（围栏通过）之前IsTextureStreaming返回true，绘制时应绑定GetPlaceholderTextureId()。
+    * TextureStreamingEnable为false或不支持PBO、同步对象时与CreateTextureFromDecodedImage相同。
+    * 需在OpenGL上下文所在的线程上调用。同名的纹理已存在时直接返回。引用计数加1。
+    *
+    * @param[in,out] image  解码后的图像。像素由纹理管理器释放，调用后pixels为NULL
+    * @return 图像信息
+    */
+    TextureInfo* CreateTextureStreamed(DecodedImage* image);
+
+    /**
+    * @brief 判断纹理是否正在流式上传
+    *
+    * @param[in] textureId  纹理ID
+    * @return 上传尚未完成时返回true
+    */
+    bool IsTextureStreaming(GLuint textureId) const;
+
+    /**
+    * @brief 立即完成纹理的流式上传
+    *         等待工作线程的复制，一次上传剩余的行。同步加载时使用。
+    *
+    * @param[in] textureId  纹理ID
+    */
+    void FinishTextureStreaming(GLuint textureId);
+
+    /**
+    * @brief 获取流式上传完成前代替绑定的占位纹理（1x1透明）
+    *         第一次调用时生成。不计入纹理数和显存字节数。
+    */
+    GLuint GetPlaceholderTextureId();
 
     /**
     * @brief 释放图像
     *
-    * 释放数组中的所有图像
+    * 不论引用计数，释放所有图像
     */
     void ReleaseTextures();
 
     /**
      * @brief 释放图像
      *
-     * 释放指定纹理ID的图像
+     * 将指定纹理ID的图像的引用计数减1，没有其他使用者时释放
      * @param[in] textureId  要释放的纹理ID
      **/
     void ReleaseTexture(Csm::csmUint32 textureId);
@@ -112,10 +297,11 @@ public:
     /**
     * @brief 释放图像
     *
-    * 释放指定名称的图像
+    * 将指定名称的图像的引用计数减1，没有其他使用者时释放
     * @param[in] fileName  要释放的图像文件路径名
+    * @param[in] quality   读取质量
     **/
-    void ReleaseTexture(std::string fileName);
+    void ReleaseTexture(std::string fileName, TextureQuality quality = TextureQuality_Full);
 
     /**
      * @brief 根据纹理ID获取纹理信息
@@ -125,6 +311,191 @@ public:
      */
     TextureInfo* GetTextureInfoById(GLuint textureId) const;
 
+    /**
+     * @brief 根据文件名获取纹理信息
+     *         不改变引用计数。
+     *
+     * @param   fileName[in]        图像文件路径名
+     * @param   quality[in]         读取质量
+     * @return  如果纹理存在，则返回TextureInfo
+     */
+    TextureInfo* GetTextureInfoByName(const std::string& fileName, TextureQuality quality = TextureQuality_Full) const;
+
+    /**
+     * @brief 获取已加载的纹理数
+     */
+    Csm::csmUint32 GetTextureCount() const;
+
+    /**
+     * @brief 获取已加载的纹理的显存字节数的合计
+     */
+    Csm::csmSizeInt GetTotalBytes() const;
+
+    /**
+     * @brief 获取常驻显存的纹理的字节数的合计
+     */
+    Csm::csmSizeInt GetResidentBytes() const;
+
+    /**
+     * @brief 获取淘汰的次数
+     */
+    Csm::csmUint32 GetEvictionCount() const;
+
+    /**
+     * @brief 获取被淘汰后重新上传的次数
+     */
+    Csm::csmUint32 GetRestoreCount() const;
+
+    /**
+     * @brief 记录纹理在本帧被使用
+     *         纹理已被淘汰时，在工作线程上从纹理缓存或源文件重新读取，之后的EndFrame上传到同一个纹理ID。
+     *         重新上传之前该纹理为1x1透明图像（与占位纹理相同）。
+     *
+     * @param[in] textureId  纹理ID
+     */
+    void UseTexture(GLuint textureId);
+
+    /**
+     * @brief 结束一帧
+     *         推进流式上传（每帧最多TextureStreamBytesPerFrame字节），上传重新读取完成的被淘汰纹理，
+     *         常驻字节数超出TextureBudgetBytes时，按最久未使用的顺序淘汰本帧未使用的纹理。
+     */
+    void EndFrame();
+
+    /**
+     * @brief 重新读取图像并上传到同一个纹理ID
+     *         以不同质量加载的纹理全部重新读取。绑定该纹理的模型不需要重新绑定。
+     *
+     * @param[in] fileName  图像文件路径名
+     * @return  已加载该图像且重新读取成功时返回true
+     */
+    bool ReloadTexture(const std::string& fileName);
+
 private:
-    Csm::csmVector<TextureInfo*> _textures;
+    /**
+     * @brief 流式上传的任务
+     */
+    struct StreamJob
+    {
+        TextureInfo* texture;       ///< 上传目标（完成前纹理被释放时为NULL）
+        DecodedImage image;         ///< 源图像（复制到PBO后释放）
+        GLuint buffer;              ///< 像素缓冲区对象
+        void* mapped;               ///< PBO的映射地址（解除映射后为NULL）
+        std::future<void> copy;     ///< 工作线程上向PBO的复制
+        std::shared_ptr<std::atomic<bool> > copyClaimed;    ///< 复制已被工作线程或主线程领取（先领取的一方执行复制）
+        int uploadedRows;           ///< 第0级已上传的行数
+        GLsync fence;               ///< 全部上传后插入的围栏
+    };
+
+    /**
+     * @brief 被淘汰纹理的重新读取任务
+     */
+    struct RestoreJob
+    {
+        TextureInfo* texture;       ///< 恢复目标（完成前纹理被释放时为NULL）
+        DecodedImage image;         ///< 重新读取的图像
+        bool decoded;               ///< 重新读取成功时为true
+        std::future<void> decode;   ///< 工作线程上的重新读取
+    };
+
+    /**
+     * @brief 生成纹理信息并加入索引
+     *
+     * @param[in] textureId  纹理ID
+     * @param[in] image      纹理的图像
+     * @return 图像信息（引用计数为1）
+     */
+    TextureInfo* RegisterTexture(GLuint textureId, const DecodedImage& image);
+
+    /**
+     * @brief 推进所有流式上传
+     */
+    void UpdateStreaming();
+
+    /**
+     * @brief 上传重新读取完成的被淘汰纹理
+     */
+    void UpdateRestores();
+
+    /**
+     * @brief 结束一个重新读取任务（上传图像，失败时标记纹理不再重试）并释放图像
+     *
+     * @param[in] job  重新读取任务
+     */
+    void FinishRestoreJob(RestoreJob* job);
+
+    /**
+     * @brief 推进一个流式上传
+     *
+     * @param[in]     job     流式上传的任务
+     * @param[in,out] budget  本帧剩余的上传字节数
+     * @param[in]     wait    为true时等待复制，不等待围栏
+     * @return 任务结束时返回true
+     */
+    bool StepStreamJob(StreamJob* job, Csm::csmSizeInt* budget, bool wait);
+
+    /**
+     * @brief 结束向PBO的复制
+     *         复制任务尚未开始时在调用线程上复制（不等待排在队列中的其他任务），已开始时等待其结束。
+     *
+     * @param[in] job   流式上传的任务
+     * @param[in] copy  为false时不复制（释放任务时）
+     */
+    void CompleteStreamCopy(StreamJob* job, bool copy);
+
+    /**
+     * @brief 释放流式上传的任务使用的PBO、围栏和图像
+     *
+     * @param[in] job  流式上传的任务
+     */
+    void DestroyStreamJob(StreamJob* job);
+
+    /**
+     * @brief 将图像上传到当前绑定的纹理
+     *         图像包含mip链时逐级上传，否则由glGenerateMipmap生成。
+     *
+     * @param[in] image  解码后的图像
+     */
+    static void UploadImage(const DecodedImage& image);
+
+    /**
+     * @brief 删除OpenGL纹理并从索引中移除
+     *
+     * @param[in] textureInfo  要删除的纹理
+     */
+    void DestroyTexture(TextureInfo* textureInfo);
+
+    /**
+     * @brief 释放纹理的图像数据（保留纹理ID）
+     *         第0级替换为1x1透明图像，重新上传前绑定该ID的渲染器与绑定占位纹理时相同。
+     *
+     * @param[in] textureInfo  要淘汰的纹理
+     */
+    void EvictTexture(TextureInfo* textureInfo);
+
+    /**
+     * @brief 开始在工作线程上重新读取被淘汰的纹理（由UpdateRestores上传到同一个纹理ID）
+     *
+     * @param[in] textureInfo  要恢复的纹理
+     */
+    void RestoreTexture(TextureInfo* textureInfo);
+
+    /**
+     * @brief 将纹理移到LRU列表的最前面并记录使用的帧
+     *
+     * @param[in] textureInfo  使用的纹理
+     */
+    void TouchTexture(TextureInfo* textureInfo);
+
+    std::unordered_map<std::string, TextureInfo*> _texturesByName;  ///< 文件名（和质量）到纹理的索引
+    std::unordered_map<GLuint, TextureInfo*> _texturesById;         ///< 纹理ID到纹理的索引
+    Csm::csmSizeInt _totalBytes;                                    ///< 已加载的纹理的显存字节数的合计
+    std::list<TextureInfo*> _lru;                                   ///< 按使用顺序排列的纹理（最前面为最近使用）
+    Csm::csmSizeInt _residentBytes;                                 ///< 常驻显存的纹理的字节数的合计
+    Csm::csmUint32 _frame;                                          ///< 当前帧的编号
+    Csm::csmUint32 _evictionCount;                                  ///< 淘汰的次数
+    Csm::csmUint32 _restoreCount;                                   ///< 重新上传的次数
+    std::list<StreamJob*> _streamJobs;                              ///< 进行中的流式上传
+    std::list<RestoreJob*> _restoreJobs;                            ///< 进行中的被淘汰纹理的重新读取
+    GLuint _placeholderTextureId;                                   ///< 占位纹理（未生成时为0）
 };
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "LAppView.hpp"
 #include <math.h>
 #include <string>
+#include <vector>
 #include "LAppPal.hpp"
 #include "LAppDelegate.hpp"
 #include "LAppLive2DManager.hpp"
@@ -15,13 +16,18 @@
 #include "LAppDefine.hpp"
 #include "TouchManager.hpp"
 #include "LAppSprite.hpp"
+#include "LAppSpriteAtlas.hpp"
+#include "LAppSpriteBatch.hpp"
 #include "LAppModel.hpp"
+#include "LAppWindowState.hpp"
 
 using namespace std;
 using namespace LAppDefine;
 
 LAppView::LAppView():
     _programId(0),
+    _uiAtlas(NULL),
+    _uiBatch(NULL),
     _back(NULL),
     //_gear(NULL),
     //_power(NULL),
@@ -36,9 +42,6 @@ LAppView::LAppView():
     // タッチ関係のイベント管理
     _touchManager = new TouchManager();
 
-    // デバイス座標からスクリーン座標に変換するための
-    _deviceToScreen = new CubismMatrix44();
-
     // 画面の表示の拡大縮小や移動の変換を行う行列
     _viewMatrix = new CubismViewMatrix();
 }
@@ -48,17 +51,21 @@ LAppView::~LAppView()
     _renderBuffer.DestroyOffscreenFrame();
     delete _renderSprite;
     delete _viewMatrix;
-    delete _deviceToScreen;
     delete _touchManager;
+
+    delete _uiBatch;
     delete _back;
     //delete _gear;
     //delete _power;
+    delete _uiAtlas;
 }
 
 void LAppView::Initialize()
 {
-    int width, height;
-    glfwGetWindowSize(LAppDelegate::GetInstance()->GetWindow(), &width, &height);
+    // デバイス座標からスクリーン座標への行列はLAppWindowStateがサイズ変更時に計算する
+    LAppWindowState* windowState = LAppWindowState::GetInstance();
+    int width = windowState->GetWidth();
+    int height = windowState->GetHeight();
 
     if(width==0 || height==0)
     {
@@ -75,19 +82,6 @@ void LAppView::Initialize()
     _viewMatrix->SetScreenRect(left, right, bottom, top); // デバイスに対応する画面の範囲。 Xの左端, Xの右端, Yの下端, Yの上端
     _viewMatrix->Scale(ViewScale, ViewScale);
 
-    _deviceToScreen->LoadIdentity(); // サイズが変わった際などリセット必須
-    if (width > height)
-    {
-        float screenW = fabsf(right - left);
-        _deviceToScreen->ScaleRelative(screenW / width, -screenW / width);
-    }
-    else
-    {
-        float screenH = fabsf(top - bottom);
-        _deviceToScreen->ScaleRelative(screenH / height, -screenH / height);
-    }
-    _deviceToScreen->TranslateRelative(-width * 0.5f, -height * 0.5f);
-
     // 表示範囲の設定
     _viewMatrix->SetMaxScale(ViewMaxScale); // 限界拡大率
     _viewMatrix->SetMinScale(ViewMinScale); // 限界縮小率
@@ -103,9 +97,11 @@ void LAppView::Initialize()
 
 void LAppView::Render()
 {
-    _back->Render();
-    //_gear->Render();
-    //_power->Render();
+    // UI层的精灵都引用同一张图集，一次绘制调用
+    if (_uiBatch != NULL)
+    {
+        _uiBatch->Render();
+    }
 
     LAppLive2DManager* Live2DManager = LAppLive2DManager::GetInstance();
 
@@ -143,42 +139,64 @@ void LAppView::InitializeSprite()
 {
     _programId = LAppDelegate::GetInstance()->CreateShader();
 
-    int width, height;
-    glfwGetWindowSize(LAppDelegate::GetInstance()->GetWindow(), &width, &height);
+    int width = LAppWindowState::GetInstance()->GetWidth();
+    int height = LAppWindowState::GetInstance()->GetHeight();
 
-    LAppTextureManager* textureManager = LAppDelegate::GetInstance()->GetTextureManager();
     const string resourcesPath = ResourcesPath;
 
-    string imageName = BackImageName;
-    LAppTextureManager::TextureInfo* backgroundTexture = textureManager->CreateTextureFromPngFile(resourcesPath + imageName);
+    // UI图像打包为一张图集。启用齿轮、电源按钮时也加入此列表
+    vector<string> uiImages;
+    uiImages.push_back(resourcesPath + BackImageName);
+    //uiImages.push_back(resourcesPath + GearImageName);
+    //uiImages.push_back(resourcesPath + PowerImageName);
+
+    _uiAtlas = new LAppSpriteAtlas();
+    _uiAtlas->Build(uiImages);
+
+    float x = 0.0f;
+    float y = 0.0f;
+    float fWidth = 0.0f;
+    float fHeight = 0.0f;
 
-    float x = width * 0.5f;
-    float y = height * 0.5f;
-    float fWidth = static_cast<float>(backgroundTexture->width * 2.0f);
-    float fHeight = static_cast<float>(height * 1.00f); //0.95f
-    _back = new LAppSprite(x, y, fWidth, fHeight, backgroundTexture->id, _programId);
-    // LAppView::ResizeSprite()還有一份
+    const LAppSpriteAtlas::Region* backRegion = _uiAtlas->GetRegion(resourcesPath + BackImageName);
+    if (backRegion != NULL)
+    {
+        x = width * 0.5f;
+        y = height * 0.5f;
+        fWidth = static_cast<float>(backRegion->width * 2.0f);
+        fHeight = static_cast<float>(height * 1.00f); //0.95f
+        _back = new LAppSprite(x, y, fWidth, fHeight, _uiAtlas->GetTextureId(), _programId);
+        _back->SetUvVertex(backRegion->uvVertex);
+        // LAppView::ResizeSprite()還有一份
+    }
 
     /*
-    imageName = GearImageName;
-    LAppTextureManager::TextureInfo* gearTexture = textureManager->CreateTextureFromPngFile(resourcesPath + imageName);
-
-    x = static_cast<float>(width - gearTexture->width * 0.5f);
-    y = static_cast<float>(height - gearTexture->height * 0.5f);
-    fWidth = static_cast<float>(gearTexture->width);
-    fHeight = static_cast<float>(gearTexture->height);
-    _gear = new LAppSprite(x, y, fWidth, fHeight, gearTexture->id, _programId);
-
-    imageName = PowerImageName;
-    LAppTextureManager::TextureInfo* powerTexture = textureManager->CreateTextureFromPngFile(resourcesPath + imageName);
-
-    x = static_cast<float>(width - powerTexture->width * 0.5f);
-    y = static_cast<float>(powerTexture->height * 0.5f);
-    fWidth = static_cast<float>(powerTexture->width);
-    fHeight = static_cast<float>(powerTexture->height);
-    _power = new LAppSprite(x, y, fWidth, fHeight, powerTexture->id, _programId);
+    const LAppSpriteAtlas::Region* gearRegion = _uiAtlas->GetRegion(resourcesPath + GearImageName);
+
+    x = static_cast<float>(width - gearRegion->width * 0.5f);
+    y = static_cast<float>(height - gearRegion->height * 0.5f);
+    fWidth = static_cast<float>(gearRegion->width);
+    fHeight = static_cast<float>(gearRegion->height);
+    _gear = new LAppSprite(x, y, fWidth, fHeight, _uiAtlas->GetTextureId(), _programId);
+    _gear->SetUvVertex(gearRegion->uvVertex);
+
+    const LAppSpriteAtlas::Region* powerRegion = _uiAtlas->GetRegion(resourcesPath + PowerImageName);
+
+    x = static_cast<float>(width - powerRegion->width * 0.5f);
+    y = static_cast<float>(powerRegion->height * 0.5f);
+    fWidth = static_cast<float>(powerRegion->width);
+    fHeight = static_cast<float>(powerRegion->height);
+    _power = new LAppSprite(x, y, fWidth, fHeight, _uiAtlas->GetTextureId(), _programId);
+    _power->SetUvVertex(powerRegion->uvVertex);
     */
 
+    // 顶点在矩形或窗口尺寸变化时才重新生成
+    _uiBatch = new LAppSpriteBatch(_programId);
+    _uiBatch->SetViewportSize(width, height);
+    _uiBatch->AddSprite(_back);
+    //_uiBatch->AddSprite(_gear);
+    //_uiBatch->AddSprite(_power);
+
     // 画面全体を覆うサイズ
     x = width * 0.5f;
     y = height * 0.5f;
@@ -217,8 +235,8 @@ void LAppView::OnTouchesEnded(float px, float py) const
     live2DManager->OnDrag(0.0f, 0.0f);
     {
         // 单次点击
-        float x = _deviceToScreen->TransformX(_touchManager->GetX()); // 获取转换为逻辑坐标的坐标。
-        float y = _deviceToScreen->TransformY(_touchManager->GetY()); // 获取转换为逻辑坐标的坐标。
+        float x = LAppWindowState::GetInstance()->GetDeviceToScreen()->TransformX(_touchManager->GetX()); // 获取转换为逻辑坐标的坐标。
+        float y = LAppWindowState::GetInstance()->GetDeviceToScreen()->TransformY(_touchManager->GetY()); // 获取转换为逻辑坐标的坐标。
         if (DebugTouchLogEnable)
         {
             LAppPal::PrintLog("[APP]touchesEnded x:%.2f y:%.2f", x, y);
@@ -243,24 +261,24 @@ void LAppView::OnTouchesEnded(float px, float py) const
 
 float LAppView::TransformViewX(float deviceX) const
 {
-    float screenX = _deviceToScreen->TransformX(deviceX); // 論理座標変換した座標を取得。
+    float screenX = LAppWindowState::GetInstance()->GetDeviceToScreen()->TransformX(deviceX); // 論理座標変換した座標を取得。
     return _viewMatrix->InvertTransformX(screenX); // 拡大、縮小、移動後の値。
 }
 
 float LAppView::TransformViewY(float deviceY) const
 {
-    float screenY = _deviceToScreen->TransformY(deviceY); // 論理座標変換した座標を取得。
+    float screenY = LAppWindowState::GetInstance()->GetDeviceToScreen()->TransformY(deviceY); // 論理座標変換した座標を取得。
     return _viewMatrix->InvertTransformY(screenY); // 拡大、縮小、移動後の値。
 }
 
 float LAppView::TransformScreenX(float deviceX) const
 {
-    return _deviceToScreen->TransformX(deviceX);
+    return LAppWindowState::GetInstance()->GetDeviceToScreen()->TransformX(deviceX);
 }
 
 float LAppView::TransformScreenY(float deviceY) const
 {
-    return _deviceToScreen->TransformY(deviceY);
+    return LAppWindowState::GetInstance()->GetDeviceToScreen()->TransformY(deviceY);
 }
 
 void LAppView::PreModelDraw(LAppModel& refModel)
@@ -276,8 +294,8 @@ void LAppView::PreModelDraw(LAppModel& refModel)
 
         if (!useTarget->IsValid())
         {// 描画ターゲット内部未作成の場合はここで作成
-            int width, height;
-            glfwGetWindowSize(LAppDelegate::GetInstance()->GetWindow(), &width, &height);
+            int width = LAppWindowState::GetInstance()->GetWidth();
+            int height = LAppWindowState::GetInstance()->GetHeight();
             if (width != 0 && height != 0)
             {
                 // モデル描画キャンバス
@@ -354,30 +372,34 @@ float LAppView::GetSpriteAlpha(int assign) const
 void LAppView::ResizeSprite()
 {
     // 這裡才是改變屏幕大小的回調，搜索0.95可以發現
-    LAppTextureManager* textureManager = LAppDelegate::GetInstance()->GetTextureManager();
-    if (!textureManager)
+    if (!_uiAtlas)
     {
         return;
     }
+    const string resourcesPath = ResourcesPath;
 
     // 描画領域サイズ
-    int width, height;
-    glfwGetWindowSize(LAppDelegate::GetInstance()->GetWindow(), &width, &height);
+    int width = LAppWindowState::GetInstance()->GetWidth();
+    int height = LAppWindowState::GetInstance()->GetHeight();
 
     float x = 0.0f;
     float y = 0.0f;
     float fWidth = 0.0f;
     float fHeight = 0.0f;
 
+    if (_uiBatch)
+    {
+        _uiBatch->SetViewportSize(width, height);
+    }
+
     if (_back)
     {
-        GLuint id = _back->GetTextureId();
-        LAppTextureManager::TextureInfo* texInfo = textureManager->GetTextureInfoById(id);
-        if (texInfo)
+        const LAppSpriteAtlas::Region* region = _uiAtlas->GetRegion(resourcesPath + BackImageName);
+        if (region)
         {
             x = width * 0.5f;
             y = height * 0.5f;
-            fWidth = static_cast<float>(texInfo->width * 2);
+            fWidth = static_cast<float>(region->width * 2);
             fHeight = static_cast<float>(height) * 1.00f; //0.95f
             _back->ResetRect(x, y, fWidth, fHeight);
         }
@@ -385,28 +407,26 @@ void LAppView::ResizeSprite()
     /*
     if (_power)
     {
-        GLuint id = _power->GetTextureId();
-        LAppTextureManager::TextureInfo* texInfo = textureManager->GetTextureInfoById(id);
-        if (texInfo)
+        const LAppSpriteAtlas::Region* region = _uiAtlas->GetRegion(resourcesPath + PowerImageName);
+        if (region)
         {
-            x = static_cast<float>(width - texInfo->width * 0.5f);
-            y = static_cast<float>(texInfo->height * 0.5f);
-            fWidth = static_cast<float>(texInfo->width);
-            fHeight = static_cast<float>(texInfo->height);
+            x = static_cast<float>(width - region->width * 0.5f);
+            y = static_cast<float>(region->height * 0.5f);
+            fWidth = static_cast<float>(region->width);
+            fHeight = static_cast<float>(region->height);
             _power->ResetRect(x, y, fWidth, fHeight);
         }
     }
 
     if (_gear)
     {
-        GLuint id = _gear->GetTextureId();
-        LAppTextureManager::TextureInfo* texInfo = textureManager->GetTextureInfoById(id);
-        if (texInfo)
+        const LAppSpriteAtlas::Region* region = _uiAtlas->GetRegion(resourcesPath + GearImageName);
+        if (region)
         {
-            x = static_cast<float>(width - texInfo->width * 0.5f);
-            y = static_cast<float>(height - texInfo->height * 0.5f);
-            fWidth = static_cast<float>(texInfo->width);
-            fHeight = static_cast<float>(texInfo->height);
+            x = static_cast<float>(width - region->width * 0.5f);
+            y = static_cast<float>(height - region->height * 0.5f);
+            fWidth = static_cast<float>(region->width);
+            fHeight = static_cast<float>(region->height);
             _gear->ResetRect(x, y, fWidth, fHeight);
         }
     }
@@ -16,6 +16,8 @@
 
 class TouchManager;
 class LAppSprite;
+class LAppSpriteAtlas;
+class LAppSpriteBatch;
 class LAppModel;
 
 /**
@@ -28,7 +30,12 @@ class LAppModel;
 
 类中的成员函数包括初始化、绘制、处理触摸事件、坐标转换、在绘制模型之前和之后调用的函数、获取精灵的透明度、切换渲染目标以及设置非默认渲染目标的背景清除颜色等。
 
-类中的成员变量包括触摸管理器、设备到屏幕的矩阵、view矩阵、着色器ID、背景图片、齿轮图片、电源图片、根据模式绘制的纹理、渲染目标的选择以及渲染目标的清除颜色等。
+设备到屏幕的矩阵由LAppWindowState在窗口尺寸变化时计算。
+
+类中的成员变量包括触摸管理器、view矩阵、着色器ID、背景图片、齿轮图片、电源图片、根据模式绘制的纹理、渲染目标的选择以及渲染目标的清除颜色等。
+
+背景、齿轮、电源等UI图像打包在一张图集（LAppSpriteAtlas）中，各精灵引用图集的子矩形，
+由LAppSpriteBatch从常驻的VBO用一次绘制调用绘制整个UI层。
 */
 class LAppView
 {
@@ -157,9 +164,10 @@ public:
 
 private:
     TouchManager* _touchManager;                 ///< 触摸管理器
-    Csm::CubismMatrix44* _deviceToScreen;    ///< 设备到屏幕的矩阵
     Csm::CubismViewMatrix* _viewMatrix;      ///< viewMatrix
     GLuint _programId;                       ///< 着色器ID
+    LAppSpriteAtlas* _uiAtlas;               ///< UI图像的图集
+    LAppSpriteBatch* _uiBatch;               ///< UI精灵的批量绘制
     LAppSprite* _back;                       ///< 背景图片
    // LAppSprite* _gear;                       ///< 齿轮图片
    // LAppSprite* _power;                      ///< 电源图片
@@ -0,0 +1,186 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppVoiceCache.hpp"
+#include "LAppDefine.hpp"
+#include "LAppPal.hpp"
+
+using namespace Csm;
+using namespace LAppDefine;
+
+namespace
+{
+    LAppVoiceCache* s_instance = NULL;
+}
+
+LAppVoiceCache::Clip::Clip()
+    : numberOfChannels(0)
+    , bitsPerSample(0)
+    , samplingRate(0)
+    , samplesPerChannel(0)
+    , dataBytes(NULL)
+    , dataSize(0)
+    , bytesPerFrame(0)
+    , pcmData(NULL)
+{
+}
+
+LAppVoiceCache::Clip::~Clip()
+{
+    if (dataBytes != NULL)
+    {
+        CSM_FREE(dataBytes);
+    }
+
+    if (pcmData != NULL)
+    {
+        for (csmUint32 channelCount = 0; channelCount < numberOfChannels; channelCount++)
+        {
+            CSM_FREE(pcmData[channelCount]);
+        }
+        CSM_FREE(pcmData);
+    }
+}
+
+csmSizeInt LAppVoiceCache::Clip::GetBytes() const
+{
+    if (pcmData != NULL)
+    {
+        return static_cast<csmSizeInt>(sizeof(csmFloat32) * numberOfChannels * samplesPerChannel);
+    }
+    return dataSize;
+}
+
+LAppVoiceCache* LAppVoiceCache::GetInstance()
+{
+    if (s_instance == NULL)
+    {
+        s_instance = new LAppVoiceCache(VoiceCacheBudgetBytes);
+    }
+
+    return s_instance;
+}
+
+void LAppVoiceCache::ReleaseInstance()
+{
+    if (s_instance != NULL)
+    {
+        delete s_instance;
+    }
+
+    s_instance = NULL;
+}
+
+LAppVoiceCache::LAppVoiceCache(csmSizeInt budgetBytes)
+    : _budgetBytes(budgetBytes)
+    , _residentBytes(0)
+    , _hitCount(0)
+    , _missCount(0)
+    , _evictionCount(0)
+{
+}
+
+std::shared_ptr<const LAppVoiceCache::Clip> LAppVoiceCache::Find(const std::string& path)
+{
+    std::map<std::string, EntryList::iterator>::iterator it = _index.find(path);
+    if (it == _index.end())
+    {
+        _missCount++;
+        return std::shared_ptr<const Clip>();
+    }
+
+    // 移到开头（最近使用）
+    _entries.splice(_entries.begin(), _entries, it->second);
+    _hitCount++;
+
+    return it->second->clip;
+}
+
+void LAppVoiceCache::Add(const std::string& path, const std::shared_ptr<const Clip>& clip)
+{
+    Remove(path);
+
+    Entry entry;
+    entry.path = path;
+    entry.clip = clip;
+    entry.bytes = clip->GetBytes();
+    _entries.push_front(entry);
+    _index[entry.path] = _entries.begin();
+    _residentBytes += entry.bytes;
+
+    Evict(&_entries.front());
+}
+
+void LAppVoiceCache::Remove(const std::string& path)
+{
+    std::map<std::string, EntryList::iterator>::iterator it = _index.find(path);
+    if (it == _index.end())
+    {
+        return;
+    }
+
+    // 播放中的LAppWavFileHandler仍持有引用，最后一个引用释放时释放数据
+    _residentBytes -= it->second->bytes;
+    _entries.erase(it->second);
+    _index.erase(it);
+}
+
+void LAppVoiceCache::Clear()
+{
+    _entries.clear();
+    _index.clear();
+    _residentBytes = 0;
+}
+
+csmUint32 LAppVoiceCache::GetHitCount() const
+{
+    return _hitCount;
+}
+
+csmUint32 LAppVoiceCache::GetMissCount() const
+{
+    return _missCount;
+}
+
+csmUint32 LAppVoiceCache::GetEvictionCount() const
+{
+    return _evictionCount;
+}
+
+csmSizeInt LAppVoiceCache::GetResidentBytes() const
+{
+    return _residentBytes;
+}
+
+csmUint32 LAppVoiceCache::GetEntryCount() const
+{
+    return static_cast<csmUint32>(_entries.size());
+}
+
+void LAppVoiceCache::Evict(const Entry* keep)
+{
+    EntryList::iterator it = _entries.end();
+    while (_residentBytes > _budgetBytes && it != _entries.begin())
+    {
+        --it;
+        // 缓存之外仍有引用的条目正在播放
+        if (&*it == keep || it->clip.use_count() > 1)
+        {
+            continue;
+        }
+
+        if (DebugLogEnable)
+        {
+            LAppPal::PrintLog("[APP]evict voice: %s", it->path.c_str());
+        }
+
+        _residentBytes -= it->bytes;
+        _index.erase(it->path);
+        it = _entries.erase(it);
+        _evictionCount++;
+    }
+}
@@ -0,0 +1,173 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <CubismFramework.hpp>
+
+ /**
+ * @brief 语音缓存
+ *
+ * 按路径保存LAppWavFileHandler读取的wav，在字节预算内按LRU淘汰。
+ *
+ 这段代码定义了一个名为LAppVoiceCache的类（单例），使重复播放同一语音时不再读取文件、解析RIFF块和转换PCM。
+
+条目（Clip）通过shared_ptr共享，LAppWavFileHandler直接引用其中的数据，不进行复制。
+播放中的条目（缓存之外仍有引用）不会被淘汰；被Remove/Clear移除的条目在最后一个引用释放时释放。
+条目只持有堆上的数据：流式读取（WavStreamingEnable）时为data块的副本，否则为转换后的float数组。
+不持有文件的视图，缓存中的语音文件也可以被替换。只在主线程上调用。
+
+GetInstance/ReleaseInstance：获取/释放类的实例。
+Find：按路径查找条目。找到时计为命中并更新使用顺序，找不到时计为未命中。
+Add：添加新读取的条目，超出预算时从最久未使用的条目开始淘汰。
+Remove/Clear：移除指定的条目/所有条目（文件变更时调用）。
+GetHitCount/GetMissCount/GetEvictionCount：获取命中、未命中、淘汰的次数。
+GetResidentBytes/GetEntryCount：获取常驻的字节数和条目数。
+ */
+class LAppVoiceCache
+{
+public:
+    /**
+    * @brief 读取的wav数据
+    */
+    struct Clip
+    {
+        /**
+        * @brief 构造函数
+        */
+        Clip();
+
+        /**
+        * @brief 析构函数。释放data块的副本和PCM数据
+        */
+        ~Clip();
+
+        /**
+        * @brief 获取占用的字节数
+        */
+        Csm::csmSizeInt GetBytes() const;
+
+        Csm::csmUint32 numberOfChannels;    ///< 通道数
+        Csm::csmUint32 bitsPerSample;       ///< 每个样本的位数
+        Csm::csmUint32 samplingRate;        ///< 采样率
+        Csm::csmUint32 samplesPerChannel;   ///< 每个通道的总样本数
+        Csm::csmByte* dataBytes;            ///< 流式读取时data块的副本（否则为NULL）
+        Csm::csmSizeInt dataSize;           ///< data块副本的大小
+        Csm::csmUint32 bytesPerFrame;       ///< 每个样本帧（所有通道）的字节数
+        Csm::csmFloat32** pcmData;          ///< 转换后的PCM（流式读取时为NULL）
+
+    private:
+        Clip(const Clip&);
+        Clip& operator=(const Clip&);
+    };
+
+    /**
+    * @brief   返回类的实例（单例）。如果实例尚未创建，将在内部创建实例。
+    *
+    * @return  类的实例
+    */
+    static LAppVoiceCache* GetInstance();
+
+    /**
+    * @brief   释放类的实例（单例）。
+    *
+    */
+    static void ReleaseInstance();
+
+    /**
+    * @brief 按路径查找条目
+    *
+    * @param[in]   path    wav文件的路径
+    * @return              缓存中的条目。不存在时返回空
+    */
+    std::shared_ptr<const Clip> Find(const std::string& path);
+
+    /**
+    * @brief 添加条目，超出预算时淘汰最久未使用的条目
+    *         同一路径的条目已存在时替换。
+    *
+    * @param[in]   path    wav文件的路径
+    * @param[in]   clip    条目
+    */
+    void Add(const std::string& path, const std::shared_ptr<const Clip>& clip);
+
+    /**
+    * @brief 移除指定的条目
+    *
+    * @param[in]   path    wav文件的路径
+    */
+    void Remove(const std::string& path);
+
+    /**
+    * @brief 移除所有条目
+    */
+    void Clear();
+
+    /**
+    * @brief 获取命中次数
+    */
+    Csm::csmUint32 GetHitCount() const;
+
+    /**
+    * @brief 获取未命中次数
+    */
+    Csm::csmUint32 GetMissCount() const;
+
+    /**
+    * @brief 获取淘汰次数
+    */
+    Csm::csmUint32 GetEvictionCount() const;
+
+    /**
+    * @brief 获取常驻的字节数
+    */
+    Csm::csmSizeInt GetResidentBytes() const;
+
+    /**
+    * @brief 获取常驻的条目数
+    */
+    Csm::csmUint32 GetEntryCount() const;
+
+private:
+    /**
+    * @brief 构造函数
+    *
+    * @param[in]   budgetBytes     常驻条目的字节预算。为0时只保留正在播放的条目
+    */
+    LAppVoiceCache(Csm::csmSizeInt budgetBytes);
+
+    /**
+    * @brief 缓存条目
+    */
+    struct Entry
+    {
+        std::string path;                   ///< wav文件的路径
+        std::shared_ptr<const Clip> clip;   ///< 读取的wav数据
+        Csm::csmSizeInt bytes;              ///< 占用的字节数
+    };
+
+    /**
+    * @brief 从最久未使用的条目开始淘汰，直到常驻字节数在预算之内
+    *
+    * @param[in]   keep    不淘汰的条目（刚添加的条目）
+    */
+    void Evict(const Entry* keep);
+
+    typedef std::list<Entry> EntryList;
+
+    EntryList _entries;                                 ///< 条目（开头为最近使用）
+    std::map<std::string, EntryList::iterator> _index;  ///< 路径到条目的索引
+    Csm::csmSizeInt _budgetBytes;                       ///< 字节预算
+    Csm::csmSizeInt _residentBytes;                     ///< 常驻的字节数
+    Csm::csmUint32 _hitCount;                           ///< 命中次数
+    Csm::csmUint32 _missCount;                          ///< 未命中次数
+    Csm::csmUint32 _evictionCount;                      ///< 淘汰次数
+};
@@ -8,10 +8,14 @@
 #include "LAppWavFileHandler.hpp"
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include "LAppPal.hpp"
+#include "LAppDefine.hpp"
+#include "LAppAudioKernel.hpp"
 
 LAppWavFileHandler::LAppWavFileHandler()
     : _pcmData(NULL)
+    , _bytesPerFrame(0)
     , _userTimeSeconds(0.0f)
     , _lastRms(0.0f)
     , _sampleOffset(0)
@@ -20,7 +24,7 @@ LAppWavFileHandler::LAppWavFileHandler()
 
 LAppWavFileHandler::~LAppWavFileHandler()
 {
-    if (_pcmData != NULL)
+    if (IsLoaded())
     {
         ReleasePcmData();
     }
@@ -32,7 +36,7 @@ Csm::csmBool LAppWavFileHandler::Update(Csm::csmFloat32 deltaTimeSeconds)
     Csm::csmFloat32 rms;
 
     // データロード前/ファイル末尾に達した場合は更新しない
-    if ((_pcmData == NULL)
+    if (!IsLoaded()
         || (_sampleOffset >= _wavFileInfo._samplesPerChannel))
     {
         _lastRms = 0.0f;
@@ -48,28 +52,81 @@ Csm::csmBool LAppWavFileHandler::Update(Csm::csmFloat32 deltaTimeSeconds)
     }
 
     // RMS計測
-    rms = 0.0f;
-    for (Csm::csmUint32 channelCount = 0; channelCount < _wavFileInfo._numberOfChannels; channelCount++)
-    {
-        for (Csm::csmUint32 sampleCount = _sampleOffset; sampleCount < goalOffset; sampleCount++)
-        {
-            Csm::csmFloat32 pcm = _pcmData[channelCount][sampleCount];
-            rms += pcm * pcm;
-        }
-    }
+    rms = SumSquares(_sampleOffset, goalOffset);
     rms = sqrt(rms / (_wavFileInfo._numberOfChannels * (goalOffset - _sampleOffset)));
 
     _lastRms = rms;
     _sampleOffset = goalOffset;
+
+    // ストリーミング時は末尾まで再生したらdataチャンクのコピーへの参照を手放す
+    if (_pcmData == NULL && _sampleOffset >= _wavFileInfo._samplesPerChannel)
+    {
+        ReleasePcmData();
+    }
     return true;
 }
 
-void LAppWavFileHandler::Start(const Csm::csmString& filePath)
+Csm::csmFloat32 LAppWavFileHandler::SumSquares(Csm::csmUint32 beginSample, Csm::csmUint32 endSample)
 {
-    // WAVファイルのロード
-    if (!LoadWavFile(filePath))
+    Csm::csmFloat32 sum = 0.0f;
+
+    // チャンネルごとに連続した配列なので、チャンネル単位でSIMDカーネルに渡す
+    if (_pcmData != NULL)
     {
-        return;
+        for (Csm::csmUint32 channelCount = 0; channelCount < _wavFileInfo._numberOfChannels; channelCount++)
+        {
+            sum += static_cast<Csm::csmFloat32>(LAppAudioKernel::SumSquaresFloat(_pcmData[channelCount] + beginSample, endSample - beginSample));
+        }
+        return sum;
+    }
+
+    // ストリーミング時の16bitはインターリーブのまま全チャンネルをまとめて整数で累積する
+    if (_wavFileInfo._bitsPerSample == 16)
+    {
+        const Csm::csmUint64 squares = LAppAudioKernel::SumSquaresPcm16(_byteReader._fileByte + beginSample * _bytesPerFrame,
+            (endSample - beginSample) * _wavFileInfo._numberOfChannels);
+        return static_cast<Csm::csmFloat32>(squares * LAppAudioKernel::Pcm16SquareScale());
+    }
+
+    // ストリーミング時は必要な範囲だけをインターリーブのまま読み取る
+    _byteReader._readOffset = beginSample * _bytesPerFrame;
+    for (Csm::csmUint32 sampleCount = beginSample; sampleCount < endSample; sampleCount++)
+    {
+        for (Csm::csmUint32 channelCount = 0; channelCount < _wavFileInfo._numberOfChannels; channelCount++)
+        {
+            Csm::csmFloat32 pcm = GetPcmSample();
+            sum += pcm * pcm;
+        }
+    }
+    return sum;
+}
+
+Csm::csmBool LAppWavFileHandler::Start(const Csm::csmString& filePath, Csm::csmBool useCache)
+{
+    // 一度読み込んだWAVはキャッシュから参照し、ファイル読み込みとPCM変換を省略する
+    std::shared_ptr<const LAppVoiceCache::Clip> clip;
+    if (useCache)
+    {
+        clip = LAppVoiceCache::GetInstance()->Find(filePath.GetRawString());
+    }
+
+    if (clip)
+    {
+        SetClip(clip);
+        _wavFileInfo._fileName = filePath;
+    }
+    else
+    {
+        // WAVファイルのロード
+        if (!LoadWavFile(filePath))
+        {
+            return false;
+        }
+
+        if (useCache)
+        {
+            LAppVoiceCache::GetInstance()->Add(filePath.GetRawString(), _clip);
+        }
     }
 
     // サンプル参照位置を初期化
@@ -78,6 +135,7 @@ void LAppWavFileHandler::Start(const Csm::csmString& filePath)
 
     // RMS値をリセット
     _lastRms = 0.0f;
+    return true;
 }
 
 Csm::csmFloat32 LAppWavFileHandler::GetRms() const
@@ -85,12 +143,22 @@ Csm::csmFloat32 LAppWavFileHandler::GetRms() const
     return _lastRms;
 }
 
+Csm::csmFloat32 LAppWavFileHandler::GetRms(Csm::csmUint32 beginSample, Csm::csmUint32 endSample)
+{
+    if (!IsLoaded() || beginSample >= endSample || endSample > _wavFileInfo._samplesPerChannel)
+    {
+        return 0.0f;
+    }
+
+    return sqrt(SumSquares(beginSample, endSample) / (_wavFileInfo._numberOfChannels * (endSample - beginSample)));
+}
+
 Csm::csmBool LAppWavFileHandler::LoadWavFile(const Csm::csmString& filePath)
 {
     Csm::csmBool ret;
 
     // 既にwavファイルロード済みならば領域開放
-    if (_pcmData != NULL)
+    if (IsLoaded())
     {
         ReleasePcmData();
     }
@@ -102,6 +170,12 @@ Csm::csmBool LAppWavFileHandler::LoadWavFile(const Csm::csmString& filePath)
     // ファイルロードに失敗しているか、先頭のシグネチャ"RIFF"を入れるサイズもない場合は失敗
     if ((_byteReader._fileByte == NULL) || (_byteReader._fileSize < 4))
     {
+        if (_byteReader._fileByte != NULL)
+        {
+            LAppPal::ReleaseBytes(_byteReader._fileByte);
+            _byteReader._fileByte = NULL;
+            _byteReader._fileSize = 0;
+        }
         return false;
     }
 
@@ -169,6 +243,42 @@ Csm::csmBool LAppWavFileHandler::LoadWavFile(const Csm::csmString& filePath)
             const Csm::csmUint32 dataChunkSize = _byteReader.Get32LittleEndian();
             _wavFileInfo._samplesPerChannel = (dataChunkSize * 8) / (_wavFileInfo._bitsPerSample * _wavFileInfo._numberOfChannels);
         }
+        // ストリーミング時はdataチャンクだけをコピーし、Updateで必要な範囲だけデコードする
+        if (LAppDefine::WavStreamingEnable)
+        {
+            const Csm::csmUint32 dataOffset = _byteReader._readOffset;
+            _bytesPerFrame = (_wavFileInfo._bitsPerSample / 8) * _wavFileInfo._numberOfChannels;
+
+            // 後から読み取るため、ファイル末尾を越えるサンプル数は切り詰める
+            const Csm::csmUint32 availableFrames = _bytesPerFrame > 0
+                ? static_cast<Csm::csmUint32>((_byteReader._fileSize - dataOffset) / _bytesPerFrame) : 0;
+            if (_wavFileInfo._samplesPerChannel > availableFrames)
+            {
+                _wavFileInfo._samplesPerChannel = availableFrames;
+            }
+
+            // ファイルのビュー（Windowsではメモリマップ）を保持するとファイルを置き換えられないため、
+            // Clipはヒープ上のコピーだけを保持し、ビューはここで手放す
+            LAppVoiceCache::Clip* clip = new LAppVoiceCache::Clip();
+            clip->numberOfChannels = _wavFileInfo._numberOfChannels;
+            clip->bitsPerSample = _wavFileInfo._bitsPerSample;
+            clip->samplingRate = _wavFileInfo._samplingRate;
+            clip->samplesPerChannel = _wavFileInfo._samplesPerChannel;
+            clip->dataSize = static_cast<Csm::csmSizeInt>(_wavFileInfo._samplesPerChannel) * _bytesPerFrame;
+            if (clip->dataSize > 0)
+            {
+                clip->dataBytes = static_cast<Csm::csmByte*>(CSM_MALLOC(clip->dataSize));
+                memcpy(clip->dataBytes, _byteReader._fileByte + dataOffset, clip->dataSize);
+            }
+            clip->bytesPerFrame = _bytesPerFrame;
+
+            LAppPal::ReleaseBytes(_byteReader._fileByte);
+            _byteReader._fileByte = NULL;
+            _byteReader._fileSize = 0;
+
+            SetClip(std::shared_ptr<const LAppVoiceCache::Clip>(clip));
+            return true;
+        }
         // 領域確保
         _pcmData = static_cast<Csm::csmFloat32**>(CSM_MALLOC(sizeof(Csm::csmFloat32*) * _wavFileInfo._numberOfChannels));
         for (Csm::csmUint32 channelCount = 0; channelCount < _wavFileInfo._numberOfChannels; channelCount++)
@@ -193,6 +303,18 @@ Csm::csmBool LAppWavFileHandler::LoadWavFile(const Csm::csmString& filePath)
     _byteReader._fileByte = NULL;
     _byteReader._fileSize = 0;
 
+    // 変換したPCMはClipが保持する
+    if (ret)
+    {
+        LAppVoiceCache::Clip* clip = new LAppVoiceCache::Clip();
+        clip->numberOfChannels = _wavFileInfo._numberOfChannels;
+        clip->bitsPerSample = _wavFileInfo._bitsPerSample;
+        clip->samplingRate = _wavFileInfo._samplingRate;
+        clip->samplesPerChannel = _wavFileInfo._samplesPerChannel;
+        clip->pcmData = _pcmData;
+        SetClip(std::shared_ptr<const LAppVoiceCache::Clip>(clip));
+    }
+
     return ret;
 }
 
@@ -224,10 +346,22 @@ Csm::csmFloat32 LAppWavFileHandler::GetPcmSample()
 
 void LAppWavFileHandler::ReleasePcmData()
 {
-    for (Csm::csmUint32 channelCount = 0; channelCount < _wavFileInfo._numberOfChannels; channelCount++)
-    {
-        CSM_FREE(_pcmData[channelCount]);
-    }
-    CSM_FREE(_pcmData);
+    _clip.reset();
     _pcmData = NULL;
+    _byteReader._fileByte = NULL;
+    _byteReader._fileSize = 0;
+}
+
+void LAppWavFileHandler::SetClip(const std::shared_ptr<const LAppVoiceCache::Clip>& clip)
+{
+    _clip = clip;
+    _wavFileInfo._numberOfChannels = clip->numberOfChannels;
+    _wavFileInfo._bitsPerSample = clip->bitsPerSample;
+    _wavFileInfo._samplingRate = clip->samplingRate;
+    _wavFileInfo._samplesPerChannel = clip->samplesPerChannel;
+    _pcmData = clip->pcmData;
+    _byteReader._fileByte = clip->dataBytes;
+    _byteReader._fileSize = clip->dataSize;
+    _byteReader._readOffset = 0;
+    _bytesPerFrame = clip->bytesPerFrame;
 }
@@ -7,14 +7,19 @@
 
 #pragma once
 
+#include <memory>
 #include <CubismFramework.hpp>
 #include <Utils/CubismString.hpp>
+#include "LAppVoiceCache.hpp"
 
  /**
   * @brief wav文件处理器
   * @attention 目前只实现了16位wav文件的读取
   * 
   这段代码定义了一个名为LAppWavFileHandler的类，用于处理wav文件。这个类包含了一些用于加载、读取和操作wav文件的方法，以及一些内部结构体用于存储文件信息和字节读取器。这个类主要用于读取16位wav文件，并可以获取当前的RMS值。
+  WavStreamingEnable为true时，加载时只复制data块并立即释放文件的视图（以便替换wav文件），Update只解码上次位置到当前时间之间的样本；
+  为false时，与以前一样在加载时把所有样本展开到_pcmData。
+  读取的数据由LAppVoiceCache::Clip持有，Start时先按路径查找LAppVoiceCache，命中时直接引用，不读取文件。
   */
 class LAppWavFileHandler
 {
@@ -42,8 +47,11 @@ public:
      * @brief 开始读取指定的wav文件
      *
      * @param[in] filePath wav文件的路径
+     * @param[in] useCache 为true时通过LAppVoiceCache读取（只在主线程上指定）
+     * @retval  true    读取成功
+     * @retval  false   读取失败
      */
-    void Start(const Csm::csmString& filePath);
+    Csm::csmBool Start(const Csm::csmString& filePath, Csm::csmBool useCache = true);
 
     /**
      * @brief 获取当前的RMS值
@@ -52,6 +60,32 @@ public:
      */
     Csm::csmFloat32 GetRms() const;
 
+    /**
+     * @brief 计算指定范围内所有通道的RMS值（不改变播放位置）
+     *         LAppLipSyncEnvelope烘焙时使用。
+     *
+     * @param[in]   beginSample 开始样本位置
+     * @param[in]   endSample   结束样本位置（不包含，不超过GetSamplesPerChannel()）
+     * @retval  csmFloat32 RMS值。范围为空时返回0
+     */
+    Csm::csmFloat32 GetRms(Csm::csmUint32 beginSample, Csm::csmUint32 endSample);
+
+    /**
+     * @brief 获取采样率
+     */
+    Csm::csmUint32 GetSamplingRate() const
+    {
+        return _wavFileInfo._samplingRate;
+    }
+
+    /**
+     * @brief 获取每个通道的总样本数
+     */
+    Csm::csmUint32 GetSamplesPerChannel() const
+    {
+        return _wavFileInfo._samplesPerChannel;
+    }
+
 private:
     /**
      * @brief 加载wav文件
@@ -64,9 +98,34 @@ private:
 
     /**
      * @brief 释放PCM数据
+     *         只解除对Clip的引用，数据在缓存和其他处理器都不再引用时释放。
      */
     void ReleasePcmData();
 
+    /**
+     * @brief 引用读取的wav数据
+     *
+     * @param[in]   clip    读取的wav数据
+     */
+    void SetClip(const std::shared_ptr<const LAppVoiceCache::Clip>& clip);
+
+    /**
+     * @brief 是否有可供Update读取的数据
+     */
+    Csm::csmBool IsLoaded() const
+    {
+        return _pcmData != NULL || _byteReader._fileByte != NULL;
+    }
+
+    /**
+     * @brief 计算指定范围内所有通道的样本平方和
+     *
+     * @param[in]   beginSample 开始样本位置
+     * @param[in]   endSample   结束样本位置（不包含）
+     * @return                  样本的平方和
+     */
+    Csm::csmFloat32 SumSquares(Csm::csmUint32 beginSample, Csm::csmUint32 endSample);
+
     /**
      * @brief 获取-1～1范围的一个样本
      * @retval    csmFloat32    标准化的样本
@@ -180,7 +239,9 @@ private:
         Csm::csmUint32 _readOffset; ///< 文件读取位置
     } _byteReader;
 
-    Csm::csmFloat32** _pcmData; ///< 表示音频数据数组的范围为-1到1
+    std::shared_ptr<const LAppVoiceCache::Clip> _clip; ///< 引用中的wav数据
+    Csm::csmFloat32** _pcmData; ///< 表示音频数据数组的范围为-1到1（流式读取时为NULL，由_clip持有）
+    Csm::csmUint32 _bytesPerFrame; ///< 流式读取时每个样本帧（所有通道）的字节数
     Csm::csmUint32 _sampleOffset; ///< 样本读取位置
     Csm::csmFloat32 _lastRms; ///< 最后测量的RMS值
     Csm::csmFloat32 _userTimeSeconds; ///< 增量时间累积值[秒]
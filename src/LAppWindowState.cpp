@@ -0,0 +1,108 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppWindowState.hpp"
+#include <math.h>
+#include "LAppDefine.hpp"
+
+using namespace Csm;
+using namespace LAppDefine;
+
+namespace
+{
+    LAppWindowState* s_instance = NULL;
+}
+
+LAppWindowState* LAppWindowState::GetInstance()
+{
+    if (s_instance == NULL)
+    {
+        s_instance = new LAppWindowState();
+    }
+
+    return s_instance;
+}
+
+void LAppWindowState::ReleaseInstance()
+{
+    if (s_instance != NULL)
+    {
+        delete s_instance;
+    }
+
+    s_instance = NULL;
+}
+
+LAppWindowState::LAppWindowState()
+    : _width(0)
+    , _height(0)
+    , _revision(0)
+{
+}
+
+void LAppWindowState::Attach(GLFWwindow* window)
+{
+    int width, height;
+    glfwGetWindowSize(window, &width, &height);
+    SetSize(width, height);
+
+    glfwSetWindowSizeCallback(window, OnWindowSize);
+}
+
+void LAppWindowState::OnWindowSize(GLFWwindow* window, int width, int height)
+{
+    GetInstance()->SetSize(width, height);
+}
+
+void LAppWindowState::SetSize(int width, int height)
+{
+    if (width == _width && height == _height)
+    {
+        return;
+    }
+
+    _width = width;
+    _height = height;
+    _revision++;
+
+    if (!IsEmpty())
+    {
+        UpdateMatrices();
+    }
+}
+
+void LAppWindowState::UpdateMatrices()
+{
+    const float width = static_cast<float>(_width);
+    const float height = static_cast<float>(_height);
+
+    // 横に長いモデルを縦長ウィンドウに表示する際はモデルの横サイズ、それ以外は縦サイズを基準とする
+    _fitWidthProjection.LoadIdentity();
+    _fitWidthProjection.Scale(1.0f, width / height);
+    _fitHeightProjection.LoadIdentity();
+    _fitHeightProjection.Scale(height / width, 1.0f);
+
+    // 縦サイズを基準とする
+    const float ratio = width / height;
+    const float left = -ratio;
+    const float right = ratio;
+    const float bottom = ViewLogicalLeft;
+    const float top = ViewLogicalRight;
+
+    _deviceToScreen.LoadIdentity(); // サイズが変わった際などリセット必須
+    if (_width > _height)
+    {
+        const float screenW = fabsf(right - left);
+        _deviceToScreen.ScaleRelative(screenW / width, -screenW / width);
+    }
+    else
+    {
+        const float screenH = fabsf(top - bottom);
+        _deviceToScreen.ScaleRelative(screenH / height, -screenH / height);
+    }
+    _deviceToScreen.TranslateRelative(-width * 0.5f, -height * 0.5f);
+}
@@ -0,0 +1,154 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <CubismFramework.hpp>
+#include <Math/CubismMatrix44.hpp>
+
+ /**
+ * @brief 窗口状态
+ *
+ * 缓存窗口尺寸和由尺寸决定的矩阵。
+ *
+ 这段代码定义了一个名为LAppWindowState的类（单例），代替各处每帧调用glfwGetWindowSize。
+
+Attach时读取一次窗口尺寸并注册glfwSetWindowSizeCallback，之后只在回调中更新（glfwPollEvents期间在主线程上调用）。
+尺寸变化时重新计算模型的投影矩阵和设备到屏幕的矩阵，并将修订号加1，使用方比较修订号即可判断是否需要重新布局。
+窗口最小化（尺寸为0）时只更新尺寸，矩阵保持上一次的值。
+
+GetInstance()/ReleaseInstance()：获取/释放实例。
+Attach()：绑定窗口并注册尺寸变化的回调。
+SetSize()：更新尺寸（回调从此处进入）。
+GetWidth()/GetHeight()/IsEmpty()/IsPortrait()：获取窗口尺寸、是否为0、是否为纵向。
+GetRevision()：获取尺寸变化的修订号。
+GetFitHeightProjection()：以窗口高度为基准的模型投影矩阵。
+GetFitWidthProjection()：以窗口宽度为基准的模型投影矩阵（横长的模型显示在纵向窗口时使用）。
+GetDeviceToScreen()：设备坐标到逻辑屏幕坐标的矩阵。
+ */
+class LAppWindowState
+{
+public:
+    /**
+    * @brief   返回类的实例（单例）。如果实例尚未创建，将在内部创建实例。
+    *
+    * @return  类的实例
+    */
+    static LAppWindowState* GetInstance();
+
+    /**
+    * @brief   释放类的实例（单例）。
+    *
+    */
+    static void ReleaseInstance();
+
+    /**
+    * @brief   绑定窗口
+    *           读取当前的窗口尺寸，并注册glfwSetWindowSizeCallback。
+    *
+    * @param[in]   window  窗口
+    */
+    void Attach(GLFWwindow* window);
+
+    /**
+    * @brief   更新窗口尺寸
+    *           与当前尺寸不同时重新计算矩阵并将修订号加1。
+    *
+    * @param[in]   width   宽度
+    * @param[in]   height  高度
+    */
+    void SetSize(int width, int height);
+
+    /**
+    * @brief   获取窗口宽度
+    */
+    int GetWidth() const
+    {
+        return _width;
+    }
+
+    /**
+    * @brief   获取窗口高度
+    */
+    int GetHeight() const
+    {
+        return _height;
+    }
+
+    /**
+    * @brief   窗口尺寸为0（最小化等）时返回true
+    */
+    bool IsEmpty() const
+    {
+        return _width == 0 || _height == 0;
+    }
+
+    /**
+    * @brief   窗口高度大于宽度时返回true
+    */
+    bool IsPortrait() const
+    {
+        return _width < _height;
+    }
+
+    /**
+    * @brief   获取尺寸变化的修订号
+    */
+    Csm::csmUint32 GetRevision() const
+    {
+        return _revision;
+    }
+
+    /**
+    * @brief   获取以窗口高度为基准的模型投影矩阵
+    */
+    const Csm::CubismMatrix44& GetFitHeightProjection() const
+    {
+        return _fitHeightProjection;
+    }
+
+    /**
+    * @brief   获取以窗口宽度为基准的模型投影矩阵
+    */
+    const Csm::CubismMatrix44& GetFitWidthProjection() const
+    {
+        return _fitWidthProjection;
+    }
+
+    /**
+    * @brief   获取设备坐标到逻辑屏幕坐标的矩阵
+    */
+    Csm::CubismMatrix44* GetDeviceToScreen()
+    {
+        return &_deviceToScreen;
+    }
+
+private:
+    /**
+    * @brief   构造函数
+    */
+    LAppWindowState();
+
+    /**
+    * @brief   glfwSetWindowSizeCallback用的回调函数
+    */
+    static void OnWindowSize(GLFWwindow* window, int width, int height);
+
+    /**
+    * @brief   根据当前尺寸重新计算矩阵
+    */
+    void UpdateMatrices();
+
+    int _width;                                 ///< 窗口宽度
+    int _height;                                ///< 窗口高度
+    Csm::csmUint32 _revision;                   ///< 尺寸变化的修订号
+    Csm::CubismMatrix44 _fitHeightProjection;   ///< 以高度为基准的投影矩阵
+    Csm::CubismMatrix44 _fitWidthProjection;    ///< 以宽度为基准的投影矩阵
+    Csm::CubismMatrix44 _deviceToScreen;        ///< 设备到屏幕的矩阵
+};
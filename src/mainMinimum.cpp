@@ -15,6 +15,8 @@
 #include "LAppAllocator.hpp"
 #include "LAppTextureManager.hpp"
 #include "LAppPal.hpp"
+#include "LAppTaskPool.hpp"
+#include "LAppWindowState.hpp"
 #include "TouchManager.hpp"
 #include "CubismUserModelExtend.hpp"
 #include "CubismSampleViewMatrix.hpp"
@@ -139,8 +141,10 @@ static bool InitializeSystem()
     glfwSetMouseButtonCallback(_window, EventHandler::OnMouseCallBack);
     glfwSetCursorPosCallback(_window, EventHandler::OnMouseCallBack);
 
-    // ウィンドウサイズ記憶
-    glfwGetWindowSize(_window, &windowWidth, &windowHeight);
+    // ウィンドウサイズ記憶（以降はサイズ変更のコールバックでのみ更新される）
+    LAppWindowState::GetInstance()->Attach(_window);
+    windowWidth = LAppWindowState::GetInstance()->GetWidth();
+    windowHeight = LAppWindowState::GetInstance()->GetHeight();
     glViewport(0, 0, windowWidth, windowHeight);
 
     // Cubism SDK の初期化
@@ -165,11 +169,18 @@ void Release()
     // モデルデータの解放
     delete _userModel;
 
+    // 素材包のアンマウント
+    LAppPal::UnmountBundle(_currentModelDirectory);
+
     // テクスチャマネージャーの解放
     delete _textureManager;
 
+    // ワーカースレッドの終了
+    LAppTaskPool::ReleaseInstance();
+
     // Windowの削除
     glfwDestroyWindow(_window);
+    LAppWindowState::ReleaseInstance();
 
     // OpenGLの処理を終了
     glfwTerminate();
@@ -203,6 +214,9 @@ void LoadModel(const std::string modelDirectoryName)
     // モデルのディレクトリを指定
     SetAssetDirectory(LAppDefine::ResourcesPath + modelDirectoryName + "/");
 
+    // 素材包が存在すればマウントし、モデルの全ファイルをそこから読み込む
+    LAppPal::MountBundle(_currentModelDirectory, LAppDefine::ResourcesPath + modelDirectoryName + LAppDefine::BundleExtension);
+
     // モデルデータの新規生成
     _userModel = new CubismUserModelExtend(modelDirectoryName, _currentModelDirectory);
 
@@ -218,13 +232,12 @@ void Run()
     //メインループ
     while (glfwWindowShouldClose(_window) == GL_FALSE)
     {
-        int width, height;
-
         // ビューポートを現在のウィンドウサイズに設定
         glViewport(0, 0, windowWidth, windowHeight);
 
         // ウィンドウサイズ記憶
-        glfwGetWindowSize(_window, &width, &height);
+        const int width = LAppWindowState::GetInstance()->GetWidth();
+        const int height = LAppWindowState::GetInstance()->GetHeight();
         if ((windowWidth != width || windowHeight != height) && width > 0 && height > 0)
         {
             //AppViewの初期化
@@ -0,0 +1,42 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include <cstdio>
+#include <string>
+#include "LAppBundle.hpp"
+
+/**
+* @brief 将模型目录打包为素材包
+*
+* 用法：BundlePacker <模型目录> [输出文件]
+* 省略输出文件时，在模型目录旁生成"<模型目录>.l2db"（与LAppDefine::BundleExtension一致）。
+*/
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::printf("usage: %s <model directory> [output bundle]\n", argv[0]);
+        return 1;
+    }
+
+    std::string directory = LAppBundle::NormalizePath(argv[1]);
+    while (!directory.empty() && directory[directory.size() - 1] == '/')
+    {
+        directory.erase(directory.size() - 1);
+    }
+    const std::string bundlePath = (argc >= 3) ? std::string(argv[2]) : directory + ".l2db";
+
+    Csm::csmUint32 entryCount = 0;
+    if (!LAppBundle::Pack(directory, bundlePath, &entryCount))
+    {
+        std::printf("failed to pack %s\n", directory.c_str());
+        return 1;
+    }
+
+    std::printf("packed %u files: %s => %s\n", entryCount, directory.c_str(), bundlePath.c_str());
+    return 0;
+}
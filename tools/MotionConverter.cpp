@@ -0,0 +1,94 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <CubismFramework.hpp>
+#include "LAppAllocator.hpp"
+#include "LAppBinaryMotion.hpp"
+
+namespace
+{
+    void PrintFrameworkLog(const Csm::csmChar* message)
+    {
+        std::printf("%s\n", message);
+    }
+
+    /**
+    * @brief 转换一个motion3.json，在旁边写出.motion3.bin
+    */
+    bool Convert(const std::string& jsonPath)
+    {
+        std::ifstream input(jsonPath.c_str(), std::ios::in | std::ios::binary);
+        if (!input.is_open())
+        {
+            std::printf("failed to open %s\n", jsonPath.c_str());
+            return false;
+        }
+        const std::vector<Csm::csmByte> json((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+        std::vector<Csm::csmByte> binary;
+        if (json.empty() || !LAppBinaryMotion::Compile(&json[0], static_cast<Csm::csmSizeInt>(json.size()), binary))
+        {
+            std::printf("failed to convert %s\n", jsonPath.c_str());
+            return false;
+        }
+
+        const std::string binaryPath = LAppBinaryMotion::GetBinaryPath(jsonPath);
+        std::ofstream output(binaryPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        output.write(reinterpret_cast<const char*>(&binary[0]), static_cast<std::streamsize>(binary.size()));
+        if (!output.good())
+        {
+            std::printf("failed to write %s\n", binaryPath.c_str());
+            return false;
+        }
+
+        std::printf("%s => %s (%u => %u bytes)\n", jsonPath.c_str(), binaryPath.c_str(),
+            static_cast<unsigned>(json.size()), static_cast<unsigned>(binary.size()));
+        return true;
+    }
+}
+
+/**
+* @brief 将motion3.json转换为预编译的二进制动作
+*
+* 用法：MotionConverter <motion3.json>...
+* 在各motion3.json旁边生成".motion3.bin"，LAppModel读取动作时优先使用（LAppDefine::BinaryMotionEnable）。
+* 二进制动作中记录了motion3.json的大小和内容哈希，motion3.json被修改后LAppModel改为读取JSON，直到重新转换（复制和检出不影响）。
+*/
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::printf("usage: %s <motion3.json>...\n", argv[0]);
+        return 1;
+    }
+
+    // CubismJson使用框架的内存分配器
+    LAppAllocator allocator;
+    Csm::CubismFramework::Option option;
+    option.LogFunction = PrintFrameworkLog;
+    option.LoggingLevel = Csm::CubismFramework::Option::LogLevel_Warning;
+    Csm::CubismFramework::StartUp(&allocator, &option);
+    Csm::CubismFramework::Initialize();
+
+    int failed = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!Convert(argv[i]))
+        {
+            failed++;
+        }
+    }
+
+    Csm::CubismFramework::Dispose();
+
+    return failed == 0 ? 0 : 1;
+}